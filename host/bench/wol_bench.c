@@ -0,0 +1,1295 @@
+// Benchmark de host: latência de dispatch por ação do protocolo e FPS de
+// renderização por efeito. Uso: wol_bench [escala] [arquivo]
+// (escala multiplica o número de iterações; padrão 1. Com arquivo, os frames
+// do backend de gravação vão para ele; ver host/record/led_backend_record.h).
+
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "esp_log.h"
+#include "esp_websocket_client.h"
+#include "led_backend.h"
+#include "led_backend_record.h"
+#include "led_controller.h"
+#include "led_controller_internal.h"
+#include "led_effects.h"
+#include "net_hmac.h"
+#include "net_utils.h"
+#include "esp_timer.h"
+#include "wol_packet.h"
+#include "wol_probe.h"
+#include "wol_verify.h"
+#include "ws_command_auth.h"
+#include "ws_protocol.h"
+#include "ws_tx_queue.h"
+#include "host_stubs.h"
+
+typedef struct
+{
+    const char *name;
+    const char *payload;
+    int iterations;
+    int binary_len; // > 0: frame binário (opcode 0x02) com esse tamanho
+} bench_message_t;
+
+static const bench_message_t bench_messages[] = {
+    {"wol", "{\"action\":\"wol\",\"mac\":\"A8:A1:59:98:61:0E\"}", 20000},
+    {"wol_burst", "{\"action\":\"wol\",\"mac\":\"A8:A1:59:98:61:0E\",\"burst\":5,\"spacingMs\":10,"
+                  "\"port\":\"both\",\"directed\":true,\"password\":\"01:02:03:04:05:06\"}", 20000},
+    {"led", "{\"action\":\"led\",\"r\":0,\"g\":255,\"b\":128}", 20000},
+    {"led_rgbw", "{\"action\":\"led\",\"r\":0,\"g\":255,\"b\":128,\"w\":64}", 20000},
+    {"effect", "{\"action\":\"effect\",\"effect\":\"breathing\",\"r\":255,\"g\":100,\"b\":50}", 20000},
+    {"effect_params", "{\"action\":\"effect\",\"effect\":\"chase\",\"speed\":200,\"density\":32,"
+                      "\"colors\":[{\"r\":255,\"g\":0,\"b\":0},{\"r\":0,\"g\":0,\"b\":255}]}", 20000},
+    {"ping", "{\"action\":\"ping\"}", 20000},
+    {"stats", "{\"action\":\"stats\"}", 20000},
+    {"config", "{\"action\":\"config\",\"status\":\"ok\",\"ledCount\":300,\"ledPin\":2,\"ledType\":\"ws2812b\","
+               "\"lastLedColor\":{\"r\":10,\"g\":20,\"b\":30,\"w\":0}}", 2000},
+    {"unsupported", "{\"action\":\"reboot\"}", 20000},
+    {"invalid_json", "{\"action\":\"led\",\"r\":", 20000},
+    {"batch_scene", "{\"action\":\"batch\",\"commands\":[{\"action\":\"led\",\"r\":255,\"g\":0,\"b\":0},"
+                    "{\"action\":\"led\",\"r\":0,\"g\":255,\"b\":0},{\"action\":\"led\",\"r\":0,\"g\":0,\"b\":255},"
+                    "{\"action\":\"effect\",\"effect\":\"breathing\",\"r\":255,\"g\":100,\"b\":50}]}", 20000},
+    {"batch_wol_x4", "{\"action\":\"batch\",\"commands\":[{\"action\":\"wol\",\"mac\":\"A8:A1:59:98:61:0E\"},"
+                     "{\"action\":\"wol\",\"mac\":\"A8:A1:59:98:61:0F\"},{\"action\":\"wol\",\"mac\":\"A8:A1:59:98:61:10\"},"
+                     "{\"action\":\"wol\",\"mac\":\"A8:A1:59:98:61:11\"}]}", 20000},
+    {"wol_macs_x4", "{\"action\":\"wol\",\"macs\":[\"A8:A1:59:98:61:0E\",\"A8:A1:59:98:61:0F\","
+                    "\"A8:A1:59:98:61:10\",\"A8:A1:59:98:61:11\"],\"rate\":500}", 20000},
+    {"wol_group_set", "{\"action\":\"wol_group\",\"name\":\"lab\",\"macs\":[\"A8:A1:59:98:61:0E\","
+                      "\"A8:A1:59:98:61:0F\",\"A8:A1:59:98:61:10\",\"A8:A1:59:98:61:11\"]}", 2000},
+    {"wol_group", "{\"action\":\"wol\",\"group\":\"lab\"}", 20000},
+    {"timeline", "{\"action\":\"timeline\",\"loop\":true,\"keyframes\":[{\"atMs\":0,\"r\":255,\"g\":0,\"b\":0},"
+                 "{\"atMs\":500,\"effect\":\"comet\",\"segment\":0,\"transitionMs\":200},"
+                 "{\"atMs\":1000,\"r\":0,\"g\":0,\"b\":255,\"transitionMs\":500}]}", 20000},
+    {"timeline_ctl", "{\"action\":\"timeline\",\"control\":\"seek\",\"positionMs\":750}", 20000},
+    {"bin_wol", "\x01\x01" "\xA8\xA1\x59\x98\x61\x0E", 20000, 8},
+    {"bin_led", "\x01\x02" "\x00\xFF\x80\x00", 20000, 6},
+    {"bin_effect", "\x01\x03" "\x01\xFF\x64\x32", 20000, 6},
+    {"bin_ping", "\x01\x04", 20000, 2},
+};
+
+// Além de todos os efeitos do registro (com os parâmetros padrão e a cor
+// base abaixo), variações que exercitam outros caminhos dos kernels.
+typedef struct
+{
+    const char *name;
+    const char *effect;
+    led_color_t base;
+    uint8_t density;
+    const char *palette; // NULL = padrão do efeito
+} bench_effect_t;
+
+static const led_color_t bench_base = {255, 100, 50, 0};
+
+static const bench_effect_t bench_effect_variants[] = {
+    // base escura: o nível quantizado repete por vários passos
+    {"breath_dim", "breathing", {12, 6, 3, 0}, 0, NULL},
+    {"comet_long", "comet", {255, 100, 50, 0}, 255, NULL},
+    {"twinkle_max", "twinkle", {255, 100, 50, 0}, 255, "custom"},
+    {"palette_x4", "palette", {255, 100, 50, 0}, 255, "lava"},
+};
+
+static const int bench_led_counts[] = {30, 300, 3000};
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int compare_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int64_t percentile(const int64_t *sorted, int count, int pct)
+{
+    int index = (count * pct) / 100;
+    if (index >= count)
+    {
+        index = count - 1;
+    }
+    return sorted[index];
+}
+
+// Handle falso: o stub do esp_websocket_client só grava os envios.
+static esp_websocket_client_handle_t bench_client(void)
+{
+    static int dummy;
+    return (esp_websocket_client_handle_t)&dummy;
+}
+
+static void bench_dispatch(int scale)
+{
+    printf("\n== Dispatch (ws_protocol_handle_complete_text / _binary) ==\n");
+    printf("%-14s %10s %10s %10s %10s %10s\n", "action", "iters", "p50 ns", "p99 ns", "mean ns", "ack bytes");
+
+    esp_websocket_client_handle_t client = bench_client();
+    led_controller_configure(2, 300, LED_STRIP_TYPE_WS2812B);
+    ws_tx_queue_start(client);
+
+    for (size_t m = 0; m < sizeof(bench_messages) / sizeof(bench_messages[0]); m++)
+    {
+        const bench_message_t *msg = &bench_messages[m];
+        int iterations = msg->iterations * scale;
+        int64_t *samples = malloc(sizeof(int64_t) * iterations);
+        if (!samples)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+
+        int payload_len = (msg->binary_len > 0) ? msg->binary_len : (int)strlen(msg->payload);
+        uint32_t bytes_before = host_ws_sent_bytes();
+        int64_t total = 0;
+        for (int i = 0; i < iterations; i++)
+        {
+            int64_t start = now_ns();
+            if (msg->binary_len > 0)
+            {
+                ws_protocol_handle_complete_binary(client, (const uint8_t *)msg->payload, payload_len);
+            }
+            else
+            {
+                ws_protocol_handle_complete_text(client, msg->payload, payload_len);
+            }
+            samples[i] = now_ns() - start;
+            total += samples[i];
+            // Drenagem fora da medição: no firmware é a task de envio que faz isso.
+            while (ws_tx_queue_drain(0))
+            {
+            }
+        }
+
+        qsort(samples, iterations, sizeof(int64_t), compare_i64);
+        printf("%-14s %10d %10lld %10lld %10lld %10u\n", msg->name, iterations,
+               (long long)percentile(samples, iterations, 50),
+               (long long)percentile(samples, iterations, 99),
+               (long long)(total / iterations),
+               (unsigned)((host_ws_sent_bytes() - bytes_before) / iterations));
+        free(samples);
+    }
+
+    ws_action_stats_t stats[16];
+    int stats_count = ws_protocol_get_action_stats(stats, 16);
+    printf("\n%-14s %10s %10s\n", "action", "count", "failed");
+    for (int i = 0; i < stats_count; i++)
+    {
+        printf("%-14s %10u %10u\n", stats[i].name, stats[i].count, stats[i].failures);
+    }
+
+    // A led_task não roda no host: toda mudança de LED depois da primeira
+    // sobrescreve a anterior na caixa de correio, sem nenhum comando recusado.
+    led_mailbox_stats_t mailbox;
+    led_controller_get_mailbox_stats(&mailbox);
+    printf("\nled mailbox: posted=%u superseded=%u\n", mailbox.posted, mailbox.superseded);
+}
+
+// Rajada de comandos sem a task de envio rodar (link lento): os acks pendentes
+// saem agregados quando a fila finalmente é drenada.
+static void bench_tx_burst(int scale)
+{
+    printf("\n== TX burst (ws_tx_queue) ==\n");
+    printf("%-14s %10s %10s %10s %10s\n", "burst", "messages", "frames", "bytes", "dropped");
+
+    static const bench_message_t burst_messages[] = {
+        {"led", "{\"action\":\"led\",\"r\":0,\"g\":255,\"b\":128}", 32},
+        {"bin_led", "\x01\x02" "\x00\xFF\x80\x00", 128, 6},
+        {"bin_led_flood", "\x01\x02" "\x00\xFF\x80\x00", 2000, 6},
+    };
+
+    esp_websocket_client_handle_t client = bench_client();
+    for (size_t m = 0; m < sizeof(burst_messages) / sizeof(burst_messages[0]); m++)
+    {
+        const bench_message_t *msg = &burst_messages[m];
+        int payload_len = (msg->binary_len > 0) ? msg->binary_len : (int)strlen(msg->payload);
+        ws_tx_stats_t before;
+        ws_tx_queue_get_stats(&before);
+        uint32_t frames_before = host_ws_sent_frames();
+        uint32_t bytes_before = host_ws_sent_bytes();
+
+        for (int round = 0; round < scale; round++)
+        {
+            for (int i = 0; i < msg->iterations; i++)
+            {
+                if (msg->binary_len > 0)
+                {
+                    ws_protocol_handle_complete_binary(client, (const uint8_t *)msg->payload, payload_len);
+                }
+                else
+                {
+                    ws_protocol_handle_complete_text(client, msg->payload, payload_len);
+                }
+            }
+            while (ws_tx_queue_drain(0))
+            {
+            }
+        }
+
+        ws_tx_stats_t after;
+        ws_tx_queue_get_stats(&after);
+        printf("%-14s %10d %10u %10u %10u\n", msg->name, msg->iterations * scale,
+               host_ws_sent_frames() - frames_before, host_ws_sent_bytes() - bytes_before,
+               after.dropped - before.dropped);
+    }
+}
+
+static const led_effect_t *bench_find_effect(const char *name)
+{
+    const led_effect_t *effect = led_effect_find(name, (int)strlen(name));
+    if (!effect)
+    {
+        fprintf(stderr, "unknown effect %s\n", name);
+        exit(1);
+    }
+    return effect;
+}
+
+static void bench_effect_run(const char *name, const led_effect_t *effect, const led_effect_params_t *params,
+                             int count, int frames)
+{
+    // Cada frame avança o que o efeito anda num frame nominal (pelo menos 1).
+    uint32_t increment = effect->step_rate >> 8 ? effect->step_rate >> 8 : 1;
+    led_frame_stats_t before;
+    led_controller_get_frame_stats(&before);
+    uint32_t step = 0;
+    int64_t start = now_ns();
+    for (int f = 0; f < frames; f++)
+    {
+        led_controller_render_effect(effect, params, step);
+        step += increment;
+    }
+    int64_t elapsed = now_ns() - start;
+    double ns_per_frame = (double)elapsed / frames;
+    led_frame_stats_t after;
+    led_controller_get_frame_stats(&after);
+    printf("%-12s %6d %10d %12.0f %12.0f %10u %10u\n", name, count, frames, ns_per_frame, 1e9 / ns_per_frame,
+           after.transmitted - before.transmitted, after.skipped - before.skipped);
+}
+
+static void bench_effects_fps(int scale)
+{
+    printf("\n== Effect render (led_controller_render_effect) ==\n");
+    printf("%-12s %6s %10s %12s %12s %10s %10s\n", "effect", "leds", "frames", "ns/frame", "fps", "sent", "skipped");
+
+    for (size_t c = 0; c < sizeof(bench_led_counts) / sizeof(bench_led_counts[0]); c++)
+    {
+        int count = bench_led_counts[c];
+        if (!led_controller_configure(2, count, LED_STRIP_TYPE_WS2812B))
+        {
+            fprintf(stderr, "failed to configure %d LEDs\n", count);
+            exit(1);
+        }
+
+        int frames = (3000000 / count) * scale;
+        for (int id = 0; id < led_effect_count(); id++)
+        {
+            const led_effect_t *effect = led_effect_from_id(id);
+            if (!effect->render)
+            {
+                continue;
+            }
+            led_effect_params_t params;
+            led_effect_params_init(effect, &params);
+            params.colors[0] = bench_base;
+            bench_effect_run(effect->name, effect, &params, count, frames);
+        }
+        for (size_t v = 0; v < sizeof(bench_effect_variants) / sizeof(bench_effect_variants[0]); v++)
+        {
+            const bench_effect_t *variant = &bench_effect_variants[v];
+            const led_effect_t *effect = bench_find_effect(variant->effect);
+            led_effect_params_t params;
+            led_effect_params_init(effect, &params);
+            params.colors[0] = variant->base;
+            if (variant->density)
+            {
+                params.density = variant->density;
+            }
+            if (variant->palette)
+            {
+                params.palette = (uint8_t)led_effect_find_palette(variant->palette, (int)strlen(variant->palette));
+                params.color_count = 2;
+                params.colors[1] = (led_color_t){0, 40, 255, 0};
+            }
+            bench_effect_run(variant->name, effect, &params, count, frames);
+        }
+    }
+}
+
+// Estágio de saída com e sem orçamento de corrente: custo do frame e a
+// corrente estimada antes/depois do limite.
+static void bench_output_stage(int scale)
+{
+    printf("\n== Output stage (brilho + gama + limite de corrente) ==\n");
+    printf("%-10s %6s %10s %12s %12s %10s %10s\n", "budget", "leds", "frames", "ns/frame", "requestedMa", "mA",
+           "limited");
+
+    static const uint32_t budgets[] = {0, 2000, 500};
+    const led_effect_t *rainbow = bench_find_effect("rainbow");
+    led_effect_params_t params;
+    led_effect_params_init(rainbow, &params);
+    const int count = 300;
+    led_controller_configure(2, count, LED_STRIP_TYPE_WS2812B);
+    for (size_t b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++)
+    {
+        led_controller_set_output(255, budgets[b]);
+        led_power_stats_t before;
+        led_controller_get_power_stats(&before);
+        int frames = 10000 * scale;
+        int64_t start = now_ns();
+        for (int f = 0; f < frames; f++)
+        {
+            led_controller_render_effect(rainbow, &params, (uint32_t)f);
+        }
+        double ns_per_frame = (double)(now_ns() - start) / frames;
+        led_power_stats_t after;
+        led_controller_get_power_stats(&after);
+        printf("%-10u %6d %10d %12.0f %12u %10u %10u\n", budgets[b], count, frames, ns_per_frame,
+               after.requested_ma, after.estimated_ma, after.limited_frames - before.limited_frames);
+    }
+    led_controller_set_output(255, 0);
+}
+
+// Mesma fita de 1200 LEDs dividida em 1, 2 e 4 saídas: o tempo de linha por
+// frame (mock do RMT) deve seguir a saída mais longa, não o total.
+static void bench_parallel_outputs(int scale)
+{
+    printf("\n== Parallel outputs (refresh concorrente nos canais RMT) ==\n");
+    printf("%-8s %6s %10s %12s %12s %10s\n", "outputs", "leds", "frames", "ns/frame", "wireUs/frame", "max fps");
+
+    static const int splits[] = {1, 2, 4};
+    const led_effect_t *rainbow = bench_find_effect("rainbow");
+    led_effect_params_t params;
+    led_effect_params_init(rainbow, &params);
+    const int total = 1200;
+    for (size_t s = 0; s < sizeof(splits) / sizeof(splits[0]); s++)
+    {
+        led_output_config_t outputs[LED_MAX_OUTPUTS];
+        for (int i = 0; i < splits[s]; i++)
+        {
+            outputs[i] = (led_output_config_t){.pin = 2 + i, .count = total / splits[s], .type = LED_STRIP_TYPE_WS2812B};
+        }
+        led_controller_configure_outputs(outputs, splits[s]);
+
+        int frames = 1000 * scale;
+        int64_t wire_start = host_led_strip_wire_us();
+        int64_t start = now_ns();
+        for (int f = 0; f < frames; f++)
+        {
+            led_controller_render_effect(rainbow, &params, (uint32_t)f);
+        }
+        double ns_per_frame = (double)(now_ns() - start) / frames;
+        double wire_per_frame = (double)(host_led_strip_wire_us() - wire_start) / frames;
+        printf("%-8d %6d %10d %12.0f %12.0f %10.0f\n", splits[s], total, frames, ns_per_frame, wire_per_frame,
+               1e6 / wire_per_frame);
+    }
+
+    for (int c = 0; c < LED_MAX_OUTPUTS; c++)
+    {
+        host_led_channel_stats_t stats;
+        if (host_led_strip_channel_stats(c, &stats))
+        {
+            printf("channel %d: gpio=%d leds=%u refreshes=%u last_tx_us=%u\n", c, stats.gpio, stats.leds,
+                   stats.refreshes, stats.last_tx_us);
+        }
+    }
+}
+
+// Custo de CPU de cada backend para o mesmo rainbow (todos os pixels mudam a
+// cada frame). O backend de gravação grava em record_path, se houver, e o
+// checksum dos frames serve de referência entre execuções.
+static void bench_backends(int scale, const char *record_path)
+{
+    printf("\n== Backends (rainbow, encoder + envio) ==\n");
+    printf("%-8s %6s %10s %12s %12s\n", "backend", "leds", "frames", "ns/frame", "wireUs/frame");
+
+    const led_backend_t *backends[] = {&led_backend_rmt, &led_backend_spi, &led_backend_record};
+    const led_effect_t *rainbow = bench_find_effect("rainbow");
+    led_effect_params_t params;
+    led_effect_params_init(rainbow, &params);
+    const int count = 300;
+    if (record_path && !led_backend_record_open(record_path))
+    {
+        fprintf(stderr, "cannot open %s\n", record_path);
+    }
+    uint32_t recorded_before = led_backend_record_frames();
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++)
+    {
+        const led_output_config_t output = {
+            .pin = 2, .count = count, .type = LED_STRIP_TYPE_WS2812B, .backend = backends[b]
+        };
+        led_controller_configure_outputs(&output, 1);
+
+        int frames = 10000 * scale;
+        int64_t wire_start = host_led_strip_wire_us();
+        int64_t start = now_ns();
+        for (int f = 0; f < frames; f++)
+        {
+            led_controller_render_effect(rainbow, &params, (uint32_t)f);
+        }
+        double ns_per_frame = (double)(now_ns() - start) / frames;
+        double wire_per_frame = (double)(host_led_strip_wire_us() - wire_start) / frames;
+        printf("%-8s %6d %10d %12.0f %12.0f\n", backends[b]->name, count, frames, ns_per_frame, wire_per_frame);
+    }
+    led_controller_configure(2, count, LED_STRIP_TYPE_WS2812B);
+    led_backend_record_close();
+    printf("record: frames=%u checksum=%08x spi: transactions=%u bytes=%llu\n",
+           led_backend_record_frames() - recorded_before, led_backend_record_checksum(), host_spi_transaction_count(),
+           (unsigned long long)host_spi_tx_bytes());
+}
+
+// Frame binário do stream: [versão][0x05][flags][seq BE][offset BE][pixels].
+static int build_stream_frame(uint8_t *frame, uint16_t seq, uint16_t offset, int pixels, bool push)
+{
+    frame[0] = 0x01;
+    frame[1] = 0x05;
+    frame[2] = push ? 0x02 : 0x00;
+    frame[3] = (uint8_t)(seq >> 8);
+    frame[4] = (uint8_t)seq;
+    frame[5] = (uint8_t)(offset >> 8);
+    frame[6] = (uint8_t)offset;
+    for (int i = 0; i < pixels * 3; i++)
+    {
+        frame[7 + i] = (uint8_t)(seq + i);
+    }
+    return 7 + pixels * 3;
+}
+
+// Frame inteiro num único pedaço (caso comum a 50 fps) e frame em 4 pedaços,
+// medindo parse + escrita no back buffer + troca e envio para a fita.
+static void bench_stream(int scale)
+{
+    printf("\n== Stream (binário 0x05 -> led_controller_stream_render) ==\n");
+    printf("%-10s %6s %8s %10s %10s\n", "mode", "leds", "frames", "ns/frame", "fps");
+
+    static uint8_t frame[7 + 1000 * 3];
+    static const int counts[] = {300, 1000};
+    esp_websocket_client_handle_t client = bench_client();
+    uint16_t seq = 0;
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        int count = counts[c];
+        led_controller_configure(2, count, LED_STRIP_TYPE_WS2812B);
+        for (int chunks = 1; chunks <= 4; chunks *= 4)
+        {
+            int frames = 5000 * scale;
+            int per_chunk = count / chunks;
+            int64_t start = now_ns();
+            for (int f = 0; f < frames; f++)
+            {
+                seq++;
+                for (int k = 0; k < chunks; k++)
+                {
+                    int len = build_stream_frame(frame, seq, (uint16_t)(k * per_chunk), per_chunk, k == chunks - 1);
+                    ws_protocol_handle_complete_binary(client, frame, len);
+                }
+                led_controller_stream_render();
+            }
+            double ns_per_frame = (double)(now_ns() - start) / frames;
+            printf("%-10s %6d %8d %10.0f %10.0f\n", chunks == 1 ? "full" : "4 chunks", count, frames,
+                   ns_per_frame, 1e9 / ns_per_frame);
+        }
+    }
+
+    // Rajada fora de ordem sem a led_task renderizar entre os frames:
+    // atrasados viram stale e os não renderizados, overrun.
+    static const int16_t jitter[] = {1, 3, 2, 4, 4, 6, 5, 7};
+    uint16_t base = seq;
+    for (size_t i = 0; i < sizeof(jitter) / sizeof(jitter[0]); i++)
+    {
+        int len = build_stream_frame(frame, (uint16_t)(base + jitter[i]), 0, 10, true);
+        ws_protocol_handle_complete_binary(client, frame, len);
+    }
+    led_controller_stream_render();
+
+    led_stream_stats_t stats;
+    led_controller_get_stream_stats(&stats);
+    printf("rendered=%u stale=%u overrun=%u latency_us(last/avg/max)=%u/%u/%u\n",
+           stats.frames_rendered, stats.frames_stale, stats.frames_overrun,
+           stats.last_latency_us, stats.avg_latency_us, stats.max_latency_us);
+}
+
+// Custo de montar o pacote mágico a cada envio contra reaproveitá-lo do cache
+// por alvo (sem e com SecureOn).
+static void bench_wol_packet(int scale)
+{
+    printf("\n== WoL packet (wol_packet_build / wol_packet_get) ==\n");
+    printf("%-10s %10s %10s\n", "password", "build ns", "cached ns");
+
+    static const uint8_t mac[WOL_MAC_LEN] = {0xA8, 0xA1, 0x59, 0x98, 0x61, 0x0E};
+    static const uint8_t password[WOL_SECUREON_LEN] = {1, 2, 3, 4, 5, 6};
+    int iterations = 200000 * scale;
+    uint32_t checksum = 0;
+    for (int secure = 0; secure <= 1; secure++)
+    {
+        const uint8_t *pw = secure ? password : NULL;
+        wol_packet_t packet;
+        int64_t start = now_ns();
+        for (int i = 0; i < iterations; i++)
+        {
+            wol_packet_build(&packet, mac, pw);
+            checksum += packet.data[i % packet.len];
+        }
+        double build_ns = (double)(now_ns() - start) / iterations;
+
+        start = now_ns();
+        for (int i = 0; i < iterations; i++)
+        {
+            const wol_packet_t *cached = wol_packet_get(mac, pw);
+            checksum += cached->data[i % cached->len];
+        }
+        double cached_ns = (double)(now_ns() - start) / iterations;
+        printf("%-10s %10.1f %10.1f\n", secure ? "secureon" : "none", build_ns, cached_ns);
+    }
+    printf("checksum=%u\n", (unsigned)checksum);
+}
+
+// Parser anterior (sscanf), só para comparação: aceita um dígito por byte,
+// lixo no fim e separadores misturados no formato sem separador.
+static bool mac_parse_sscanf(const char *input, uint8_t *mac)
+{
+    int values[6] = {0};
+    int count;
+    if (strchr(input, ':'))
+    {
+        count = sscanf(input, "%02x:%02x:%02x:%02x:%02x:%02x", &values[0], &values[1], &values[2], &values[3],
+                       &values[4], &values[5]);
+    }
+    else if (strchr(input, '-'))
+    {
+        count = sscanf(input, "%02x-%02x-%02x-%02x-%02x-%02x", &values[0], &values[1], &values[2], &values[3],
+                       &values[4], &values[5]);
+    }
+    else
+    {
+        count = sscanf(input, "%02x%02x%02x%02x%02x%02x", &values[0], &values[1], &values[2], &values[3],
+                       &values[4], &values[5]);
+    }
+    for (int i = 0; i < 6 && count == 6; i++)
+    {
+        mac[i] = (uint8_t)values[i];
+    }
+    return count == 6;
+}
+
+// Referência da gramática, escrita de outro jeito (isxdigit + strtoul), para
+// conferir o parser de tabela.
+static bool mac_parse_reference(const char *input, size_t len, uint8_t *mac)
+{
+    char separator = (len == MAC_STRING_LEN) ? input[2] : 0;
+    if ((len != MAC_STRING_LEN && len != 12) || (separator && separator != ':' && separator != '-'))
+    {
+        return false;
+    }
+    for (int i = 0; i < 6; i++)
+    {
+        const char *group = input + i * (separator ? 3 : 2);
+        if (!isxdigit((unsigned char)group[0]) || !isxdigit((unsigned char)group[1]) ||
+            (separator && i < 5 && group[2] != separator))
+        {
+            return false;
+        }
+        char hex[3] = {group[0], group[1], 0};
+        mac[i] = (uint8_t)strtoul(hex, NULL, 16);
+    }
+    return true;
+}
+
+typedef struct
+{
+    int inputs;
+    int valid;
+    int mismatches; // parse_mac diverge da referência (validade ou bytes)
+    int sloppy;     // inválidos que o parser anterior aceitava
+} mac_corpus_t;
+
+static void mac_corpus_check(mac_corpus_t *corpus, const char *input, size_t len)
+{
+    uint8_t got[6] = {0};
+    uint8_t want[6] = {0};
+    bool ok = parse_mac(input, len, got);
+    bool expected = mac_parse_reference(input, len, want);
+    corpus->inputs++;
+    corpus->valid += expected;
+    if (ok != expected || (ok && memcmp(got, want, sizeof(got)) != 0))
+    {
+        corpus->mismatches++;
+    }
+    if (ok)
+    {
+        // Ida e volta: format_mac_string tem que bater com o snprintf.
+        char formatted[MAC_STRING_LEN + 1];
+        char reference[MAC_STRING_LEN + 1];
+        format_mac_string(got, formatted);
+        snprintf(reference, sizeof(reference), "%02X:%02X:%02X:%02X:%02X:%02X", got[0], got[1], got[2], got[3],
+                 got[4], got[5]);
+        corpus->mismatches += strcmp(formatted, reference) != 0;
+    }
+
+    char text[32];
+    if (!expected && len < sizeof(text) && !memchr(input, 0, len))
+    {
+        memcpy(text, input, len);
+        text[len] = 0;
+        corpus->sloppy += mac_parse_sscanf(text, got);
+    }
+}
+
+// Custo por MAC do parser de tabela contra o sscanf (nos três formatos) e da
+// formatação contra o snprintf; depois o corpus de conformidade: cada posição
+// de um MAC válido trocada por cada um dos 256 bytes, cortes e sobras no fim,
+// e strings aleatórias de um alfabeto viciado em hexa e separadores.
+static void bench_mac_parser(int scale)
+{
+    printf("\n== MAC (parse_mac / format_mac_string) ==\n");
+    printf("%-8s %10s %10s\n", "format", "sscanf ns", "table ns");
+
+    static const char *samples[] = {"A8:A1:59:98:61:0E", "a8-a1-59-98-61-0e", "A8A15998610E"};
+    static const char *names[] = {"colon", "hyphen", "bare"};
+    int iterations = 200000 * scale;
+    uint32_t checksum = 0;
+    uint8_t mac[6];
+    for (int f = 0; f < 3; f++)
+    {
+        size_t len = strlen(samples[f]);
+        int64_t start = now_ns();
+        for (int i = 0; i < iterations; i++)
+        {
+            checksum += mac_parse_sscanf(samples[f], mac) + mac[i % 6];
+        }
+        double sscanf_ns = (double)(now_ns() - start) / iterations;
+
+        start = now_ns();
+        for (int i = 0; i < iterations; i++)
+        {
+            checksum += parse_mac(samples[f], len, mac) + mac[i % 6];
+        }
+        double table_ns = (double)(now_ns() - start) / iterations;
+        printf("%-8s %10.1f %10.1f\n", names[f], sscanf_ns, table_ns);
+    }
+
+    char text[MAC_STRING_LEN + 1];
+    int64_t start = now_ns();
+    for (int i = 0; i < iterations; i++)
+    {
+        mac[i % 6] = (uint8_t)i;
+        snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        checksum += (uint8_t)text[i % MAC_STRING_LEN];
+    }
+    double snprintf_ns = (double)(now_ns() - start) / iterations;
+    start = now_ns();
+    for (int i = 0; i < iterations; i++)
+    {
+        mac[i % 6] = (uint8_t)i;
+        format_mac_string(mac, text);
+        checksum += (uint8_t)text[i % MAC_STRING_LEN];
+    }
+    double format_ns = (double)(now_ns() - start) / iterations;
+    printf("format: snprintf %.1f ns, tabela %.1f ns  checksum=%u\n", snprintf_ns, format_ns, (unsigned)checksum);
+
+    mac_corpus_t corpus = {0};
+    char input[32];
+    for (int f = 0; f < 3; f++)
+    {
+        size_t len = strlen(samples[f]);
+        for (size_t pos = 0; pos < len; pos++)
+        {
+            for (int byte = 0; byte < 256; byte++)
+            {
+                memcpy(input, samples[f], len);
+                input[pos] = (char)byte;
+                mac_corpus_check(&corpus, input, len);
+            }
+        }
+        for (size_t cut = 0; cut <= len; cut++)
+        {
+            mac_corpus_check(&corpus, samples[f], cut);
+        }
+        for (int byte = 0; byte < 256; byte++)
+        {
+            memcpy(input, samples[f], len);
+            input[len] = (char)byte;
+            mac_corpus_check(&corpus, input, len + 1);
+        }
+    }
+
+    static const char alphabet[] = "0123456789abcdefABCDEF:-:- xgG0";
+    uint32_t rng = 12345;
+    int fuzz = 200000 * scale;
+    for (int i = 0; i < fuzz; i++)
+    {
+        rng = rng * 1103515245u + 12345u;
+        // Tamanhos perto dos válidos (12 e 17) na maioria das vezes.
+        size_t len = ((rng >> 16) & 1) ? MAC_STRING_LEN - 1 + (rng >> 17) % 3 : (rng >> 17) % 20;
+        for (size_t c = 0; c < len; c++)
+        {
+            rng = rng * 1103515245u + 12345u;
+            input[c] = alphabet[(rng >> 16) % (sizeof(alphabet) - 1)];
+        }
+        // Metade com os separadores no lugar, para chegar aos casos válidos.
+        if (len == MAC_STRING_LEN && (rng >> 20) & 1)
+        {
+            for (int g = 2; g < MAC_STRING_LEN; g += 3)
+            {
+                input[g] = ((rng >> 21) & 1) ? ':' : '-';
+            }
+        }
+        mac_corpus_check(&corpus, input, len);
+    }
+    printf("corpus: %d entradas (%d válidas), %d divergências da referência, %d inválidas aceitas pelo sscanf\n",
+           corpus.inputs, corpus.valid, corpus.mismatches, corpus.sloppy);
+}
+
+#define BENCH_AUTH_SECRET "bench-secret-0123456789"
+#define BENCH_AUTH_TOKEN "esp32-1760000000"
+#define BENCH_AUTH_NONCE "5f0c9a3e71d2b84c"
+// Prefixo do MAC de cada mensagem: token seguido do nonce.
+#define BENCH_AUTH_CONTEXT BENCH_AUTH_TOKEN BENCH_AUTH_NONCE
+#define BENCH_SIGNED_MAX 4200
+
+// Assina como o servidor: prefixo {"sig":...,"seq":N, e o resto do objeto.
+static int bench_sign_text(const char *body, uint32_t seq, char *out, size_t out_size)
+{
+    int len = snprintf(out, out_size, "{\"sig\":\"%0*d\",\"seq\":%u,%s", WS_AUTH_SIG_HEX_LEN, 0, (unsigned)seq,
+                       body + 1);
+    const size_t sig_start = 8;
+    const size_t sig_end = sig_start + WS_AUTH_SIG_HEX_LEN;
+    static uint8_t data[WS_AUTH_TOKEN_MAX + WS_AUTH_NONCE_HEX_LEN + BENCH_SIGNED_MAX];
+    size_t token_len = strlen(BENCH_AUTH_CONTEXT);
+    memcpy(data, BENCH_AUTH_CONTEXT, token_len);
+    memcpy(data + token_len, out + sig_end, len - sig_end);
+    uint8_t mac[NET_HMAC_LEN];
+    net_hmac_sign(data, token_len + len - sig_end, mac);
+    for (int i = 0; i < NET_HMAC_TAG_LEN; i++)
+    {
+        char hex[3];
+        snprintf(hex, sizeof(hex), "%02x", mac[i]);
+        memcpy(out + sig_start + i * 2, hex, 2);
+    }
+    return len;
+}
+
+// Frame binário + [seq u32 BE][tag 16].
+static int bench_sign_binary(const uint8_t *frame, int frame_len, uint32_t seq, uint8_t *out)
+{
+    size_t token_len = strlen(BENCH_AUTH_CONTEXT);
+    uint8_t data[WS_AUTH_TOKEN_MAX + WS_AUTH_NONCE_HEX_LEN + 64];
+    memcpy(out, frame, frame_len);
+    out[frame_len] = (uint8_t)(seq >> 24);
+    out[frame_len + 1] = (uint8_t)(seq >> 16);
+    out[frame_len + 2] = (uint8_t)(seq >> 8);
+    out[frame_len + 3] = (uint8_t)seq;
+    memcpy(data, BENCH_AUTH_CONTEXT, token_len);
+    memcpy(data + token_len, out, frame_len + 4);
+    uint8_t mac[NET_HMAC_LEN];
+    net_hmac_sign(data, token_len + frame_len + 4, mac);
+    memcpy(out + frame_len + 4, mac, NET_HMAC_TAG_LEN);
+    return frame_len + WS_AUTH_BINARY_TRAILER_LEN;
+}
+
+static void bench_auth_dispatch(const char *name, const char *payload, int binary_len, bool sign, int iterations)
+{
+    esp_websocket_client_handle_t client = bench_client();
+    ws_command_auth_reset(BENCH_AUTH_TOKEN, BENCH_AUTH_NONCE, sign);
+
+    // Mensagens assinadas antes da medição: cada uma com a sua seq.
+    int stride = BENCH_SIGNED_MAX;
+    char *messages = malloc((size_t)stride * iterations);
+    int *lengths = malloc(sizeof(int) * iterations);
+    int64_t *samples = malloc(sizeof(int64_t) * iterations);
+    if (!messages || !lengths || !samples)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < iterations; i++)
+    {
+        char *out = messages + (size_t)stride * i;
+        if (binary_len > 0)
+        {
+            lengths[i] = sign ? bench_sign_binary((const uint8_t *)payload, binary_len, i + 1, (uint8_t *)out)
+                              : binary_len;
+            if (!sign)
+            {
+                memcpy(out, payload, binary_len);
+            }
+        }
+        else
+        {
+            lengths[i] = sign ? bench_sign_text(payload, i + 1, out, stride)
+                              : snprintf(out, stride, "%s", payload);
+        }
+    }
+
+    int64_t total = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        const char *message = messages + (size_t)stride * i;
+        int64_t start = now_ns();
+        if (binary_len > 0)
+        {
+            ws_protocol_handle_complete_binary(client, (const uint8_t *)message, lengths[i]);
+        }
+        else
+        {
+            ws_protocol_handle_complete_text(client, message, lengths[i]);
+        }
+        samples[i] = now_ns() - start;
+        total += samples[i];
+        while (ws_tx_queue_drain(0))
+        {
+        }
+    }
+
+    qsort(samples, iterations, sizeof(int64_t), compare_i64);
+    printf("%-14s %10s %10d %10lld %10lld %10lld\n", name, sign ? "signed" : "plain", lengths[0],
+           (long long)percentile(samples, iterations, 50), (long long)percentile(samples, iterations, 99),
+           (long long)(total / iterations));
+    free(messages);
+    free(lengths);
+    free(samples);
+}
+
+// Comandos assinados: custo da verificação por tamanho de mensagem e o
+// impacto no dispatch do led (caminho quente), com a chave já importada.
+static void bench_command_auth(int scale)
+{
+    printf("\n== Signed commands (ws_command_auth, HMAC-SHA256-128) ==\n");
+    if (!net_hmac_init((const uint8_t *)BENCH_AUTH_SECRET, strlen(BENCH_AUTH_SECRET)))
+    {
+        fprintf(stderr, "net_hmac_init failed\n");
+        exit(1);
+    }
+
+    // A mesma mensagem repetida: depois da primeira o MAC confere e a seq é
+    // recusada como replay, mas o custo do MAC é o mesmo.
+    static const int sizes[] = {128, 256, 1024, 4096};
+    static char body[BENCH_SIGNED_MAX];
+    static char signed_text[BENCH_SIGNED_MAX + 64];
+    printf("%-10s %10s %10s\n", "bytes", "verify ns", "ns/byte");
+    int iterations = 100000 * scale;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        // 74 = esqueleto do corpo + prefixo de assinatura.
+        int pad = sizes[s] - 74;
+        snprintf(body, sizeof(body), "{\"action\":\"led\",\"pad\":\"%0*d\"}", pad > 0 ? pad : 0, 0);
+        int len = bench_sign_text(body, 1, signed_text, sizeof(signed_text));
+        ws_command_auth_reset(BENCH_AUTH_TOKEN, BENCH_AUTH_NONCE, true);
+        int runs = iterations / (1 + sizes[s] / 256);
+        int64_t start = now_ns();
+        for (int i = 0; i < runs; i++)
+        {
+            ws_command_auth_check_text(signed_text, len);
+        }
+        double ns = (double)(now_ns() - start) / runs;
+        printf("%-10d %10.0f %10.2f\n", len, ns, ns / len);
+    }
+
+    printf("%-14s %10s %10s %10s %10s %10s\n", "action", "mode", "bytes", "p50 ns", "p99 ns", "mean ns");
+    for (int sign = 0; sign <= 1; sign++)
+    {
+        bench_auth_dispatch("led", "{\"action\":\"led\",\"r\":0,\"g\":255,\"b\":128}", 0, sign, 20000 * scale);
+    }
+    for (int sign = 0; sign <= 1; sign++)
+    {
+        bench_auth_dispatch("bin_led", "\x01\x02" "\x00\xFF\x80\x00", 6, sign, 20000 * scale);
+    }
+
+    // Rejeições: sem assinatura, MAC adulterado, seq repetida e binário sem trailer.
+    esp_websocket_client_handle_t client = bench_client();
+    ws_command_auth_stats_t before;
+    ws_command_auth_get_stats(&before);
+    ws_command_auth_reset(BENCH_AUTH_TOKEN, BENCH_AUTH_NONCE, true);
+    const char *led = "{\"action\":\"led\",\"r\":0,\"g\":255,\"b\":128}";
+    int len = bench_sign_text(led, 7, signed_text, sizeof(signed_text));
+    ws_protocol_handle_complete_text(client, led, (int)strlen(led));
+    ws_protocol_handle_complete_text(client, signed_text, len);
+    ws_protocol_handle_complete_text(client, signed_text, len);
+    signed_text[len - 2] ^= 1;
+    ws_protocol_handle_complete_text(client, signed_text, len);
+    ws_protocol_handle_complete_binary(client, (const uint8_t *)"\x01\x02\x00\xFF\x80\x00", 6);
+    while (ws_tx_queue_drain(0))
+    {
+    }
+    ws_command_auth_stats_t stats;
+    ws_command_auth_get_stats(&stats);
+    printf("rejections: verified=%u rejected=%u replays=%u lastSeq=%u\n", (unsigned)(stats.verified - before.verified),
+           (unsigned)(stats.rejected - before.rejected), (unsigned)(stats.replays - before.replays),
+           (unsigned)stats.last_seq);
+
+    // O resto do benchmark roda sem assinatura.
+    ws_command_auth_reset(BENCH_AUTH_TOKEN, BENCH_AUTH_NONCE, false);
+}
+
+// Socket TCP em 127.0.0.1 numa porta livre; backlog 0 = fila de conexões
+// pendentes mínima (ver bench_wol_verify).
+static int bench_listen(struct sockaddr_in *addr, int backlog)
+{
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(*addr);
+    if (sock < 0 || bind(sock, (struct sockaddr *)addr, len) != 0 || listen(sock, backlog) != 0 ||
+        getsockname(sock, (struct sockaddr *)addr, &len) != 0)
+    {
+        return -1;
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    return sock;
+}
+
+static void bench_accept_all(int listener)
+{
+    int conn;
+    while ((conn = accept(listener, NULL, NULL)) >= 0)
+    {
+        close(conn);
+    }
+}
+
+// Sondas contra um alvo local (porta aberta, porta fechada, eco ICMP) e uma
+// verificação completa contra um "alvo dormindo": a fila de conexões cheia
+// descarta os SYN até ele "acordar" (a fila é esvaziada), como uma máquina
+// que só responde quando sobe. aliveAfterMs fica entre o despertar e a
+// sonda seguinte do back-off.
+static void bench_wol_verify(int scale)
+{
+    printf("\n== WoL verify (wol_probe / wol_verify_run_due, alvo em 127.0.0.1) ==\n");
+
+    struct sockaddr_in addr;
+    int listener = bench_listen(&addr, 16);
+    if (listener < 0)
+    {
+        printf("sem socket local, pulado\n");
+        return;
+    }
+
+    struct sockaddr_in closed_addr;
+    int closed = bench_listen(&closed_addr, 1);
+    close(closed); // porta livre: o connect recebe RST
+
+    printf("%-12s %8s %10s %8s\n", "probe", "iters", "mean us", "alive");
+    static const struct
+    {
+        const char *name;
+        wol_probe_kind_t kind;
+        bool open;
+    } probes[] = {
+        {"tcp_open", WOL_PROBE_TCP, true},
+        {"tcp_closed", WOL_PROBE_TCP, false},
+        {"icmp", WOL_PROBE_ICMP, false},
+    };
+    int iterations = 1000 * scale;
+    for (size_t p = 0; p < sizeof(probes) / sizeof(probes[0]); p++)
+    {
+        uint16_t port = ntohs(probes[p].open ? addr.sin_port : closed_addr.sin_port);
+        int alive = 0;
+        int errors = 0;
+        int64_t start = now_ns();
+        for (int i = 0; i < iterations; i++)
+        {
+            wol_probe_result_t result = wol_probe(probes[p].kind, htonl(INADDR_LOOPBACK), port, 500);
+            alive += (result == WOL_PROBE_ALIVE);
+            errors += (result == WOL_PROBE_ERROR);
+            bench_accept_all(listener);
+        }
+        double mean_us = (double)(now_ns() - start) / iterations / 1000.0;
+        if (errors == iterations)
+        {
+            printf("%-12s %8s\n", probes[p].name, "sem permissão");
+            continue;
+        }
+        printf("%-12s %8d %10.1f %8d\n", probes[p].name, iterations, mean_us, alive);
+    }
+    close(listener);
+
+    // Alvo dormindo: backlog 0 com conexões presas enche a fila.
+    int sleeper = bench_listen(&addr, 0);
+    int stuck[4];
+    for (int i = 0; i < 4; i++)
+    {
+        stuck[i] = socket(AF_INET, SOCK_STREAM, 0);
+        fcntl(stuck[i], F_SETFL, O_NONBLOCK);
+        connect(stuck[i], (struct sockaddr *)&addr, sizeof(addr));
+    }
+
+    esp_websocket_client_handle_t client = bench_client();
+    ws_tx_queue_start(client);
+    char payload[192];
+    int len = snprintf(payload, sizeof(payload),
+                       "{\"action\":\"wol\",\"mac\":\"A8:A1:59:98:61:0E\",\"verify\":\"tcp\",\"ip\":\"127.0.0.1\","
+                       "\"probePort\":%u,\"timeoutMs\":5000}",
+                       (unsigned)ntohs(addr.sin_port));
+    const int wake_ms = 1200;
+    int64_t start_us = esp_timer_get_time();
+    ws_protocol_handle_complete_text(client, payload, len);
+    while (ws_tx_queue_drain(0))
+    {
+    }
+
+    bool awake = false;
+    int64_t next_us;
+    while ((next_us = wol_verify_run_due()) >= 0)
+    {
+        int64_t now_us = esp_timer_get_time();
+        if (!awake && now_us - start_us >= wake_ms * 1000)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                close(stuck[i]);
+            }
+            bench_accept_all(sleeper);
+            awake = true;
+        }
+        int64_t wait_us = next_us - now_us;
+        if (!awake && start_us + wake_ms * 1000 - now_us < wait_us)
+        {
+            wait_us = start_us + wake_ms * 1000 - now_us;
+        }
+        if (wait_us > 0)
+        {
+            usleep((useconds_t)wait_us);
+        }
+    }
+    while (ws_tx_queue_drain(0))
+    {
+    }
+    printf("alvo acorda em %d ms: %s\n", wake_ms, host_ws_last_sent(NULL));
+    close(sleeper);
+}
+
+// Um show de 64 keyframes (cores e efeitos alternados, 250 ms entre eles) em
+// loop, tocado em frames de 20 ms com atraso aleatório de até 8 ms (relógio
+// simulado): custo por frame e posição/voltas no fim contra o esperado.
+static void bench_timeline(int scale)
+{
+    printf("\n== Timeline (upload + led_controller_timeline_tick) ==\n");
+
+    static char payload[LED_TIMELINE_MAX_KEYFRAMES * 96 + 96];
+    int len = snprintf(payload, sizeof(payload), "{\"action\":\"timeline\",\"loop\":true,\"durationMs\":%d,"
+                       "\"keyframes\":[", LED_TIMELINE_MAX_KEYFRAMES * 250);
+    for (int i = 0; i < LED_TIMELINE_MAX_KEYFRAMES; i++)
+    {
+        if (i % 2 == 0)
+        {
+            len += snprintf(payload + len, sizeof(payload) - len,
+                            "%s{\"atMs\":%d,\"r\":%d,\"g\":%d,\"b\":0,\"transitionMs\":200}",
+                            i ? "," : "", i * 250, (i * 37) & 0xFF, (i * 91) & 0xFF);
+        }
+        else
+        {
+            len += snprintf(payload + len, sizeof(payload) - len, ",{\"atMs\":%d,\"effect\":\"%s\"}",
+                            i * 250, (i % 4 == 1) ? "rainbow" : "comet");
+        }
+    }
+    len += snprintf(payload + len, sizeof(payload) - len, "]}");
+
+    led_controller_configure(2, 300, LED_STRIP_TYPE_WS2812B);
+    esp_websocket_client_handle_t client = bench_client();
+    int iterations = 2000 * scale;
+    int64_t start = now_ns();
+    for (int i = 0; i < iterations; i++)
+    {
+        ws_protocol_handle_complete_text(client, payload, len);
+        while (ws_tx_queue_drain(0))
+        {
+        }
+    }
+    int reply_len = 0;
+    const char *reply = host_ws_last_sent(&reply_len);
+    printf("upload: %d bytes, %.0f ns  reply=%.*s\n", len, (double)(now_ns() - start) / iterations,
+           reply_len, reply);
+
+    // Upload recusado antes da led_task trocar de timeline: a publicada continua.
+    static const char rejected[] = "{\"action\":\"timeline\",\"keyframes\":[{\"atMs\":500,\"r\":1,\"g\":2,\"b\":3},"
+                                   "{\"atMs\":100,\"r\":1,\"g\":2,\"b\":3}]}";
+    ws_protocol_handle_complete_text(client, rejected, (int)sizeof(rejected) - 1);
+    while (ws_tx_queue_drain(0))
+    {
+    }
+    reply = host_ws_last_sent(&reply_len);
+    printf("recusado: reply=%.*s\n", reply_len, reply);
+
+    int frames = 15000 * scale;
+    int64_t now_us = 0;
+    uint32_t rng = 12345;
+    led_controller_timeline_tick(now_us);
+    start = now_ns();
+    for (int f = 0; f < frames; f++)
+    {
+        rng = rng * 1103515245u + 12345u;
+        now_us += 20000 + (int64_t)((rng >> 16) % 8000);
+        led_controller_timeline_tick(now_us);
+    }
+    double ns_per_frame = (double)(now_ns() - start) / frames;
+
+    led_timeline_status_t status;
+    led_controller_get_timeline_status(&status);
+    int64_t duration_us = (int64_t)status.duration_ms * 1000;
+    printf("frames=%d ns/frame=%.0f keyframes=%d (esperado %d) loops=%u (esperado %lld) positionMs=%u "
+           "(esperado %lld)\n", frames, ns_per_frame, status.keyframes, LED_TIMELINE_MAX_KEYFRAMES,
+           (unsigned)status.loops, (long long)(now_us / duration_us), (unsigned)status.position_ms,
+           (long long)(now_us % duration_us / 1000));
+    led_controller_timeline_control(LED_TIMELINE_STOP, 0);
+    led_controller_timeline_tick(now_us);
+}
+
+// Pilha dos handlers: no firmware eles rodam na task do cliente WS, com a
+// pilha fixada em ws_transport.c. Aqui cada mensagem roda numa thread com a
+// pilha pintada; a profundidade é a distância entre a entrada do dispatch e
+// o byte mais fundo tocado (sem o TLS e a partida da thread).
+#define BENCH_STACK_SIZE (64 * 1024)
+#define BENCH_STACK_PAINT 0xA5
+// Pilha da task do WS (8 KB) menos 2 KB para o próprio cliente. A medida do
+// host é pessimista: o snprintf da glibc sozinho desce ~2 KB.
+#define BENCH_STACK_BUDGET 6144
+
+// Além das mensagens do dispatch, os caminhos mais fundos: arrays de itens
+// na config e na timeline, dentro e fora de um batch.
+static const bench_message_t bench_stack_messages[] = {
+    {"config_outputs", "{\"action\":\"config\",\"status\":\"ok\",\"outputs\":[{\"ledCount\":150,\"ledPin\":2},"
+                       "{\"ledCount\":150,\"ledPin\":4,\"backend\":\"spi\"}],\"segments\":[{\"name\":\"mesa\","
+                       "\"start\":0,\"length\":100},{\"name\":\"estante\",\"start\":100,\"length\":200,"
+                       "\"reversed\":true}]}", 1},
+    {"timeline_fx", "{\"action\":\"timeline\",\"keyframes\":[{\"atMs\":0,\"effect\":\"chase\",\"colors\":"
+                    "[{\"r\":255,\"g\":0,\"b\":0},{\"r\":0,\"g\":0,\"b\":255}]},{\"atMs\":500,\"r\":1,\"g\":2,"
+                    "\"b\":3,\"segment\":\"mesa\"}]}", 1},
+    {"batch_config", "{\"action\":\"batch\",\"commands\":[{\"action\":\"config\",\"status\":\"ok\",\"outputs\":"
+                     "[{\"ledCount\":300,\"ledPin\":2}],\"segments\":[{\"name\":\"mesa\",\"start\":0,"
+                     "\"length\":100}]},{\"action\":\"led\",\"r\":1,\"g\":2,\"b\":3,\"segment\":\"mesa\"}]}", 1},
+    {"batch_timeline", "{\"action\":\"batch\",\"commands\":[{\"action\":\"timeline\",\"keyframes\":[{\"atMs\":0,"
+                       "\"effect\":\"chase\",\"colors\":[{\"r\":255,\"g\":0,\"b\":0}]}]},{\"action\":\"stats\"}]}", 1},
+};
+
+static uint8_t bench_stack[BENCH_STACK_SIZE] __attribute__((aligned(64)));
+static uintptr_t bench_stack_entry;
+
+static void *bench_stack_run(void *arg)
+{
+    const bench_message_t *msg = (const bench_message_t *)arg;
+    volatile char marker = 0;
+    bench_stack_entry = (uintptr_t)&marker;
+
+    esp_websocket_client_handle_t client = bench_client();
+    if (msg->binary_len > 0)
+    {
+        ws_protocol_handle_complete_binary(client, (const uint8_t *)msg->payload, msg->binary_len);
+    }
+    else
+    {
+        ws_protocol_handle_complete_text(client, msg->payload, (int)strlen(msg->payload));
+    }
+    return NULL;
+}
+
+// Bytes da pilha (que cresce para baixo) tocados abaixo da entrada do dispatch.
+static size_t bench_stack_depth_of(const bench_message_t *msg)
+{
+    memset(bench_stack, BENCH_STACK_PAINT, sizeof(bench_stack));
+
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    if (pthread_attr_setstack(&attr, bench_stack, sizeof(bench_stack)) != 0 ||
+        pthread_create(&thread, &attr, bench_stack_run, (void *)msg) != 0)
+    {
+        fprintf(stderr, "failed to start stack thread\n");
+        exit(1);
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+    while (ws_tx_queue_drain(0))
+    {
+    }
+
+    size_t untouched = 0;
+    while (untouched < sizeof(bench_stack) && bench_stack[untouched] == BENCH_STACK_PAINT)
+    {
+        untouched++;
+    }
+    uintptr_t deepest = (uintptr_t)&bench_stack[untouched];
+    return bench_stack_entry > deepest ? (size_t)(bench_stack_entry - deepest) : 0;
+}
+
+static void bench_stack_report(const bench_message_t *msg, const bench_message_t **worst, size_t *worst_depth)
+{
+    size_t depth = bench_stack_depth_of(msg);
+    printf("%-14s %10zu%s\n", msg->name, depth, depth > BENCH_STACK_BUDGET ? "  acima do teto" : "");
+    if (depth > *worst_depth)
+    {
+        *worst = msg;
+        *worst_depth = depth;
+    }
+}
+
+// Retorna false se alguma ação passa de BENCH_STACK_BUDGET.
+static bool bench_stack_depth(void)
+{
+    printf("\n== Pilha do dispatch por ação (teto %d bytes) ==\n", BENCH_STACK_BUDGET);
+    printf("%-14s %10s\n", "action", "bytes");
+
+    led_controller_configure(2, 300, LED_STRIP_TYPE_WS2812B);
+
+    const bench_message_t *worst = NULL;
+    size_t worst_depth = 0;
+    for (size_t m = 0; m < sizeof(bench_messages) / sizeof(bench_messages[0]); m++)
+    {
+        bench_stack_report(&bench_messages[m], &worst, &worst_depth);
+    }
+    for (size_t m = 0; m < sizeof(bench_stack_messages) / sizeof(bench_stack_messages[0]); m++)
+    {
+        bench_stack_report(&bench_stack_messages[m], &worst, &worst_depth);
+    }
+
+    printf("pior caso: %s %zu bytes (teto %d)\n", worst ? worst->name : "-", worst_depth, BENCH_STACK_BUDGET);
+    return worst_depth <= BENCH_STACK_BUDGET;
+}
+
+int main(int argc, char **argv)
+{
+    int scale = (argc > 1) ? atoi(argv[1]) : 1;
+    if (scale <= 0)
+    {
+        scale = 1;
+    }
+
+    // Logs desligados: o custo de formatação no host não representa a UART.
+    host_log_level = ESP_LOG_NONE;
+
+    if (!led_controller_start())
+    {
+        fprintf(stderr, "led_controller_start failed\n");
+        return 1;
+    }
+
+    bench_dispatch(scale);
+    bench_tx_burst(scale);
+    bench_mac_parser(scale);
+    bench_command_auth(scale);
+    bench_wol_packet(scale);
+    bench_wol_verify(scale);
+    bench_stream(scale);
+    bench_timeline(scale);
+    bench_effects_fps(scale);
+    bench_output_stage(scale);
+    bench_parallel_outputs(scale);
+    bench_backends(scale, (argc > 2) ? argv[2] : NULL);
+    bool stack_ok = bench_stack_depth();
+
+    printf("\nstub totals: ws_frames=%u ws_bytes=%u wol_packets=%u strip_refreshes=%u\n",
+           host_ws_sent_frames(), host_ws_sent_bytes(), host_wol_sent_packets(), host_led_strip_refresh_count());
+    return stack_ok ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+#include "led_backend_record.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_timer.h"
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+typedef struct
+{
+    int pin;
+    int count;
+    int bytes_per_pixel;
+    uint8_t *pixels; // ordem da linha (GRB/GRBW)
+} led_record_t;
+
+static FILE *record_file = NULL;
+static uint32_t record_frames = 0;
+static uint32_t record_checksum = FNV_OFFSET;
+
+bool led_backend_record_open(const char *path)
+{
+    led_backend_record_close();
+    record_file = fopen(path, "wb");
+    return record_file != NULL;
+}
+
+void led_backend_record_close(void)
+{
+    if (record_file)
+    {
+        fclose(record_file);
+        record_file = NULL;
+    }
+}
+
+uint32_t led_backend_record_frames(void)
+{
+    return record_frames;
+}
+
+uint32_t led_backend_record_checksum(void)
+{
+    return record_checksum;
+}
+
+static esp_err_t record_init(const led_output_config_t *output, int instances, void **ctx)
+{
+    led_record_t *record = calloc(1, sizeof(*record));
+    if (!record)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    record->pin = output->pin;
+    record->count = output->count;
+    record->bytes_per_pixel = (output->type == LED_STRIP_TYPE_SK6812) ? 4 : 3;
+    record->pixels = calloc((size_t)output->count, (size_t)record->bytes_per_pixel);
+    if (!record->pixels)
+    {
+        free(record);
+        return ESP_ERR_NO_MEM;
+    }
+
+    *ctx = record;
+    return ESP_OK;
+}
+
+static esp_err_t record_write(void *ctx, int first, const uint32_t *pixels, int count)
+{
+    led_record_t *record = ctx;
+    if (first < 0 || count < 0 || first + count > record->count)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t *out = record->pixels + (size_t)first * record->bytes_per_pixel;
+    for (int i = 0; i < count; i++, out += record->bytes_per_pixel)
+    {
+        uint32_t px = pixels[i];
+        out[0] = (uint8_t)(px >> 8);
+        out[1] = (uint8_t)px;
+        out[2] = (uint8_t)(px >> 16);
+        if (record->bytes_per_pixel == 4)
+        {
+            out[3] = (uint8_t)(px >> 24);
+        }
+    }
+    return ESP_OK;
+}
+
+static void put_le(uint8_t *out, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static esp_err_t record_flush(void *ctx)
+{
+    led_record_t *record = ctx;
+    size_t len = (size_t)record->count * record->bytes_per_pixel;
+    for (size_t i = 0; i < len; i++)
+    {
+        record_checksum = (record_checksum ^ record->pixels[i]) * FNV_PRIME;
+    }
+    record_frames++;
+
+    if (!record_file)
+    {
+        return ESP_OK;
+    }
+
+    uint8_t header[12];
+    put_le(header, (uint64_t)esp_timer_get_time(), 8);
+    header[8] = (uint8_t)record->pin;
+    header[9] = (uint8_t)record->bytes_per_pixel;
+    put_le(header + 10, (uint64_t)record->count, 2);
+    if (fwrite(header, sizeof(header), 1, record_file) != 1 || fwrite(record->pixels, 1, len, record_file) != len)
+    {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t record_wait_done(void *ctx)
+{
+    return ESP_OK;
+}
+
+static void record_deinit(void *ctx)
+{
+    led_record_t *record = ctx;
+    free(record->pixels);
+    free(record);
+}
+
+const led_backend_t led_backend_record = {
+    .name = "record",
+    .init = record_init,
+    .write = record_write,
+    .flush = record_flush,
+    .wait_done = record_wait_done,
+    .deinit = record_deinit,
+};
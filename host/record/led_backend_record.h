@@ -0,0 +1,31 @@
+#ifndef LED_BACKEND_RECORD_H
+#define LED_BACKEND_RECORD_H
+
+// Backend de gravação (só no host): cada flush grava o frame da saída, com
+// timestamp, num arquivo. Serve para frames de referência ("golden") e para
+// comparar o custo dos encoders sem hardware.
+//
+// Formato do arquivo, um registro por flush (inteiros little-endian):
+//   int64  timestamp_us   (esp_timer_get_time no flush)
+//   uint8  pin
+//   uint8  bytes_per_pixel (3 = GRB, 4 = GRBW)
+//   uint16 count
+//   count * bytes_per_pixel bytes de pixels, na ordem da linha
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "led_backend.h"
+
+extern const led_backend_t led_backend_record;
+
+// Abre (trunca) o arquivo de gravação. Sem arquivo aberto, os frames só são
+// contados e entram no checksum.
+bool led_backend_record_open(const char *path);
+void led_backend_record_close(void);
+uint32_t led_backend_record_frames(void);
+// FNV-1a de todos os frames gravados (pixels, sem timestamp): compara duas
+// execuções sem precisar guardar os arquivos.
+uint32_t led_backend_record_checksum(void);
+
+#endif
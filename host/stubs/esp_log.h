@@ -0,0 +1,39 @@
+#ifndef ESP_LOG_H
+#define ESP_LOG_H
+
+// Stub de host: os logs vão para stderr, filtrados por host_log_level
+// (padrão: só erros, para não distorcer os benchmarks).
+
+#include "esp_err.h"
+
+typedef enum
+{
+    ESP_LOG_NONE = 0,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+extern esp_log_level_t host_log_level;
+
+void host_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define HOST_LOG(level, tag, format, ...)                            \
+    do                                                               \
+    {                                                                \
+        if ((level) <= host_log_level)                               \
+        {                                                            \
+            host_log_write((level), (tag), (format), ##__VA_ARGS__); \
+        }                                                            \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...) HOST_LOG(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) HOST_LOG(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) HOST_LOG(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) HOST_LOG(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) HOST_LOG(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef ESP_WEBSOCKET_CLIENT_H
+#define ESP_WEBSOCKET_CLIENT_H
+
+// Stub de host do componente espressif/esp_websocket_client: os envios são
+// gravados (contagem, bytes e último payload) em vez de irem para a rede.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef struct esp_websocket_client *esp_websocket_client_handle_t;
+
+int esp_websocket_client_send_text(esp_websocket_client_handle_t client, const char *data, int len, TickType_t timeout);
+int esp_websocket_client_send_bin(esp_websocket_client_handle_t client, const char *data, int len, TickType_t timeout);
+bool esp_websocket_client_is_connected(esp_websocket_client_handle_t client);
+
+#endif
@@ -0,0 +1,60 @@
+#include <string.h>
+
+#include "esp_websocket_client.h"
+#include "host_stubs.h"
+
+#define HOST_WS_LAST_MAX 1024
+
+static uint32_t host_ws_frames = 0;
+static uint32_t host_ws_bytes = 0;
+static char host_ws_last[HOST_WS_LAST_MAX + 1];
+static int host_ws_last_len = 0;
+
+static int host_ws_record(const char *data, int len)
+{
+    if (!data || len < 0)
+    {
+        return -1;
+    }
+
+    host_ws_frames++;
+    host_ws_bytes += (uint32_t)len;
+    host_ws_last_len = (len > HOST_WS_LAST_MAX) ? HOST_WS_LAST_MAX : len;
+    memcpy(host_ws_last, data, host_ws_last_len);
+    host_ws_last[host_ws_last_len] = 0;
+    return len;
+}
+
+int esp_websocket_client_send_text(esp_websocket_client_handle_t client, const char *data, int len, TickType_t timeout)
+{
+    return host_ws_record(data, len);
+}
+
+int esp_websocket_client_send_bin(esp_websocket_client_handle_t client, const char *data, int len, TickType_t timeout)
+{
+    return host_ws_record(data, len);
+}
+
+bool esp_websocket_client_is_connected(esp_websocket_client_handle_t client)
+{
+    return client != NULL;
+}
+
+uint32_t host_ws_sent_frames(void)
+{
+    return host_ws_frames;
+}
+
+uint32_t host_ws_sent_bytes(void)
+{
+    return host_ws_bytes;
+}
+
+const char *host_ws_last_sent(int *len)
+{
+    if (len)
+    {
+        *len = host_ws_last_len;
+    }
+    return host_ws_last;
+}
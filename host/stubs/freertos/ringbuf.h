@@ -0,0 +1,23 @@
+#ifndef FREERTOS_RINGBUF_H
+#define FREERTOS_RINGBUF_H
+
+// Stub de host: ring buffer NOSPLIT com orçamento de bytes igual ao do IDF
+// (cabeçalho de 8 bytes por item, alinhado a 4). Não bloqueia: timeouts são
+// ignorados e os itens recebidos devem ser devolvidos em ordem.
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_ringbuf *RingbufHandle_t;
+
+typedef enum
+{
+    RINGBUF_TYPE_NOSPLIT = 0,
+} RingbufferType_t;
+
+RingbufHandle_t xRingbufferCreate(size_t buffer_size, RingbufferType_t type);
+BaseType_t xRingbufferSendAcquire(RingbufHandle_t ringbuf, void **item, size_t item_size, TickType_t ticks_to_wait);
+BaseType_t xRingbufferSendComplete(RingbufHandle_t ringbuf, void *item);
+void *xRingbufferReceive(RingbufHandle_t ringbuf, size_t *item_size, TickType_t ticks_to_wait);
+void vRingbufferReturnItem(RingbufHandle_t ringbuf, void *item);
+
+#endif
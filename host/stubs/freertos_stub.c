@@ -0,0 +1,139 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "host_stubs.h"
+
+#define HOST_MAX_QUEUES 8
+
+struct host_queue
+{
+    uint8_t *items;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+static QueueHandle_t host_queues[HOST_MAX_QUEUES];
+static int host_queue_total = 0;
+static int host_tasks_created = 0;
+static uint8_t host_task_handles[16]; // handles distintos e não nulos
+static uint32_t host_task_notifications = 0;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack_depth,
+                                   void *params, UBaseType_t priority, TaskHandle_t *handle, BaseType_t core_id)
+{
+    if (handle)
+    {
+        *handle = &host_task_handles[host_tasks_created % sizeof(host_task_handles)];
+    }
+    host_tasks_created++;
+    return pdPASS;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    if (!task)
+    {
+        return pdFALSE;
+    }
+    host_task_notifications++;
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t bits_to_clear_on_entry, uint32_t bits_to_clear_on_exit,
+                           uint32_t *notification_value, TickType_t ticks_to_wait)
+{
+    if (notification_value)
+    {
+        *notification_value = 0;
+    }
+    return pdFALSE;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec ts = {
+        .tv_sec = ticks / configTICK_RATE_HZ,
+        .tv_nsec = (long)(ticks % configTICK_RATE_HZ) * (1000000000L / configTICK_RATE_HZ),
+    };
+    nanosleep(&ts, NULL);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(host_now_us() / (1000000 / configTICK_RATE_HZ));
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    if (host_queue_total >= HOST_MAX_QUEUES || length == 0 || item_size == 0)
+    {
+        return NULL;
+    }
+
+    QueueHandle_t queue = calloc(1, sizeof(*queue));
+    if (!queue)
+    {
+        return NULL;
+    }
+
+    queue->items = calloc(length, item_size);
+    if (!queue->items)
+    {
+        free(queue);
+        return NULL;
+    }
+
+    queue->length = length;
+    queue->item_size = item_size;
+    host_queues[host_queue_total++] = queue;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    if (!queue || queue->count == queue->length)
+    {
+        return pdFALSE;
+    }
+
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->items + tail * queue->item_size, item, queue->item_size);
+    queue->count++;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    if (!queue || queue->count == 0)
+    {
+        return pdFALSE;
+    }
+
+    memcpy(item, queue->items + queue->head * queue->item_size, queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    return pdTRUE;
+}
+
+int host_freertos_tasks_created(void)
+{
+    return host_tasks_created;
+}
+
+uint32_t host_freertos_task_notifications(void)
+{
+    return host_task_notifications;
+}
+
+int64_t host_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
@@ -0,0 +1,51 @@
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+// Introspecção dos stubs de host, usada pelos benchmarks.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+int64_t host_now_us(void);
+
+int host_freertos_tasks_created(void);
+uint32_t host_freertos_task_notifications(void);
+
+uint32_t host_led_strip_refresh_count(void);
+uint32_t host_led_strip_pixel_writes(void);
+const uint8_t *host_led_strip_pixels(void);
+
+// Mock do backend RMT: cada canal registra o tempo de linha das transmissões
+// (WS2812: 1,25 µs por bit + reset). host_led_strip_wire_us é o relógio
+// simulado da linha: só avança ao esperar por uma transmissão, então canais
+// disparados juntos custam o tempo do mais longo.
+typedef struct
+{
+    int gpio;
+    uint32_t leds;
+    uint32_t refreshes;
+    uint32_t last_tx_us;
+    uint64_t total_tx_us;
+    int64_t last_start_us;
+} host_led_channel_stats_t;
+
+int64_t host_led_strip_wire_us(void);
+bool host_led_strip_channel_stats(int channel, host_led_channel_stats_t *stats);
+// Usados pelos stubs de transporte: início de uma transmissão de tx_us no
+// relógio da linha (devolve o fim) e espera até end_us.
+int64_t host_led_wire_start(uint32_t tx_us);
+void host_led_wire_wait(int64_t end_us);
+
+uint32_t host_spi_transaction_count(void);
+uint64_t host_spi_tx_bytes(void);
+const uint8_t *host_spi_last_transmission(size_t *len);
+
+uint32_t host_ws_sent_frames(void);
+uint32_t host_ws_sent_bytes(void);
+const char *host_ws_last_sent(int *len);
+
+uint32_t host_wol_sent_packets(void);
+const uint8_t *host_wol_last_packet_data(int *len);
+
+#endif
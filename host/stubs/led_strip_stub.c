@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "led_strip.h"
+#include "host_stubs.h"
+
+// Canais RMT de TX disponíveis (ESP32: 8).
+#define HOST_RMT_CHANNELS 8
+// Tempo de linha do WS2812/SK6812: 1,25 µs por bit e reset de 50 µs no fim.
+#define HOST_STRIP_NS_PER_BIT 1250
+#define HOST_STRIP_RESET_US 50
+
+struct led_strip_t
+{
+    uint8_t *pixels;
+    uint32_t max_leds;
+    uint32_t bytes_per_pixel;
+    int channel;
+    int gpio;
+    bool in_flight;
+    int64_t tx_end_us; // no relógio simulado da linha
+};
+
+typedef struct
+{
+    led_strip_handle_t strip;
+    host_led_channel_stats_t stats;
+} host_rmt_channel_t;
+
+static uint32_t host_refresh_count = 0;
+static uint32_t host_pixel_writes = 0;
+static led_strip_handle_t host_last_strip = NULL;
+static host_rmt_channel_t host_channels[HOST_RMT_CHANNELS];
+// Relógio simulado da linha (compartilhado com o stub de SPI): transmissões
+// disparadas juntas começam no mesmo instante, e esperar por uma avança o
+// relógio até o fim dela. Refresh síncrono em série soma os tempos; async +
+// espera conjunta fica no maior.
+static int64_t host_wire_us = 0;
+
+int64_t host_led_wire_start(uint32_t tx_us)
+{
+    return host_wire_us + tx_us;
+}
+
+void host_led_wire_wait(int64_t end_us)
+{
+    if (end_us > host_wire_us)
+    {
+        host_wire_us = end_us;
+    }
+}
+
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config,
+                                   led_strip_handle_t *ret_strip)
+{
+    if (!led_config || !ret_strip || led_config->max_leds == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int channel = -1;
+    for (int i = HOST_RMT_CHANNELS - 1; i >= 0; i--)
+    {
+        if (!host_channels[i].strip)
+        {
+            channel = i;
+        }
+        else if (host_channels[i].strip->gpio == led_config->strip_gpio_num)
+        {
+            return ESP_ERR_INVALID_ARG; // GPIO já usado por outro canal
+        }
+    }
+    if (channel < 0)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    led_strip_handle_t strip = calloc(1, sizeof(*strip));
+    if (!strip)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    strip->bytes_per_pixel = led_config->color_component_format.num_components;
+    strip->max_leds = led_config->max_leds;
+    strip->pixels = calloc(strip->max_leds, strip->bytes_per_pixel);
+    if (!strip->pixels)
+    {
+        free(strip);
+        return ESP_ERR_NO_MEM;
+    }
+    strip->channel = channel;
+    strip->gpio = led_config->strip_gpio_num;
+
+    host_channels[channel].strip = strip;
+    memset(&host_channels[channel].stats, 0, sizeof(host_channels[channel].stats));
+    host_channels[channel].stats.gpio = strip->gpio;
+    host_channels[channel].stats.leds = strip->max_leds;
+
+    host_last_strip = strip;
+    *ret_strip = strip;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    if (!strip || index >= strip->max_leds)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t *pixel = strip->pixels + index * strip->bytes_per_pixel;
+    pixel[0] = (uint8_t)green;
+    pixel[1] = (uint8_t)red;
+    pixel[2] = (uint8_t)blue;
+    host_pixel_writes++;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_set_pixel_rgbw(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green,
+                                   uint32_t blue, uint32_t white)
+{
+    if (!strip || index >= strip->max_leds || strip->bytes_per_pixel != 4)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t *pixel = strip->pixels + index * strip->bytes_per_pixel;
+    pixel[0] = (uint8_t)green;
+    pixel[1] = (uint8_t)red;
+    pixel[2] = (uint8_t)blue;
+    pixel[3] = (uint8_t)white;
+    host_pixel_writes++;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_refresh_async(led_strip_handle_t strip)
+{
+    if (!strip)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (strip->in_flight)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint32_t bits = strip->max_leds * strip->bytes_per_pixel * 8;
+    uint32_t tx_us = (uint32_t)(((uint64_t)bits * HOST_STRIP_NS_PER_BIT) / 1000) + HOST_STRIP_RESET_US;
+    strip->in_flight = true;
+    strip->tx_end_us = host_led_wire_start(tx_us);
+
+    host_led_channel_stats_t *stats = &host_channels[strip->channel].stats;
+    stats->last_start_us = host_wire_us;
+    stats->refreshes++;
+    stats->last_tx_us = tx_us;
+    stats->total_tx_us += tx_us;
+    host_refresh_count++;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_refresh_wait_done(led_strip_handle_t strip)
+{
+    if (!strip)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (strip->in_flight)
+    {
+        host_led_wire_wait(strip->tx_end_us);
+        strip->in_flight = false;
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_refresh(led_strip_handle_t strip)
+{
+    esp_err_t err = led_strip_refresh_async(strip);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    return led_strip_refresh_wait_done(strip);
+}
+
+esp_err_t led_strip_clear(led_strip_handle_t strip)
+{
+    if (!strip)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(strip->pixels, 0, strip->max_leds * strip->bytes_per_pixel);
+    return led_strip_refresh(strip);
+}
+
+esp_err_t led_strip_del(led_strip_handle_t strip)
+{
+    if (!strip)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (host_last_strip == strip)
+    {
+        host_last_strip = NULL;
+    }
+    host_channels[strip->channel].strip = NULL;
+    free(strip->pixels);
+    free(strip);
+    return ESP_OK;
+}
+
+uint32_t host_led_strip_refresh_count(void)
+{
+    return host_refresh_count;
+}
+
+uint32_t host_led_strip_pixel_writes(void)
+{
+    return host_pixel_writes;
+}
+
+const uint8_t *host_led_strip_pixels(void)
+{
+    return host_last_strip ? host_last_strip->pixels : NULL;
+}
+
+int64_t host_led_strip_wire_us(void)
+{
+    return host_wire_us;
+}
+
+bool host_led_strip_channel_stats(int channel, host_led_channel_stats_t *stats)
+{
+    if (channel < 0 || channel >= HOST_RMT_CHANNELS || !host_channels[channel].strip || !stats)
+    {
+        return false;
+    }
+
+    *stats = host_channels[channel].stats;
+    return true;
+}
@@ -0,0 +1,8 @@
+#ifndef LWIP_INET_H
+#define LWIP_INET_H
+
+// Stub de host: inet_pton/inet_ntop e htons/htonl do sistema.
+
+#include <arpa/inet.h>
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef LWIP_SOCKETS_H
+#define LWIP_SOCKETS_H
+
+// Stub de host: a API de sockets do lwIP segue a BSD, então o build de host
+// usa os sockets do sistema (as sondas do wol_probe rodam de verdade).
+
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif
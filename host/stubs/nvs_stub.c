@@ -0,0 +1,136 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvs.h"
+
+// Poucas entradas, procuradas por (namespace, chave).
+#define HOST_NVS_MAX_ENTRIES 8
+#define HOST_NVS_MAX_NAMESPACES 4
+#define HOST_NVS_NAME_LEN 16
+
+typedef struct
+{
+    char ns[HOST_NVS_NAME_LEN];
+    char key[HOST_NVS_NAME_LEN];
+    void *data;
+    size_t len;
+} host_nvs_entry_t;
+
+static host_nvs_entry_t host_nvs_entries[HOST_NVS_MAX_ENTRIES];
+// O handle é o índice do namespace + 1.
+static char host_nvs_namespaces[HOST_NVS_MAX_NAMESPACES][HOST_NVS_NAME_LEN];
+
+static host_nvs_entry_t *entry_find(nvs_handle_t handle, const char *key)
+{
+    if (handle == 0 || handle > HOST_NVS_MAX_NAMESPACES || !key)
+    {
+        return NULL;
+    }
+    const char *ns = host_nvs_namespaces[handle - 1];
+    for (int i = 0; i < HOST_NVS_MAX_ENTRIES; i++)
+    {
+        host_nvs_entry_t *entry = &host_nvs_entries[i];
+        if (entry->data && strcmp(entry->ns, ns) == 0 && strcmp(entry->key, key) == 0)
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (!namespace_name || strlen(namespace_name) >= HOST_NVS_NAME_LEN || !out_handle)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < HOST_NVS_MAX_NAMESPACES; i++)
+    {
+        if (host_nvs_namespaces[i][0] == '\0')
+        {
+            strcpy(host_nvs_namespaces[i], namespace_name);
+        }
+        if (strcmp(host_nvs_namespaces[i], namespace_name) == 0)
+        {
+            *out_handle = (nvs_handle_t)(i + 1);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    host_nvs_entry_t *entry = entry_find(handle, key);
+    if (!entry)
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (!out_value)
+    {
+        *length = entry->len;
+        return ESP_OK;
+    }
+    if (*length < entry->len)
+    {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out_value, entry->data, entry->len);
+    *length = entry->len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    if (handle == 0 || handle > HOST_NVS_MAX_NAMESPACES || !key || strlen(key) >= HOST_NVS_NAME_LEN)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_nvs_entry_t *entry = entry_find(handle, key);
+    for (int i = 0; !entry && i < HOST_NVS_MAX_ENTRIES; i++)
+    {
+        if (!host_nvs_entries[i].data)
+        {
+            entry = &host_nvs_entries[i];
+            strcpy(entry->ns, host_nvs_namespaces[handle - 1]);
+            strcpy(entry->key, key);
+        }
+    }
+    if (!entry)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    void *data = malloc(length ? length : 1);
+    if (!data)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(data, value, length);
+    free(entry->data);
+    entry->data = data;
+    entry->len = length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    host_nvs_entry_t *entry = entry_find(handle, key);
+    if (!entry)
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    free(entry->data);
+    memset(entry, 0, sizeof(*entry));
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+}
@@ -0,0 +1,94 @@
+#ifndef PSA_CRYPTO_H
+#define PSA_CRYPTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Stub de host: subconjunto da API PSA usado pelo firmware (só HMAC-SHA256),
+// com SHA-256 de verdade para o benchmark medir o custo real do MAC.
+// Chaves só voláteis, em memória.
+
+typedef int32_t psa_status_t;
+typedef uint32_t psa_algorithm_t;
+typedef uint16_t psa_key_type_t;
+typedef uint32_t psa_key_usage_t;
+typedef uint32_t psa_key_id_t;
+
+#define PSA_SUCCESS ((psa_status_t)0)
+#define PSA_ERROR_NOT_SUPPORTED ((psa_status_t)-134)
+#define PSA_ERROR_NOT_PERMITTED ((psa_status_t)-133)
+#define PSA_ERROR_BUFFER_TOO_SMALL ((psa_status_t)-138)
+#define PSA_ERROR_BAD_STATE ((psa_status_t)-137)
+#define PSA_ERROR_INVALID_ARGUMENT ((psa_status_t)-135)
+#define PSA_ERROR_INSUFFICIENT_MEMORY ((psa_status_t)-141)
+#define PSA_ERROR_INVALID_SIGNATURE ((psa_status_t)-149)
+#define PSA_ERROR_INVALID_HANDLE ((psa_status_t)-136)
+
+#define PSA_KEY_TYPE_HMAC ((psa_key_type_t)0x1100)
+#define PSA_KEY_USAGE_SIGN_MESSAGE ((psa_key_usage_t)0x00000400)
+#define PSA_KEY_USAGE_VERIFY_MESSAGE ((psa_key_usage_t)0x00000800)
+
+#define PSA_ALG_SHA_256 ((psa_algorithm_t)0x02000009)
+#define PSA_ALG_HMAC(hash_alg) ((psa_algorithm_t)(0x03800000 | ((hash_alg) & 0x000000ff)))
+#define PSA_MAC_TRUNCATION_MASK ((psa_algorithm_t)0x003f0000)
+#define PSA_MAC_AT_LEAST_FLAG ((psa_algorithm_t)0x00008000)
+#define PSA_ALG_TRUNCATED_MAC(mac_alg, mac_length)                                                                     \
+    ((psa_algorithm_t)(((mac_alg) & ~(PSA_MAC_TRUNCATION_MASK | PSA_MAC_AT_LEAST_FLAG)) |                              \
+                       (((psa_algorithm_t)(mac_length) << 16) & PSA_MAC_TRUNCATION_MASK)))
+#define PSA_ALG_AT_LEAST_THIS_LENGTH_MAC(mac_alg, min_mac_length)                                                      \
+    ((psa_algorithm_t)(PSA_ALG_TRUNCATED_MAC(mac_alg, min_mac_length) | PSA_MAC_AT_LEAST_FLAG))
+
+typedef struct
+{
+    psa_key_type_t type;
+    psa_key_usage_t usage;
+    psa_algorithm_t alg;
+} psa_key_attributes_t;
+
+#define PSA_KEY_ATTRIBUTES_INIT {0}
+
+static inline void psa_set_key_usage_flags(psa_key_attributes_t *attributes, psa_key_usage_t usage)
+{
+    attributes->usage = usage;
+}
+
+static inline void psa_set_key_algorithm(psa_key_attributes_t *attributes, psa_algorithm_t alg)
+{
+    attributes->alg = alg;
+}
+
+static inline void psa_set_key_type(psa_key_attributes_t *attributes, psa_key_type_t type)
+{
+    attributes->type = type;
+}
+
+typedef struct
+{
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t block[64];
+    uint32_t block_len;
+} host_sha256_t;
+
+typedef struct
+{
+    psa_key_id_t key;
+    uint32_t mac_len; // 0 = operação inativa
+    host_sha256_t inner;
+    uint8_t outer_pad[64];
+} psa_mac_operation_t;
+
+#define PSA_MAC_OPERATION_INIT {0}
+
+psa_status_t psa_crypto_init(void);
+psa_status_t psa_import_key(const psa_key_attributes_t *attributes, const uint8_t *data, size_t data_length,
+                            psa_key_id_t *key);
+psa_status_t psa_destroy_key(psa_key_id_t key);
+psa_status_t psa_mac_compute(psa_key_id_t key, psa_algorithm_t alg, const uint8_t *input, size_t input_length,
+                             uint8_t *mac, size_t mac_size, size_t *mac_length);
+psa_status_t psa_mac_verify_setup(psa_mac_operation_t *operation, psa_key_id_t key, psa_algorithm_t alg);
+psa_status_t psa_mac_update(psa_mac_operation_t *operation, const uint8_t *input, size_t input_length);
+psa_status_t psa_mac_verify_finish(psa_mac_operation_t *operation, const uint8_t *mac, size_t mac_length);
+psa_status_t psa_mac_abort(psa_mac_operation_t *operation);
+
+#endif
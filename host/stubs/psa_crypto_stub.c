@@ -0,0 +1,311 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "psa/crypto.h"
+
+#define HOST_PSA_MAX_KEYS 4
+#define HOST_SHA256_BLOCK 64
+#define HOST_SHA256_LEN 32
+
+typedef struct
+{
+    psa_key_attributes_t attributes;
+    uint8_t data[HOST_SHA256_BLOCK]; // chave já no tamanho do bloco (HMAC)
+    size_t length;
+    int used;
+} host_psa_key_t;
+
+// O id da chave é o índice + 1.
+static host_psa_key_t host_psa_keys[HOST_PSA_MAX_KEYS];
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_block(host_sha256_t *ctx, const uint8_t *block)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 | (uint32_t)block[i * 4 + 2] << 8 |
+               block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+    uint32_t e = ctx->state[4], f = ctx->state[5], g = ctx->state[6], h = ctx->state[7];
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+    ctx->state[5] += f;
+    ctx->state[6] += g;
+    ctx->state[7] += h;
+}
+
+static void sha256_init(host_sha256_t *ctx)
+{
+    static const uint32_t initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    memcpy(ctx->state, initial, sizeof(initial));
+    ctx->length = 0;
+    ctx->block_len = 0;
+}
+
+static void sha256_update(host_sha256_t *ctx, const uint8_t *data, size_t len)
+{
+    ctx->length += len;
+    while (len > 0)
+    {
+        size_t take = HOST_SHA256_BLOCK - ctx->block_len;
+        if (take > len)
+        {
+            take = len;
+        }
+        memcpy(ctx->block + ctx->block_len, data, take);
+        ctx->block_len += (uint32_t)take;
+        data += take;
+        len -= take;
+        if (ctx->block_len == HOST_SHA256_BLOCK)
+        {
+            sha256_block(ctx, ctx->block);
+            ctx->block_len = 0;
+        }
+    }
+}
+
+static void sha256_finish(host_sha256_t *ctx, uint8_t *out)
+{
+    uint64_t bits = ctx->length * 8;
+    uint8_t pad = 0x80;
+    sha256_update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->block_len != HOST_SHA256_BLOCK - 8)
+    {
+        sha256_update(ctx, &pad, 1);
+    }
+    uint8_t length[8];
+    for (int i = 0; i < 8; i++)
+    {
+        length[i] = (uint8_t)(bits >> (56 - i * 8));
+    }
+    sha256_update(ctx, length, sizeof(length));
+    for (int i = 0; i < 8; i++)
+    {
+        out[i * 4] = (uint8_t)(ctx->state[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)ctx->state[i];
+    }
+}
+
+psa_status_t psa_crypto_init(void)
+{
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_import_key(const psa_key_attributes_t *attributes, const uint8_t *data, size_t data_length,
+                            psa_key_id_t *key)
+{
+    if (!attributes || attributes->type != PSA_KEY_TYPE_HMAC || !data || data_length == 0 || !key)
+    {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (int i = 0; i < HOST_PSA_MAX_KEYS; i++)
+    {
+        host_psa_key_t *slot = &host_psa_keys[i];
+        if (slot->used)
+        {
+            continue;
+        }
+        memset(slot, 0, sizeof(*slot));
+        slot->attributes = *attributes;
+        if (data_length > HOST_SHA256_BLOCK)
+        {
+            host_sha256_t ctx;
+            sha256_init(&ctx);
+            sha256_update(&ctx, data, data_length);
+            sha256_finish(&ctx, slot->data);
+            slot->length = HOST_SHA256_LEN;
+        }
+        else
+        {
+            memcpy(slot->data, data, data_length);
+            slot->length = data_length;
+        }
+        slot->used = 1;
+        *key = (psa_key_id_t)(i + 1);
+        return PSA_SUCCESS;
+    }
+    return PSA_ERROR_INSUFFICIENT_MEMORY;
+}
+
+psa_status_t psa_destroy_key(psa_key_id_t key)
+{
+    if (key == 0)
+    {
+        return PSA_SUCCESS;
+    }
+    if (key > HOST_PSA_MAX_KEYS || !host_psa_keys[key - 1].used)
+    {
+        return PSA_ERROR_INVALID_HANDLE;
+    }
+    memset(&host_psa_keys[key - 1], 0, sizeof(host_psa_keys[0]));
+    return PSA_SUCCESS;
+}
+
+// Tamanho do MAC pedido por alg, se a política da chave permite (0 = negado).
+static uint32_t mac_length_for(const host_psa_key_t *slot, psa_algorithm_t alg, psa_key_usage_t usage)
+{
+    psa_algorithm_t base = alg & ~(PSA_MAC_TRUNCATION_MASK | PSA_MAC_AT_LEAST_FLAG);
+    psa_algorithm_t policy = slot->attributes.alg;
+    if (base != PSA_ALG_HMAC(PSA_ALG_SHA_256) || !(slot->attributes.usage & usage) ||
+        base != (policy & ~(PSA_MAC_TRUNCATION_MASK | PSA_MAC_AT_LEAST_FLAG)))
+    {
+        return 0;
+    }
+
+    uint32_t length = (alg & PSA_MAC_TRUNCATION_MASK) >> 16;
+    uint32_t policy_length = (policy & PSA_MAC_TRUNCATION_MASK) >> 16;
+    length = length ? length : HOST_SHA256_LEN;
+    policy_length = policy_length ? policy_length : HOST_SHA256_LEN;
+    bool allowed = (policy & PSA_MAC_AT_LEAST_FLAG) ? length >= policy_length : length == policy_length;
+    return (allowed && length <= HOST_SHA256_LEN) ? length : 0;
+}
+
+static psa_status_t mac_setup(psa_mac_operation_t *operation, psa_key_id_t key, psa_algorithm_t alg,
+                              psa_key_usage_t usage)
+{
+    if (!operation || operation->mac_len != 0)
+    {
+        return PSA_ERROR_BAD_STATE;
+    }
+    if (key == 0 || key > HOST_PSA_MAX_KEYS || !host_psa_keys[key - 1].used)
+    {
+        return PSA_ERROR_INVALID_HANDLE;
+    }
+
+    const host_psa_key_t *slot = &host_psa_keys[key - 1];
+    uint32_t mac_len = mac_length_for(slot, alg, usage);
+    if (mac_len == 0)
+    {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    uint8_t pad[HOST_SHA256_BLOCK] = {0};
+    memcpy(pad, slot->data, slot->length);
+    for (int i = 0; i < HOST_SHA256_BLOCK; i++)
+    {
+        operation->outer_pad[i] = pad[i] ^ 0x5c;
+        pad[i] ^= 0x36;
+    }
+    sha256_init(&operation->inner);
+    sha256_update(&operation->inner, pad, sizeof(pad));
+    operation->key = key;
+    operation->mac_len = mac_len;
+    return PSA_SUCCESS;
+}
+
+static void mac_finish(psa_mac_operation_t *operation, uint8_t *mac)
+{
+    uint8_t inner[HOST_SHA256_LEN];
+    sha256_finish(&operation->inner, inner);
+    host_sha256_t outer;
+    sha256_init(&outer);
+    sha256_update(&outer, operation->outer_pad, sizeof(operation->outer_pad));
+    sha256_update(&outer, inner, sizeof(inner));
+    sha256_finish(&outer, mac);
+}
+
+psa_status_t psa_mac_compute(psa_key_id_t key, psa_algorithm_t alg, const uint8_t *input, size_t input_length,
+                             uint8_t *mac, size_t mac_size, size_t *mac_length)
+{
+    psa_mac_operation_t operation = PSA_MAC_OPERATION_INIT;
+    psa_status_t status = mac_setup(&operation, key, alg, PSA_KEY_USAGE_SIGN_MESSAGE);
+    if (status != PSA_SUCCESS)
+    {
+        return status;
+    }
+    if (mac_size < operation.mac_len)
+    {
+        return PSA_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    uint8_t full[HOST_SHA256_LEN];
+    sha256_update(&operation.inner, input, input_length);
+    mac_finish(&operation, full);
+    memcpy(mac, full, operation.mac_len);
+    *mac_length = operation.mac_len;
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_mac_verify_setup(psa_mac_operation_t *operation, psa_key_id_t key, psa_algorithm_t alg)
+{
+    return mac_setup(operation, key, alg, PSA_KEY_USAGE_VERIFY_MESSAGE);
+}
+
+psa_status_t psa_mac_update(psa_mac_operation_t *operation, const uint8_t *input, size_t input_length)
+{
+    if (!operation || operation->mac_len == 0)
+    {
+        return PSA_ERROR_BAD_STATE;
+    }
+    sha256_update(&operation->inner, input, input_length);
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_mac_verify_finish(psa_mac_operation_t *operation, const uint8_t *mac, size_t mac_length)
+{
+    if (!operation || operation->mac_len == 0)
+    {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    uint8_t full[HOST_SHA256_LEN];
+    mac_finish(operation, full);
+    uint8_t diff = (mac_length != operation->mac_len);
+    for (uint32_t i = 0; i < operation->mac_len && i < mac_length; i++)
+    {
+        diff |= full[i] ^ mac[i];
+    }
+    psa_mac_abort(operation);
+    return diff ? PSA_ERROR_INVALID_SIGNATURE : PSA_SUCCESS;
+}
+
+psa_status_t psa_mac_abort(psa_mac_operation_t *operation)
+{
+    if (operation)
+    {
+        memset(operation, 0, sizeof(*operation));
+    }
+    return PSA_SUCCESS;
+}
@@ -0,0 +1,107 @@
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+
+#define HOST_RINGBUF_MAX_ITEMS 256
+#define HOST_RINGBUF_HEADER 8
+
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    bool complete;
+} host_ringbuf_item_t;
+
+struct host_ringbuf
+{
+    size_t capacity;
+    size_t used;
+    host_ringbuf_item_t items[HOST_RINGBUF_MAX_ITEMS];
+    int head;
+    int count;
+};
+
+static size_t host_ringbuf_cost(size_t size)
+{
+    return HOST_RINGBUF_HEADER + ((size + 3) & ~(size_t)3);
+}
+
+RingbufHandle_t xRingbufferCreate(size_t buffer_size, RingbufferType_t type)
+{
+    RingbufHandle_t ringbuf = calloc(1, sizeof(*ringbuf));
+    if (ringbuf)
+    {
+        ringbuf->capacity = buffer_size;
+    }
+    return ringbuf;
+}
+
+BaseType_t xRingbufferSendAcquire(RingbufHandle_t ringbuf, void **item, size_t item_size, TickType_t ticks_to_wait)
+{
+    if (!ringbuf || !item || ringbuf->count == HOST_RINGBUF_MAX_ITEMS ||
+        ringbuf->used + host_ringbuf_cost(item_size) > ringbuf->capacity)
+    {
+        return pdFALSE;
+    }
+
+    uint8_t *data = malloc(item_size ? item_size : 1);
+    if (!data)
+    {
+        return pdFALSE;
+    }
+
+    host_ringbuf_item_t *slot = &ringbuf->items[(ringbuf->head + ringbuf->count) % HOST_RINGBUF_MAX_ITEMS];
+    slot->data = data;
+    slot->size = item_size;
+    slot->complete = false;
+    ringbuf->count++;
+    ringbuf->used += host_ringbuf_cost(item_size);
+    *item = data;
+    return pdTRUE;
+}
+
+BaseType_t xRingbufferSendComplete(RingbufHandle_t ringbuf, void *item)
+{
+    for (int i = 0; ringbuf && i < ringbuf->count; i++)
+    {
+        host_ringbuf_item_t *slot = &ringbuf->items[(ringbuf->head + i) % HOST_RINGBUF_MAX_ITEMS];
+        if (slot->data == item)
+        {
+            slot->complete = true;
+            return pdTRUE;
+        }
+    }
+    return pdFALSE;
+}
+
+void *xRingbufferReceive(RingbufHandle_t ringbuf, size_t *item_size, TickType_t ticks_to_wait)
+{
+    if (!ringbuf || ringbuf->count == 0 || !ringbuf->items[ringbuf->head].complete)
+    {
+        return NULL;
+    }
+
+    host_ringbuf_item_t *slot = &ringbuf->items[ringbuf->head];
+    if (item_size)
+    {
+        *item_size = slot->size;
+    }
+    return slot->data;
+}
+
+void vRingbufferReturnItem(RingbufHandle_t ringbuf, void *item)
+{
+    if (!ringbuf || ringbuf->count == 0 || ringbuf->items[ringbuf->head].data != item)
+    {
+        return;
+    }
+
+    host_ringbuf_item_t *slot = &ringbuf->items[ringbuf->head];
+    ringbuf->used -= host_ringbuf_cost(slot->size);
+    free(slot->data);
+    slot->data = NULL;
+    ringbuf->head = (ringbuf->head + 1) % HOST_RINGBUF_MAX_ITEMS;
+    ringbuf->count--;
+}
@@ -0,0 +1,8 @@
+#ifndef SOC_SOC_CAPS_H
+#define SOC_SOC_CAPS_H
+
+// Stub de host: capacidades do ESP32 usadas pelo firmware.
+
+#define SOC_SPI_PERIPH_NUM 3
+
+#endif
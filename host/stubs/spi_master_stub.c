@@ -0,0 +1,143 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver/spi_master.h"
+#include "host_stubs.h"
+
+#define HOST_SPI_HOSTS 3
+
+struct host_spi_device
+{
+    spi_host_device_t host;
+    int clock_speed_hz;
+    spi_transaction_t *pending;
+    int64_t tx_end_us;
+};
+
+typedef struct
+{
+    bool initialized;
+    spi_device_handle_t device;
+} host_spi_bus_t;
+
+static host_spi_bus_t host_spi_buses[HOST_SPI_HOSTS];
+static uint32_t host_spi_transactions = 0;
+static uint64_t host_spi_bytes = 0;
+static const uint8_t *host_spi_last_tx = NULL;
+static size_t host_spi_last_len = 0;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *bus_config, int dma_chan)
+{
+    if (host <= SPI1_HOST || host >= HOST_SPI_HOSTS || !bus_config)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (host_spi_buses[host].initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    host_spi_buses[host].initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host)
+{
+    if (host >= HOST_SPI_HOSTS || !host_spi_buses[host].initialized || host_spi_buses[host].device)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    host_spi_buses[host].initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *dev_config,
+                             spi_device_handle_t *handle)
+{
+    if (host >= HOST_SPI_HOSTS || !host_spi_buses[host].initialized || !dev_config || !handle)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    spi_device_handle_t device = calloc(1, sizeof(*device));
+    if (!device)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    device->host = host;
+    device->clock_speed_hz = dev_config->clock_speed_hz;
+    host_spi_buses[host].device = device;
+    *handle = device;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle)
+{
+    if (!handle)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_spi_buses[handle->host].device = NULL;
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans, TickType_t ticks_to_wait)
+{
+    if (!handle || !trans || !trans->tx_buffer)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->pending)
+    {
+        return ESP_ERR_TIMEOUT; // queue_size = 1: a fila está cheia
+    }
+
+    uint32_t tx_us = (uint32_t)(((uint64_t)trans->length * 1000000) / (uint64_t)handle->clock_speed_hz);
+    handle->pending = trans;
+    handle->tx_end_us = host_led_wire_start(tx_us);
+    host_spi_transactions++;
+    host_spi_bytes += trans->length / 8;
+    host_spi_last_tx = trans->tx_buffer;
+    host_spi_last_len = trans->length / 8;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans,
+                                      TickType_t ticks_to_wait)
+{
+    if (!handle || !trans)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!handle->pending)
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    host_led_wire_wait(handle->tx_end_us);
+    *trans = handle->pending;
+    handle->pending = NULL;
+    return ESP_OK;
+}
+
+uint32_t host_spi_transaction_count(void)
+{
+    return host_spi_transactions;
+}
+
+uint64_t host_spi_tx_bytes(void)
+{
+    return host_spi_bytes;
+}
+
+const uint8_t *host_spi_last_transmission(size_t *len)
+{
+    if (len)
+    {
+        *len = host_spi_last_len;
+    }
+    return host_spi_last_tx;
+}
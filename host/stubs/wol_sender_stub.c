@@ -0,0 +1,85 @@
+#include <string.h>
+
+#include "wol_sender.h"
+#include "host_stubs.h"
+
+// Substitui o wol_sender do firmware: o pacote mágico é montado (pelo mesmo
+// cache) mas não sai do host; as cópias da rajada são só contadas.
+static wol_sender_stats_t host_wol_stats = {0};
+static uint8_t host_wol_last_packet[WOL_PACKET_MAX_LEN];
+static int host_wol_last_len = 0;
+
+bool wol_sender_start(void)
+{
+    return true;
+}
+
+bool wol_send(const uint8_t *mac, const wol_options_t *options)
+{
+    if (!mac)
+    {
+        return false;
+    }
+
+    wol_options_t defaults;
+    if (!options)
+    {
+        wol_options_init(&defaults);
+        options = &defaults;
+    }
+
+    const wol_packet_t *packet = wol_packet_get(mac, options->secureon ? options->password : NULL);
+    memcpy(host_wol_last_packet, packet->data, (size_t)packet->len);
+    host_wol_last_len = packet->len;
+
+    int ports = ((options->ports & WOL_SEND_PORT_9) ? 1 : 0) + ((options->ports & WOL_SEND_PORT_7) ? 1 : 0);
+    host_wol_stats.targets++;
+    host_wol_stats.packets += (uint32_t)(options->burst * ports);
+    return true;
+}
+
+bool wol_send_many(const uint8_t (*macs)[WOL_MAC_LEN], int count, const wol_options_t *options)
+{
+    if (!macs || count <= 0 || count > WOL_MAX_TARGETS)
+    {
+        return false;
+    }
+
+    wol_options_t defaults;
+    if (!options)
+    {
+        wol_options_init(&defaults);
+        options = &defaults;
+    }
+
+    const wol_packet_t *packet = wol_packet_get(macs[count - 1], options->secureon ? options->password : NULL);
+    memcpy(host_wol_last_packet, packet->data, (size_t)packet->len);
+    host_wol_last_len = packet->len;
+
+    int ports = ((options->ports & WOL_SEND_PORT_9) ? 1 : 0) + ((options->ports & WOL_SEND_PORT_7) ? 1 : 0);
+    host_wol_stats.targets += (uint32_t)count;
+    host_wol_stats.packets += (uint32_t)(options->burst * ports * count);
+    return true;
+}
+
+void wol_sender_get_stats(wol_sender_stats_t *stats)
+{
+    if (stats)
+    {
+        *stats = host_wol_stats;
+    }
+}
+
+uint32_t host_wol_sent_packets(void)
+{
+    return host_wol_stats.packets;
+}
+
+const uint8_t *host_wol_last_packet_data(int *len)
+{
+    if (len)
+    {
+        *len = host_wol_last_len;
+    }
+    return host_wol_last_packet;
+}
@@ -0,0 +1,35 @@
+#ifndef LED_BACKEND_H
+#define LED_BACKEND_H
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "led_controller.h"
+
+// Transporte de uma saída física. O led_controller só fala com esta interface:
+// monta o frame, passa pelo estágio de saída e entrega aos backends os pixels
+// que mudaram; cada backend converte para o formato da linha (GRB/GRBW) e
+// transmite. flush dispara a transmissão sem esperar, para que várias saídas
+// transmitam em paralelo; wait_done espera o fim.
+struct led_backend
+{
+    const char *name;
+    // Cria a instância da saída. instances = quantas saídas da config usam
+    // este backend (para repartir recursos, ex.: memória RMT).
+    esp_err_t (*init)(const led_output_config_t *output, int instances, void **ctx);
+    // Grava count pixels a partir do índice first (relativo à saída) no buffer
+    // de transmissão. Pixels empacotados: r | g << 8 | b << 16 | w << 24.
+    esp_err_t (*write)(void *ctx, int first, const uint32_t *pixels, int count);
+    esp_err_t (*flush)(void *ctx);
+    esp_err_t (*wait_done)(void *ctx);
+    // Apaga a fita e libera a instância.
+    void (*deinit)(void *ctx);
+};
+
+// RMT via componente led_strip (padrão).
+extern const led_backend_t led_backend_rmt;
+// SPI com DMA: cada bit da fita vira 3 bits SPI (tabela pré-calculada), sem
+// ISR de refill durante a transmissão.
+extern const led_backend_t led_backend_spi;
+
+#endif
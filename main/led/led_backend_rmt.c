@@ -0,0 +1,110 @@
+#include "led_backend.h"
+
+#include <stdlib.h>
+#include "esp_log.h"
+#include "led_strip.h"
+
+static const char *TAG = "led_backend_rmt";
+
+// Memória RMT repartida entre as saídas RMT (ver rmt_mem_symbols).
+#define LED_RMT_MEM_SYMBOLS 256
+#define LED_RMT_BLOCK_SYMBOLS 64
+
+typedef struct
+{
+    led_strip_handle_t strip;
+    bool rgbw;
+} led_rmt_t;
+
+// Memória RMT de cada canal. ESP32 não tem RMT-DMA: o buffer é realimentado
+// por ISR durante a transmissão. Buffer maior => menos refills => menos
+// glitches (LEDs "piscando") quando o WiFi disputa o barramento/interrupções.
+// Uma saída fica com 256 symbols (4 blocos de 64 words, ~10 LEDs de folga por
+// refill); com mais saídas os mesmos 4 blocos são divididos entre elas (no
+// mínimo 1 bloco por canal).
+static size_t rmt_mem_symbols(int instances)
+{
+    size_t symbols = (LED_RMT_MEM_SYMBOLS / (size_t)instances) & ~(size_t)(LED_RMT_BLOCK_SYMBOLS - 1);
+    return symbols < LED_RMT_BLOCK_SYMBOLS ? LED_RMT_BLOCK_SYMBOLS : symbols;
+}
+
+static esp_err_t rmt_init(const led_output_config_t *output, int instances, void **ctx)
+{
+    led_rmt_t *rmt = calloc(1, sizeof(*rmt));
+    if (!rmt)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    rmt->rgbw = (output->type == LED_STRIP_TYPE_SK6812);
+
+    led_strip_config_t strip_config = {
+        .strip_gpio_num = output->pin,
+        .max_leds = output->count,
+        .led_model = rmt->rgbw ? LED_MODEL_SK6812 : LED_MODEL_WS2812,
+        .color_component_format = rmt->rgbw ? LED_STRIP_COLOR_COMPONENT_FMT_GRBW : LED_STRIP_COLOR_COMPONENT_FMT_GRB,
+        .flags = {
+            .invert_out = false,
+        },
+    };
+
+    led_strip_rmt_config_t rmt_config = {
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = 10 * 1000 * 1000,
+        .mem_block_symbols = rmt_mem_symbols(instances),
+        .flags = {
+            .with_dma = false,
+        },
+    };
+
+    esp_err_t err = led_strip_new_rmt_device(&strip_config, &rmt_config, &rmt->strip);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create LED strip on pin %d: %s", output->pin, esp_err_to_name(err));
+        free(rmt);
+        return err;
+    }
+
+    *ctx = rmt;
+    return ESP_OK;
+}
+
+static esp_err_t rmt_write(void *ctx, int first, const uint32_t *pixels, int count)
+{
+    led_rmt_t *rmt = ctx;
+    esp_err_t err = ESP_OK;
+    for (int i = 0; i < count && err == ESP_OK; i++)
+    {
+        uint32_t px = pixels[i];
+        uint8_t r = (uint8_t)px, g = (uint8_t)(px >> 8), b = (uint8_t)(px >> 16);
+        err = rmt->rgbw ? led_strip_set_pixel_rgbw(rmt->strip, first + i, r, g, b, (uint8_t)(px >> 24))
+                        : led_strip_set_pixel(rmt->strip, first + i, r, g, b);
+    }
+    return err;
+}
+
+static esp_err_t rmt_flush(void *ctx)
+{
+    return led_strip_refresh_async(((led_rmt_t *)ctx)->strip);
+}
+
+static esp_err_t rmt_wait_done(void *ctx)
+{
+    return led_strip_refresh_wait_done(((led_rmt_t *)ctx)->strip);
+}
+
+static void rmt_deinit(void *ctx)
+{
+    led_rmt_t *rmt = ctx;
+    led_strip_clear(rmt->strip);
+    led_strip_del(rmt->strip);
+    free(rmt);
+}
+
+const led_backend_t led_backend_rmt = {
+    .name = "rmt",
+    .init = rmt_init,
+    .write = rmt_write,
+    .flush = rmt_flush,
+    .wait_done = rmt_wait_done,
+    .deinit = rmt_deinit,
+};
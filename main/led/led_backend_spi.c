@@ -0,0 +1,206 @@
+#include "led_backend.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "driver/spi_master.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "soc/soc_caps.h"
+#include "led_tables.h"
+
+static const char *TAG = "led_backend_spi";
+
+// 2,5 MHz com 3 bits SPI por bit da fita: 0 = 0,4 µs alto + 0,8 µs baixo,
+// 1 = 0,8 µs alto + 0,4 µs baixo (dentro da tolerância do WS2812/SK6812).
+#define LED_SPI_CLOCK_HZ (2500 * 1000)
+#define LED_SPI_BYTES_PER_CHANNEL 3
+// Reset da fita (>= 280 µs em nível baixo): zeros no fim de cada transmissão,
+// já que o MOSI não tem nível definido entre transações.
+#define LED_SPI_RESET_BYTES ((280 * (LED_SPI_CLOCK_HZ / 1000000) + 7) / 8 + 1)
+
+// Barramentos SPI de uso geral (SPI1 é o da flash).
+static const spi_host_device_t led_spi_hosts[] = {
+    SPI2_HOST,
+#if SOC_SPI_PERIPH_NUM > 2
+    SPI3_HOST,
+#endif
+};
+
+static bool led_spi_host_used[sizeof(led_spi_hosts) / sizeof(led_spi_hosts[0])];
+
+typedef struct
+{
+    int host_index;
+    spi_device_handle_t device;
+    spi_transaction_t transaction;
+    uint8_t *buffer; // DMA: bits SPI já codificados, na ordem da linha (GRB/GRBW)
+    size_t length;
+    int count;
+    int bytes_per_pixel;
+    bool in_flight;
+} led_spi_t;
+
+static void spi_release(led_spi_t *spi)
+{
+    if (spi->device)
+    {
+        spi_bus_remove_device(spi->device);
+        spi_bus_free(led_spi_hosts[spi->host_index]);
+    }
+    led_spi_host_used[spi->host_index] = false;
+    heap_caps_free(spi->buffer);
+    free(spi);
+}
+
+// Preenche o buffer com todos os LEDs apagados (e o reset no fim).
+static void spi_encode_off(led_spi_t *spi)
+{
+    const uint8_t *zero = led_spi_pattern_table[0];
+    uint8_t *out = spi->buffer;
+    for (int i = 0; i < spi->count * spi->bytes_per_pixel; i++, out += LED_SPI_BYTES_PER_CHANNEL)
+    {
+        memcpy(out, zero, LED_SPI_BYTES_PER_CHANNEL);
+    }
+    memset(out, 0, LED_SPI_RESET_BYTES);
+}
+
+static esp_err_t spi_init(const led_output_config_t *output, int instances, void **ctx)
+{
+    int host_index = -1;
+    for (size_t i = 0; i < sizeof(led_spi_hosts) / sizeof(led_spi_hosts[0]); i++)
+    {
+        if (!led_spi_host_used[i])
+        {
+            host_index = (int)i;
+            break;
+        }
+    }
+    if (host_index < 0)
+    {
+        ESP_LOGE(TAG, "No free SPI host for LED output on pin %d", output->pin);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    led_spi_t *spi = calloc(1, sizeof(*spi));
+    if (!spi)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    spi->host_index = host_index;
+    led_spi_host_used[host_index] = true;
+    spi->count = output->count;
+    spi->bytes_per_pixel = (output->type == LED_STRIP_TYPE_SK6812) ? 4 : 3;
+    spi->length = (size_t)output->count * spi->bytes_per_pixel * LED_SPI_BYTES_PER_CHANNEL + LED_SPI_RESET_BYTES;
+    spi->buffer = heap_caps_malloc(spi->length, MALLOC_CAP_DMA);
+    if (!spi->buffer)
+    {
+        spi_release(spi);
+        return ESP_ERR_NO_MEM;
+    }
+    spi_encode_off(spi);
+
+    spi_bus_config_t bus_config = {
+        .mosi_io_num = output->pin,
+        .miso_io_num = -1,
+        .sclk_io_num = -1,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = (int)spi->length,
+    };
+    esp_err_t err = spi_bus_initialize(led_spi_hosts[host_index], &bus_config, SPI_DMA_CH_AUTO);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to init SPI bus for pin %d: %s", output->pin, esp_err_to_name(err));
+        spi_release(spi);
+        return err;
+    }
+
+    spi_device_interface_config_t device_config = {
+        .clock_speed_hz = LED_SPI_CLOCK_HZ,
+        .mode = 0,
+        .spics_io_num = -1,
+        .queue_size = 1,
+    };
+    err = spi_bus_add_device(led_spi_hosts[host_index], &device_config, &spi->device);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to add SPI device for pin %d: %s", output->pin, esp_err_to_name(err));
+        spi_bus_free(led_spi_hosts[host_index]);
+        spi->device = NULL;
+        spi_release(spi);
+        return err;
+    }
+
+    *ctx = spi;
+    return ESP_OK;
+}
+
+// Só os pixels alterados são recodificados: 3 consultas de tabela por canal.
+static esp_err_t spi_write(void *ctx, int first, const uint32_t *pixels, int count)
+{
+    led_spi_t *spi = ctx;
+    uint8_t *out = spi->buffer + (size_t)first * spi->bytes_per_pixel * LED_SPI_BYTES_PER_CHANNEL;
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t px = pixels[i];
+        // Ordem da linha: G, R, B (, W).
+        const uint8_t channels[4] = {(uint8_t)(px >> 8), (uint8_t)px, (uint8_t)(px >> 16), (uint8_t)(px >> 24)};
+        for (int c = 0; c < spi->bytes_per_pixel; c++, out += LED_SPI_BYTES_PER_CHANNEL)
+        {
+            memcpy(out, led_spi_pattern_table[channels[c]], LED_SPI_BYTES_PER_CHANNEL);
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t spi_flush(void *ctx)
+{
+    led_spi_t *spi = ctx;
+    if (spi->in_flight)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    memset(&spi->transaction, 0, sizeof(spi->transaction));
+    spi->transaction.length = spi->length * 8;
+    spi->transaction.tx_buffer = spi->buffer;
+    esp_err_t err = spi_device_queue_trans(spi->device, &spi->transaction, portMAX_DELAY);
+    spi->in_flight = (err == ESP_OK);
+    return err;
+}
+
+static esp_err_t spi_wait_done(void *ctx)
+{
+    led_spi_t *spi = ctx;
+    if (!spi->in_flight)
+    {
+        return ESP_OK;
+    }
+
+    spi_transaction_t *done = NULL;
+    esp_err_t err = spi_device_get_trans_result(spi->device, &done, portMAX_DELAY);
+    spi->in_flight = false;
+    return err;
+}
+
+static void spi_deinit(void *ctx)
+{
+    led_spi_t *spi = ctx;
+    spi_wait_done(spi);
+    spi_encode_off(spi);
+    if (spi_flush(spi) == ESP_OK)
+    {
+        spi_wait_done(spi);
+    }
+    spi_release(spi);
+}
+
+const led_backend_t led_backend_spi = {
+    .name = "spi",
+    .init = spi_init,
+    .write = spi_write,
+    .flush = spi_flush,
+    .wait_done = spi_wait_done,
+    .deinit = spi_deinit,
+};
@@ -1,261 +1,1577 @@
 #include "led_controller.h"
+#include "led_controller_internal.h"
 
-#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "esp_log.h"
-#include "led_strip.h"
+#include "esp_timer.h"
+#include "led_backend.h"
+#include "led_effects.h"
+#include "led_tables.h"
 
 static const char *TAG = "led_controller";
 
-#define LED_QUEUE_LENGTH 8
-#define EFFECT_FRAME_MS 20   // ~50 fps
+// Bits de notificação da led_task.
+#define LED_NOTIFY_UPDATE (1u << 0) // há estado novo na caixa de correio
+#define LED_NOTIFY_FRAME  (1u << 1) // prazo do próximo frame de efeito
+#define LED_NOTIFY_CONTROL (1u << 2) // reconfiguração pedida em led_control
+#define EFFECT_FRAME_US (20 * 1000) // ~50 fps
+#define FRAME_BYTES_PER_PIXEL 4 // framebuffers guardam sempre RGBW (w=0 em fita RGB)
+// Estimativa de consumo: cada canal em 255 puxa ~20 mA; cada LED, ~1 mA parado.
+#define LED_MA_PER_CHANNEL 20
+#define LED_IDLE_MA_PER_PIXEL 1
+// Após esse tempo sem frames, qualquer seq é aceita (servidor reiniciou o stream).
+#define STREAM_IDLE_RESET_US (1000 * 1000)
+// Progresso das transições em ponto fixo: TRANSITION_MIX_ONE = só o alvo.
+#define TRANSITION_MIX_BITS 12
+#define TRANSITION_MIX_ONE (1u << TRANSITION_MIX_BITS)
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+// Mudança de estado de um segmento pedida à led_task: nova cor sólida e/ou novo
+// efeito. Atualizações seguidas se fundem numa só (vale a última), na mesma
+// ordem em que seriam aplicadas uma a uma.
+typedef struct {
+    bool has_color;         // color é a nova cor sólida (interrompe o efeito)
+    bool has_effect;        // effect/base trocam o efeito
+    led_color_t color;
+    const led_effect_t *effect; // NULL = sem efeito
+    led_effect_params_t params;
+    uint32_t transition_ms; // 0 = corte seco; vale o da última mudança
+} led_update_t;
+
+// Mudanças pendentes por segmento (bit i de mask = updates[i] válido).
+typedef struct {
+    uint32_t mask;
+    led_update_t updates[LED_MAX_SEGMENTS];
+} led_update_set_t;
+
+#define LED_SEGMENT_MASK_ALL ((1u << LED_MAX_SEGMENTS) - 1)
+
+// Pedido de controle da timeline. load troca para a timeline publicada antes
+// de aplicar control.
+typedef struct {
+    bool pending;
+    bool load;
+    led_timeline_control_t control;
+    uint32_t position_ms;
+} led_timeline_request_t;
+
+// Novo estágio de saída (brilho e orçamento de corrente); a tabela é refeita
+// pela led_task antes do próximo frame.
+typedef struct {
+    bool pending;
+    uint8_t brightness;
+    uint32_t max_milliamps;
+} led_output_request_t;
+
+// Caixa de correio da led_task: um slot por segmento, sobrescrito a cada
+// comando, então nenhum comando é recusado por fila cheia e a task sempre
+// aplica o estado mais novo. stream indica que o último pedido foi um frame do
+// stream (que ocupa a fita inteira). Protegida por um spinlock curto.
+typedef struct {
+    bool stream;
+    led_update_set_t set;
+    led_timeline_request_t timeline;
+    led_output_request_t output;
+    led_mailbox_stats_t stats;
+} led_mailbox_t;
+
+static led_mailbox_t led_mailbox = {0};
+static portMUX_TYPE led_mailbox_lock = portMUX_INITIALIZER_UNLOCKED;
+
+typedef struct {
+    bool active;
+    led_update_set_t set;
+} led_batch_t;
+
+static led_batch_t led_batch = {0};
+
+// Segmentos: zonas da fita com cor/efeito/fase próprios, todas renderizadas no
+// mesmo framebuffer e enviadas num único refresh. Sem segmentos configurados,
+// um segmento único cobre a fita inteira. Só a led_task escreve (junto com os
+// deslocamentos de matiz); a task do WS lê sob o spinlock para achar nomes.
+typedef struct {
+    led_segment_t segments[LED_MAX_SEGMENTS];
+    int count;
+} led_layout_t;
+
+static led_layout_t led_layout = {0};
+static portMUX_TYPE led_layout_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Double buffering do stream: a task do WS monta o frame em buffers[back]; a
+// led_task lê buffers[!back]. A troca acontece na led_task, sob o spinlock, só
+// quando há um frame publicado; se um frame novo começa antes disso, o
+// publicado é retirado (overrun) e o novo é escrito por cima dele.
+typedef struct {
+    uint8_t *buffers[2];
+    int back;
+    bool back_is_latest;     // back já contém o último frame publicado
+    bool published;          // back tem um frame completo esperando a troca
+    bool building;
+    uint16_t building_seq;
+    int64_t building_started_us;
+    int64_t published_started_us;
+    bool has_last_seq;
+    uint16_t last_seq;
+    int64_t last_push_us;
+    uint64_t latency_total_us;
+    led_stream_stats_t stats;
+} led_stream_t;
+
+static led_stream_t led_stream = {0};
+static portMUX_TYPE led_stream_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Timeline, com três buffers: a task do WS monta a timeline nova em
+// buffers[edit] e, no commit, a troca com buffers[ready]; a led_task troca
+// ready com front sob o spinlock quando recebe o load e toca front. Um upload
+// recusado só mexeu em edit, então a timeline publicada (ainda não trocada)
+// continua valendo; um commit antes da troca substitui a publicada.
+typedef struct {
+    led_keyframe_t buffers[3][LED_TIMELINE_MAX_KEYFRAMES];
+    int front;         // led_task
+    int ready;         // publicada (com published) ou livre
+    int edit;          // task do WS
+    bool published;
+    int published_count;
+    uint32_t published_duration_ms;
+    bool published_loop;
+    // Reprodução, só acessada pela led_task.
+    const led_keyframe_t *keyframes;
+    int count;
+    uint32_t duration_ms;
+    bool loop;
+    int next;          // próximo keyframe a aplicar
+    int64_t origin_us; // instante do at_ms 0 da volta atual
+    led_timeline_status_t status; // escrito pela led_task sob o spinlock
+} led_timeline_t;
+
+static led_timeline_t led_timeline = {.front = 0, .ready = 1, .edit = 2};
+static portMUX_TYPE led_timeline_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Agendador dos frames de efeito: um esp_timer periódico (prazos absolutos, sem
+// deriva) acorda a led_task; comandos que chegam entre frames não mexem na
+// cadência, e o step do efeito sai do tempo decorrido, não da contagem de frames.
+typedef struct {
+    esp_timer_handle_t timer;
+    bool running;
+    int64_t next_deadline_us;
+    uint64_t jitter_total_us;
+    led_scheduler_stats_t stats;
+} led_scheduler_t;
+
+static led_scheduler_t led_sched = {0};
+
+// Reconfiguração da fita (saídas ou segmentos), executada pela led_task entre
+// dois frames: canais, framebuffers e layout só são trocados por quem
+// renderiza. A task do WS preenche led_control, notifica e espera o resultado
+// em led_control_done.
+typedef enum {
+    LED_CONTROL_OUTPUTS,
+    LED_CONTROL_SEGMENTS,
+} led_control_kind_t;
+
+typedef struct {
+    led_control_kind_t kind;
+    led_output_config_t outputs[LED_MAX_OUTPUTS];
+    int output_count;
+    led_layout_t layout;
+} led_control_t;
+
+static led_control_t led_control;
+static QueueHandle_t led_control_done = NULL;
+
+// Saída física: uma instância de backend (ex.: um canal RMT), dona dos pixels
+// [start, start + count) do framebuffer lógico (as saídas ficam concatenadas
+// na ordem da config).
+typedef struct {
+    const led_backend_t *backend;
+    void *ctx;
+    int start;
+    int count;
+    int pin;
+    led_strip_type_t type;
+} led_channel_t;
+
+typedef struct {
+    led_channel_t channels[LED_MAX_OUTPUTS];
+    int channel_count;
+    TaskHandle_t task;
+    bool task_running; // led_task já entrou no loop (nunca no build de host)
+    int count;          // total de LEDs, somando todas as saídas
+    bool config_ready;
+    led_color_t last_color;
+} led_controller_state_t;
+
+static led_controller_state_t led_state = {
+    .channel_count = 0,
+    .task = NULL,
+    .task_running = false,
+    .count = 0,
+    .config_ready = false,
+    .last_color = {0}
+};
+
+// Cor sólida, efeitos e stream montam o frame num buffer RGBW e passam por
+// frame_flush, que compara com o último frame enviado (shadow) e só transmite
+// se algo mudou: cada refresh evitado é uma rodada a menos da ISR de refill do
+// RMT disputando a CPU com o WiFi.
+static uint8_t *led_frame = NULL;
+static uint32_t *led_shadow = NULL;
+static uint8_t *led_hue_offsets = NULL; // rainbow: posição no segmento * 256 / tamanho
+static bool led_shadow_valid = false;
+static const uint8_t *led_displayed = NULL; // último frame (lógico) enviado
+static led_frame_stats_t led_frame_stats = {0};
+
+// Estágio de saída, aplicado em frame_flush entre o frame lógico e a fita:
+// gama + brilho mestre numa tabela só e, se o consumo estimado do frame passar
+// do orçamento, uma escala única para todos os canais. O shadow guarda os
+// valores de saída, então mudar o brilho também gera um frame novo.
+typedef struct {
+    uint8_t brightness;
+    uint32_t max_milliamps; // 0 = sem limite
+    uint8_t lut[256];
+    led_power_stats_t stats;
+} led_output_t;
+
+static led_output_t led_output = { .brightness = 255 };
+
+// Transição temporizada de um segmento: a cada frame o alvo (cor sólida ou
+// efeito) é renderizado em led_frame e misturado, em luz linear, com o snapshot
+// do que estava na fita quando ela começou. Uma mudança no meio de outra
+// transição parte do frame intermediário que está na fita.
+typedef struct {
+    bool active;
+    int64_t start_us;
+    uint32_t duration_us;
+} led_transition_t;
+
+static uint8_t *led_transition_from = NULL;
+
+// Estado de cada segmento, só acessado pela led_task. A memória da instância
+// do efeito (ex.: calor do fire) é alocada e iniciada no primeiro frame depois
+// de trocar o efeito ou o tamanho do segmento.
+typedef struct {
+    const led_effect_t *effect; // NULL = cor sólida
+    led_effect_params_t params;
+    void *effect_state;
+    int state_length;  // tamanho do segmento ao iniciar o estado; -1 = iniciar
+    led_color_t solid;
+    int64_t origin_us; // instante do step 0 do efeito
+    led_transition_t transition;
+} led_segment_state_t;
+
+static led_segment_state_t led_segment_states[LED_MAX_SEGMENTS];
+// Instância de led_controller_render_effect (fita inteira, fora dos segmentos).
+static led_segment_state_t led_render_state;
+
+static bool frame_alloc(int led_count)
+{
+    free(led_frame);
+    free(led_shadow);
+    free(led_hue_offsets);
+    free(led_transition_from);
+    led_shadow_valid = false;
+    led_displayed = NULL;
+    for (int i = 0; i < LED_MAX_SEGMENTS; i++)
+    {
+        led_segment_states[i].transition.active = false;
+    }
+
+    size_t size = (size_t)led_count * FRAME_BYTES_PER_PIXEL;
+    led_frame = calloc(1, size);
+    led_shadow = calloc((size_t)led_count, sizeof(*led_shadow));
+    led_hue_offsets = malloc((size_t)led_count);
+    led_transition_from = malloc(size);
+    if (!led_frame || !led_shadow || !led_hue_offsets || !led_transition_from)
+    {
+        free(led_frame);
+        free(led_shadow);
+        free(led_hue_offsets);
+        free(led_transition_from);
+        led_frame = NULL;
+        led_shadow = NULL;
+        led_hue_offsets = NULL;
+        led_transition_from = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+// Deslocamento de matiz de cada pixel relativo ao seu segmento (no sentido do
+// segmento), calculado quando o layout muda.
+static void layout_compute_offsets(const led_layout_t *layout)
+{
+    for (int s = 0; s < layout->count; s++)
+    {
+        const led_segment_t *seg = &layout->segments[s];
+        for (int k = 0; k < seg->length; k++)
+        {
+            int index = seg->reversed ? seg->start + seg->length - 1 - k : seg->start + k;
+            led_hue_offsets[index] = (uint8_t)((k * 256) / seg->length);
+        }
+    }
+}
+
+static void layout_set(const led_layout_t *layout)
+{
+    taskENTER_CRITICAL(&led_layout_lock);
+    led_layout = *layout;
+    taskEXIT_CRITICAL(&led_layout_lock);
+    layout_compute_offsets(layout);
+}
+
+static void layout_snapshot(led_layout_t *layout)
+{
+    taskENTER_CRITICAL(&led_layout_lock);
+    *layout = led_layout;
+    taskEXIT_CRITICAL(&led_layout_lock);
+}
+
+static void frame_fill(uint8_t *frame, int start, int length, const led_color_t *c)
+{
+    frame += (size_t)start * FRAME_BYTES_PER_PIXEL;
+    for (int i = 0; i < length; i++, frame += FRAME_BYTES_PER_PIXEL)
+    {
+        frame[0] = c->red;
+        frame[1] = c->green;
+        frame[2] = c->blue;
+        frame[3] = c->white;
+    }
+}
+
+// Canal de saída: gama e brilho já na tabela. Canais acesos nunca apagam por
+// arredondamento (piso 1), como no breathing; só brilho 0 apaga tudo. Só a
+// led_task (ou o start, antes dela) refaz a tabela.
+static void output_build_lut(void)
+{
+    for (int v = 0; v < 256; v++)
+    {
+        uint32_t out = ((uint32_t)led_gamma_table[v] * led_output.brightness + 127) / 255;
+        led_output.lut[v] = (v > 0 && out == 0 && led_output.brightness > 0) ? 1 : (uint8_t)out;
+    }
+}
+
+// Converte a soma dos canais de saída (antes da escala) em corrente estimada,
+// registra a telemetria e devolve a escala (0..256) que mantém o frame dentro
+// de max_milliamps.
+static uint32_t output_account(uint32_t sum)
+{
+    uint32_t idle_ma = (uint32_t)led_state.count * LED_IDLE_MA_PER_PIXEL;
+    uint32_t drive_ma = (uint32_t)(((uint64_t)sum * LED_MA_PER_CHANNEL + 127) / 255);
+    uint32_t scale = 256;
+    led_power_stats_t *stats = &led_output.stats;
+    if (led_output.max_milliamps > 0 && idle_ma + drive_ma > led_output.max_milliamps)
+    {
+        scale = (led_output.max_milliamps > idle_ma)
+                    ? (uint32_t)(((uint64_t)(led_output.max_milliamps - idle_ma) << 8) / drive_ma)
+                    : 0;
+        stats->limited_frames++;
+    }
+
+    stats->requested_ma = idle_ma + drive_ma;
+    stats->estimated_ma = idle_ma + ((drive_ma * scale) >> 8);
+    if (stats->estimated_ma > stats->peak_ma)
+    {
+        stats->peak_ma = stats->estimated_ma;
+    }
+    return scale;
+}
+
+// Com orçamento, a escala precisa ser conhecida antes do envio: uma passada
+// só de soma (tabela, sem escrita) antes da passada de saída. O orçamento vale
+// para todas as saídas juntas (mesma fonte).
+static uint32_t output_budget_scale(const uint8_t *frame)
+{
+    const uint8_t *lut = led_output.lut;
+    uint32_t sum = 0;
+    for (int c = 0; c < led_state.channel_count; c++)
+    {
+        const led_channel_t *channel = &led_state.channels[c];
+        bool white = (channel->type == LED_STRIP_TYPE_SK6812);
+        const uint8_t *px = frame + (size_t)channel->start * FRAME_BYTES_PER_PIXEL;
+        for (int i = 0; i < channel->count; i++, px += FRAME_BYTES_PER_PIXEL)
+        {
+            sum += lut[px[0]] + lut[px[1]] + lut[px[2]];
+            if (white)
+            {
+                sum += lut[px[3]];
+            }
+        }
+    }
+    return output_account(sum);
+}
+
+// Pixel de saída empacotado (r | g << 8 | b << 16 | w << 24), na mesma ordem
+// de bytes do shadow em memória.
+static inline uint32_t output_pixel(const uint8_t *lut, const uint8_t *in, bool white)
+{
+    uint32_t w = white ? lut[in[3]] : 0;
+    return lut[in[0]] | ((uint32_t)lut[in[1]] << 8) | ((uint32_t)lut[in[2]] << 16) | (w << 24);
+}
+
+// Escala os quatro canais de um pixel empacotado (scale < 256), com piso 1
+// para canais acesos.
+static inline uint32_t output_scale(uint32_t px, uint32_t scale)
+{
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        uint32_t c = (px >> shift) & 0xFF;
+        uint32_t v = (c * scale) >> 8;
+        if (v == 0 && c > 0 && scale > 0)
+        {
+            v = 1;
+        }
+        out |= v << shift;
+    }
+    return out;
+}
+
+// Passa os pixels de uma saída pelo estágio de saída e entrega ao backend, em
+// trechos contíguos, os que diferem do shadow (o backend mantém os demais no
+// seu buffer). Sem orçamento, soma a corrente em *sum. Retorna true se algum
+// pixel mudou.
+static bool channel_output(const led_channel_t *channel, const uint8_t *frame, uint32_t scale, bool budget,
+                           uint32_t *sum)
+{
+    bool sk6812 = (channel->type == LED_STRIP_TYPE_SK6812);
+    const uint8_t *lut = led_output.lut;
+    uint32_t total = 0;
+    bool changed = false;
+    const uint8_t *in = frame + (size_t)channel->start * FRAME_BYTES_PER_PIXEL;
+    uint32_t *shadow = led_shadow + channel->start;
+    int run_start = -1; // primeiro pixel do trecho alterado em aberto
+    for (int i = 0; i < channel->count; i++, in += FRAME_BYTES_PER_PIXEL)
+    {
+        uint32_t out = output_pixel(lut, in, sk6812);
+        if (scale < 256)
+        {
+            out = output_scale(out, scale);
+        }
+        else if (!budget)
+        {
+            total += (out & 0xFF) + ((out >> 8) & 0xFF) + ((out >> 16) & 0xFF) + (out >> 24);
+        }
+
+        if (led_shadow_valid && out == shadow[i])
+        {
+            if (run_start >= 0)
+            {
+                channel->backend->write(channel->ctx, run_start, shadow + run_start, i - run_start);
+                run_start = -1;
+            }
+            continue;
+        }
+
+        shadow[i] = out;
+        if (run_start < 0)
+        {
+            run_start = i;
+            changed = true;
+        }
+    }
+    if (run_start >= 0)
+    {
+        channel->backend->write(channel->ctx, run_start, shadow + run_start, channel->count - run_start);
+    }
+
+    *sum += total;
+    return changed;
+}
+
+// Passa o frame lógico pelo estágio de saída e envia as saídas que mudaram.
+// Todas as transmissões são disparadas antes de esperar por qualquer uma: as
+// saídas transmitem em paralelo e o refresh custa o da mais longa, não a soma.
+static bool frame_flush(const uint8_t *frame)
+{
+    // Sem orçamento a corrente é somada na própria passada de saída.
+    bool budget = led_output.max_milliamps > 0;
+    uint32_t scale = budget ? output_budget_scale(frame) : 256;
+    uint32_t sum = 0;
+    bool changed[LED_MAX_OUTPUTS];
+    bool any_changed = false;
+    for (int c = 0; c < led_state.channel_count; c++)
+    {
+        changed[c] = channel_output(&led_state.channels[c], frame, scale, budget, &sum);
+        any_changed |= changed[c];
+    }
+
+    if (!budget)
+    {
+        output_account(sum);
+    }
+    led_displayed = frame;
+    if (!any_changed)
+    {
+        led_frame_stats.skipped++;
+        return true;
+    }
+
+    int64_t started_us = esp_timer_get_time();
+    esp_err_t err = ESP_OK;
+    for (int c = 0; c < led_state.channel_count; c++)
+    {
+        if (!changed[c])
+        {
+            continue;
+        }
+        const led_channel_t *channel = &led_state.channels[c];
+        esp_err_t start_err = channel->backend->flush(channel->ctx);
+        if (start_err != ESP_OK)
+        {
+            err = start_err;
+            changed[c] = false; // nada a esperar nesse canal
+        }
+    }
+    for (int c = 0; c < led_state.channel_count; c++)
+    {
+        if (changed[c])
+        {
+            const led_channel_t *channel = &led_state.channels[c];
+            esp_err_t wait_err = channel->backend->wait_done(channel->ctx);
+            if (wait_err != ESP_OK)
+            {
+                err = wait_err;
+            }
+        }
+    }
+
+    uint32_t refresh_us = (uint32_t)(esp_timer_get_time() - started_us);
+    led_frame_stats.last_refresh_us = refresh_us;
+    if (refresh_us > led_frame_stats.max_refresh_us)
+    {
+        led_frame_stats.max_refresh_us = refresh_us;
+    }
+
+    if (err != ESP_OK)
+    {
+        // A fita pode ter ficado com qualquer coisa: o próximo frame vai inteiro.
+        led_shadow_valid = false;
+        ESP_LOGE(TAG, "Failed to refresh LED strip: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    led_shadow_valid = true;
+    led_frame_stats.transmitted++;
+    return true;
+}
+
+static bool led_apply_color(const led_color_t *color)
+{
+    if (!led_state.config_ready)
+    {
+        return false;
+    }
+
+    frame_fill(led_frame, 0, led_state.count, color);
+    if (!frame_flush(led_frame))
+    {
+        return false;
+    }
+
+    led_state.last_color = *color;
+    return true;
+}
+
+// ===================== TRANSIÇÕES =====================
+
+// Luz linear (0..65535) -> valor de canal mais próximo.
+static uint8_t delinear(uint32_t light)
+{
+    uint8_t v = led_delinear_table[light >> LED_DELINEAR_SHIFT];
+    while (v < 255 && led_linear_table[v + 1] <= light)
+    {
+        v++;
+    }
+    if (v < 255 && light - led_linear_table[v] > led_linear_table[v + 1] - light)
+    {
+        v++;
+    }
+    return v;
+}
+
+// frame = from + (frame - from) * mix, canal a canal e em luz linear, para que
+// o brilho percebido ande de forma uniforme (sem o "mergulho" de misturar os
+// valores já corrigidos por gama). mix em 0..TRANSITION_MIX_ONE.
+static void frame_blend(uint8_t *frame, const uint8_t *from, int start, int length, uint32_t mix)
+{
+    size_t first = (size_t)start * FRAME_BYTES_PER_PIXEL;
+    size_t end = first + (size_t)length * FRAME_BYTES_PER_PIXEL;
+    uint32_t keep = TRANSITION_MIX_ONE - mix;
+    for (size_t i = first; i < end; i++)
+    {
+        if (frame[i] == from[i])
+        {
+            continue;
+        }
+        uint32_t light = (led_linear_table[from[i]] * keep + led_linear_table[frame[i]] * mix +
+                          (TRANSITION_MIX_ONE / 2)) >> TRANSITION_MIX_BITS;
+        frame[i] = delinear(light);
+    }
+}
+
+static void transition_start(led_transition_t *transition, const led_segment_t *seg, uint32_t duration_ms,
+                             int64_t now)
+{
+    if (duration_ms == 0 || !led_state.config_ready || !led_transition_from)
+    {
+        transition->active = false;
+        return;
+    }
+
+    // O que está na fita agora (inclusive um frame intermediário de outra
+    // transição) é o ponto de partida.
+    const uint8_t *displayed = led_displayed ? led_displayed : led_frame;
+    size_t first = (size_t)seg->start * FRAME_BYTES_PER_PIXEL;
+    memcpy(led_transition_from + first, displayed + first, (size_t)seg->length * FRAME_BYTES_PER_PIXEL);
+    transition->active = true;
+    transition->start_us = now;
+    transition->duration_us = duration_ms * 1000u;
+}
+
+// Aplica a transição do segmento sobre o alvo já renderizado em led_frame.
+// Retorna true enquanto ela não terminou.
+static bool transition_apply(led_transition_t *transition, const led_segment_t *seg, int64_t now)
+{
+    if (!transition->active)
+    {
+        return false;
+    }
+
+    int64_t elapsed = now - transition->start_us;
+    if (elapsed >= (int64_t)transition->duration_us)
+    {
+        transition->active = false; // chegou ao alvo: o frame fica como está
+        return false;
+    }
+
+    uint32_t mix = (uint32_t)(((uint64_t)elapsed << TRANSITION_MIX_BITS) / transition->duration_us);
+    frame_blend(led_frame, led_transition_from, seg->start, seg->length, mix);
+    return true;
+}
+
+// ===================== EFEITOS (renderizados na led_task) =====================
+
+// Troca o efeito da instância; o estado é refeito no próximo frame.
+static void effect_instance_set(led_segment_state_t *state, const led_effect_t *effect,
+                                const led_effect_params_t *params)
+{
+    state->effect = effect;
+    state->params = *params;
+    state->state_length = -1;
+}
+
+// Garante a memória da instância para um segmento de length pixels e chama o
+// init do efeito. Retorna false se não há memória.
+static bool effect_instance_prepare(led_segment_state_t *state, const led_effect_frame_t *frame)
+{
+    if (state->state_length == frame->length)
+    {
+        return true;
+    }
+
+    const led_effect_t *effect = state->effect;
+    size_t size = effect->state_size + effect->state_per_pixel * (size_t)frame->length;
+    free(state->effect_state);
+    state->effect_state = NULL;
+    if (size > 0)
+    {
+        state->effect_state = calloc(1, size);
+        if (!state->effect_state)
+        {
+            ESP_LOGE(TAG, "No memory for effect %s (%u bytes)", effect->name, (unsigned)size);
+            return false;
+        }
+    }
+    if (effect->init)
+    {
+        effect->init(frame, &state->params, state->effect_state);
+    }
+    state->state_length = frame->length;
+    return true;
+}
+
+// Renderiza um frame do efeito nos pixels [start, start + length) de led_frame,
+// sem enviar. NÃO mexe em last_color (a cor sólida fica preservada para quando
+// o efeito for interrompido). Retorna false se não há o que renderizar.
+static bool effect_render(led_segment_state_t *state, int start, int length, bool reversed, uint32_t step)
+{
+    if (!led_state.config_ready || length <= 0 || !state->effect)
+    {
+        return false;
+    }
+
+    const led_effect_frame_t frame = {
+        .pixels = led_frame + (size_t)start * FRAME_BYTES_PER_PIXEL,
+        .length = length,
+        .reversed = reversed,
+        .hue_offsets = led_hue_offsets + start,
+        .step = step,
+    };
+    if (!effect_instance_prepare(state, &frame))
+    {
+        return false;
+    }
+
+    state->effect->render(&frame, &state->params, state->effect_state);
+    return true;
+}
+
+void led_controller_render_effect(const led_effect_t *effect, const led_effect_params_t *params, uint32_t step)
+{
+    led_segment_state_t *state = &led_render_state;
+    if (state->effect != effect || memcmp(&state->params, params, sizeof(*params)) != 0)
+    {
+        effect_instance_set(state, (effect && effect->render) ? effect : NULL, params);
+    }
+    if (effect_render(state, 0, led_state.count, false, step))
+    {
+        frame_flush(led_frame);
+    }
+}
+
+static void frame_timer_callback(void *arg)
+{
+    // Ticks que chegam antes da led_task consumir o anterior se fundem no mesmo
+    // bit; o atraso aparece como prazo perdido quando ela renderizar.
+    xTaskNotify(led_state.task, LED_NOTIFY_FRAME, eSetBits);
+}
+
+// Liga o timer se ainda não estiver rodando; efeitos que começam com outro
+// segmento já animando entram na cadência existente.
+static void scheduler_start(int64_t now)
+{
+    if (led_sched.running)
+    {
+        return;
+    }
+    led_sched.next_deadline_us = now + EFFECT_FRAME_US;
+    esp_timer_start_periodic(led_sched.timer, EFFECT_FRAME_US);
+    led_sched.running = true;
+}
+
+static void scheduler_stop(void)
+{
+    if (led_sched.running)
+    {
+        esp_timer_stop(led_sched.timer);
+        led_sched.running = false;
+    }
+}
+
+// Contabiliza o atraso do frame atual em relação ao prazo e devolve o instante
+// do frame.
+static int64_t scheduler_frame(void)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t lateness = now - led_sched.next_deadline_us;
+    if (lateness >= EFFECT_FRAME_US)
+    {
+        int64_t missed = lateness / EFFECT_FRAME_US;
+        led_sched.stats.missed_deadlines += (uint32_t)missed;
+        led_sched.next_deadline_us += missed * EFFECT_FRAME_US;
+        lateness -= missed * EFFECT_FRAME_US;
+    }
+    led_sched.next_deadline_us += EFFECT_FRAME_US;
+
+    uint32_t jitter = (uint32_t)(lateness < 0 ? -lateness : lateness);
+    led_scheduler_stats_t *stats = &led_sched.stats;
+    stats->frames++;
+    stats->last_jitter_us = jitter;
+    if (jitter > stats->max_jitter_us)
+    {
+        stats->max_jitter_us = jitter;
+    }
+    led_sched.jitter_total_us += jitter;
+    stats->avg_jitter_us = (uint32_t)(led_sched.jitter_total_us / stats->frames);
+    return now;
+}
+
+// Relógio de parede (SNTP) menos esp_timer. Relido a cada frame, então as
+// correções do SNTP chegam à fase dos efeitos com startAt.
+static int64_t wall_clock_offset_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - esp_timer_get_time();
+}
+
+// step do efeito no instante now = frames nominais decorridos desde o início
+// do efeito * passos por frame (step_rate, Q8) * velocidade relativa à nominal.
+// Com start_at_ms, o início vem do relógio de parede; antes dele, step 0.
+static uint32_t segment_step(const led_segment_state_t *state, int64_t now)
+{
+    int64_t origin_us = state->origin_us;
+    if (state->params.start_at_ms != 0)
+    {
+        origin_us = state->params.start_at_ms * 1000 - wall_clock_offset_us();
+    }
+    if (now <= origin_us)
+    {
+        return 0;
+    }
+
+    uint64_t rate = (uint64_t)state->effect->step_rate * state->params.speed;
+    return (uint32_t)(((uint64_t)(now - origin_us) * rate) /
+                      ((uint64_t)EFFECT_FRAME_US * 256 * LED_EFFECT_SPEED_NOMINAL));
+}
+
+// Funde update em dst como se os dois fossem aplicados em sequência.
+static void update_merge(led_update_t *dst, const led_update_t *update)
+{
+    if (update->has_color)
+    {
+        dst->color = update->color;
+        dst->has_color = true;
+        dst->has_effect = false; // cor sólida cancela o efeito anterior
+    }
+    if (update->has_effect)
+    {
+        dst->effect = update->effect;
+        dst->params = update->params;
+        dst->has_effect = true;
+    }
+    dst->transition_ms = update->transition_ms;
+}
+
+// Aplica update aos segmentos de mask. Retorna true se algum deles já tinha
+// mudança pendente (que foi sobrescrita).
+static bool update_set_merge(led_update_set_t *set, uint32_t mask, const led_update_t *update)
+{
+    bool superseded = (set->mask & mask) != 0;
+    for (int i = 0; i < LED_MAX_SEGMENTS; i++)
+    {
+        if (!(mask & (1u << i)))
+        {
+            continue;
+        }
+        if (set->mask & (1u << i))
+        {
+            update_merge(&set->updates[i], update);
+        }
+        else
+        {
+            set->updates[i] = *update;
+        }
+    }
+    set->mask |= mask;
+    return superseded;
+}
+
+static uint32_t segment_mask(int segment)
+{
+    return (segment == LED_SEGMENT_ALL) ? LED_SEGMENT_MASK_ALL : (1u << segment);
+}
+
+static bool mailbox_post_set(const led_update_set_t *set)
+{
+    if (led_state.task == NULL)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL(&led_mailbox_lock);
+    bool superseded = led_mailbox.stream;
+    led_mailbox.stream = false; // led/effect saem do modo stream
+    led_mailbox.timeline.pending = true; // e param a timeline
+    led_mailbox.timeline.control = LED_TIMELINE_STOP;
+    for (int i = 0; i < LED_MAX_SEGMENTS; i++)
+    {
+        if (set->mask & (1u << i))
+        {
+            superseded |= update_set_merge(&led_mailbox.set, 1u << i, &set->updates[i]);
+        }
+    }
+    if (superseded)
+    {
+        led_mailbox.stats.superseded++;
+    }
+    led_mailbox.stats.posted++;
+    taskEXIT_CRITICAL(&led_mailbox_lock);
+
+    xTaskNotify(led_state.task, LED_NOTIFY_UPDATE, eSetBits);
+    return true;
+}
+
+static bool mailbox_post(int segment, const led_update_t *update)
+{
+    led_update_set_t set = {0};
+    update_set_merge(&set, segment_mask(segment), update);
+    return mailbox_post_set(&set);
+}
+
+static bool mailbox_post_stream(void)
+{
+    if (led_state.task == NULL)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL(&led_mailbox_lock);
+    if (led_mailbox.stream)
+    {
+        led_mailbox.stats.superseded++;
+    }
+    led_mailbox.stream = true;
+    led_mailbox.timeline.pending = true;
+    led_mailbox.timeline.control = LED_TIMELINE_STOP;
+    led_mailbox.stats.posted++;
+    taskEXIT_CRITICAL(&led_mailbox_lock);
+
+    xTaskNotify(led_state.task, LED_NOTIFY_UPDATE, eSetBits);
+    return true;
+}
+
+static bool mailbox_post_timeline(bool load, led_timeline_control_t control, uint32_t position_ms)
+{
+    if (led_state.task == NULL)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL(&led_mailbox_lock);
+    led_timeline_request_t *request = &led_mailbox.timeline;
+    if (request->pending)
+    {
+        led_mailbox.stats.superseded++;
+    }
+    request->pending = true;
+    request->load |= load; // um load pendente não se perde com o controle seguinte
+    request->control = control;
+    request->position_ms = position_ms;
+    led_mailbox.stats.posted++;
+    taskEXIT_CRITICAL(&led_mailbox_lock);
+
+    xTaskNotify(led_state.task, LED_NOTIFY_UPDATE, eSetBits);
+    return true;
+}
+
+// Na led_task, antes de renderizar: aplica o estágio de saída pendente.
+static void output_take(void)
+{
+    taskENTER_CRITICAL(&led_mailbox_lock);
+    led_output_request_t request = led_mailbox.output;
+    led_mailbox.output.pending = false;
+    taskEXIT_CRITICAL(&led_mailbox_lock);
+
+    if (request.pending)
+    {
+        led_output.brightness = request.brightness;
+        led_output.max_milliamps = request.max_milliamps;
+        output_build_lut();
+    }
+}
+
+static bool mailbox_take(led_update_set_t *set, bool *stream, led_timeline_request_t *timeline)
+{
+    taskENTER_CRITICAL(&led_mailbox_lock);
+    bool pending = led_mailbox.set.mask != 0 || led_mailbox.stream || led_mailbox.timeline.pending;
+    *set = led_mailbox.set;
+    *stream = led_mailbox.stream;
+    *timeline = led_mailbox.timeline;
+    led_mailbox.set.mask = 0;
+    led_mailbox.stream = false;
+    memset(&led_mailbox.timeline, 0, sizeof(led_mailbox.timeline));
+    taskEXIT_CRITICAL(&led_mailbox_lock);
+    return pending;
+}
+
+// Renderiza todos os segmentos (efeito ou cor sólida, mais a transição em
+// andamento) em led_frame, sem enviar. Retorna true se algum segmento ainda
+// precisa de frames.
+static bool segments_compose(const led_layout_t *layout, int64_t now)
+{
+    bool animating = false;
+    for (int i = 0; i < layout->count; i++)
+    {
+        const led_segment_t *seg = &layout->segments[i];
+        led_segment_state_t *state = &led_segment_states[i];
+        if (state->effect &&
+            effect_render(state, seg->start, seg->length, seg->reversed, segment_step(state, now)))
+        {
+            animating = true;
+        }
+        else
+        {
+            frame_fill(led_frame, seg->start, seg->length, &state->solid);
+        }
+
+        if (transition_apply(&state->transition, seg, now))
+        {
+            animating = true;
+        }
+    }
+    return animating;
+}
+
+// Compõe e envia o frame num único refresh.
+static bool segments_render(const led_layout_t *layout, int64_t now)
+{
+    if (!led_state.config_ready)
+    {
+        return false;
+    }
+
+    bool animating = segments_compose(layout, now);
+    frame_flush(led_frame);
+    return animating;
+}
+
+static void segment_apply(led_segment_state_t *state, const led_segment_t *seg, const led_update_t *update,
+                          int64_t now)
+{
+    if (update->has_color)
+    {
+        state->solid = update->color;
+        state->effect = NULL;
+        led_state.last_color = update->color;
+    }
+    if (update->has_effect)
+    {
+        effect_instance_set(state, update->effect, &update->params);
+        state->origin_us = now; // step 0 = agora
+    }
+    // Snapshot antes do primeiro frame do novo alvo, que sai já, sem esperar
+    // o próximo prazo.
+    transition_start(&state->transition, seg, update->transition_ms, now);
+}
+
+// ===================== TIMELINE (tocada na led_task) =====================
+
+static void timeline_set_status(led_timeline_state_t state, uint32_t position_ms)
+{
+    taskENTER_CRITICAL(&led_timeline_lock);
+    led_timeline_status_t *status = &led_timeline.status;
+    status->state = state;
+    status->position_ms = position_ms;
+    status->keyframes = led_timeline.count;
+    status->duration_ms = led_timeline.duration_ms;
+    taskEXIT_CRITICAL(&led_timeline_lock);
+}
+
+// Troca para a timeline publicada, se houver.
+static void timeline_swap(void)
+{
+    taskENTER_CRITICAL(&led_timeline_lock);
+    if (led_timeline.published)
+    {
+        int front = led_timeline.ready;
+        led_timeline.ready = led_timeline.front;
+        led_timeline.front = front;
+        led_timeline.published = false;
+        led_timeline.keyframes = led_timeline.buffers[front];
+        led_timeline.count = led_timeline.published_count;
+        led_timeline.duration_ms = led_timeline.published_duration_ms;
+        led_timeline.loop = led_timeline.published_loop;
+        led_timeline.status.loops = 0;
+    }
+    taskEXIT_CRITICAL(&led_timeline_lock);
+}
+
+// Toca a partir de position_ms: os keyframes anteriores são reaplicados no
+// próximo avanço, cada um no seu horário previsto (transições já terminadas
+// chegam direto ao alvo; efeitos ficam na fase certa).
+static void timeline_seek(int64_t now, uint32_t position_ms)
+{
+    if (led_timeline.count == 0)
+    {
+        timeline_set_status(LED_TIMELINE_STOPPED, 0);
+        return;
+    }
+    if (led_timeline.loop && led_timeline.duration_ms > 0)
+    {
+        position_ms %= led_timeline.duration_ms;
+    }
+    led_timeline.origin_us = now - (int64_t)position_ms * 1000;
+    led_timeline.next = 0;
+    timeline_set_status(LED_TIMELINE_PLAYING, position_ms);
+}
+
+static void timeline_request(const led_timeline_request_t *request, int64_t now)
+{
+    if (request->load)
+    {
+        timeline_swap();
+    }
+
+    led_timeline_state_t state = led_timeline.status.state;
+    switch (request->control)
+    {
+        case LED_TIMELINE_PLAY:
+            if (state == LED_TIMELINE_PAUSED)
+            {
+                led_timeline.origin_us = now - (int64_t)led_timeline.status.position_ms * 1000;
+                timeline_set_status(LED_TIMELINE_PLAYING, led_timeline.status.position_ms);
+            }
+            else if (state == LED_TIMELINE_STOPPED)
+            {
+                led_timeline.status.loops = 0;
+                timeline_seek(now, 0);
+            }
+            break;
+        case LED_TIMELINE_SEEK:
+            timeline_seek(now, request->position_ms);
+            break;
+        case LED_TIMELINE_PAUSE:
+            if (state == LED_TIMELINE_PLAYING)
+            {
+                timeline_set_status(LED_TIMELINE_PAUSED, (uint32_t)((now - led_timeline.origin_us) / 1000));
+            }
+            break;
+        case LED_TIMELINE_STOP:
+            if (state != LED_TIMELINE_STOPPED)
+            {
+                timeline_set_status(LED_TIMELINE_STOPPED, led_timeline.status.position_ms);
+            }
+            break;
+    }
+}
+
+static void keyframe_apply(const led_keyframe_t *keyframe, const led_layout_t *layout, int64_t at_us)
+{
+    led_update_t update = { .transition_ms = keyframe->transition_ms };
+    if (keyframe->has_effect)
+    {
+        update.has_effect = true;
+        update.effect = (keyframe->effect && keyframe->effect->render) ? keyframe->effect : NULL;
+        update.params = keyframe->params;
+    }
+    else
+    {
+        update.has_color = true;
+        update.color = keyframe->color;
+    }
+
+    uint32_t mask = segment_mask(keyframe->segment);
+    for (int i = 0; i < LED_MAX_SEGMENTS; i++)
+    {
+        if (mask & (1u << i))
+        {
+            segment_apply(&led_segment_states[i], &layout->segments[i], &update, at_us);
+        }
+    }
+}
+
+// Aplica os keyframes que venceram até now, cada um ancorado no seu horário
+// previsto, e dá a volta no fim com loop. Retorna true enquanto a timeline
+// estiver tocando.
+static bool timeline_advance(const led_layout_t *layout, int64_t now)
+{
+    if (led_timeline.status.state != LED_TIMELINE_PLAYING)
+    {
+        return false;
+    }
+
+    int64_t duration_us = (int64_t)led_timeline.duration_ms * 1000;
+    bool behind = false;
+    while (1)
+    {
+        while (led_timeline.next < led_timeline.count)
+        {
+            const led_keyframe_t *keyframe = &led_timeline.keyframes[led_timeline.next];
+            int64_t at_us = led_timeline.origin_us + (int64_t)keyframe->at_ms * 1000;
+            if (at_us > now)
+            {
+                break;
+            }
+            // Vários keyframes de uma vez (seek, frame atrasado): a transição
+            // parte do que a timeline mostraria em at_us, não do último frame
+            // enviado.
+            if (behind && keyframe->transition_ms > 0 && led_state.config_ready)
+            {
+                segments_compose(layout, at_us);
+                led_displayed = led_frame;
+            }
+            keyframe_apply(keyframe, layout, at_us);
+            led_timeline.next++;
+            behind = true;
+        }
+
+        if (led_timeline.next < led_timeline.count || now < led_timeline.origin_us + duration_us)
+        {
+            break;
+        }
+        if (!led_timeline.loop || duration_us == 0)
+        {
+            timeline_set_status(LED_TIMELINE_STOPPED, led_timeline.duration_ms);
+            return false;
+        }
+
+        // Próxima volta; voltas inteiras perdidas (task parada) são puladas.
+        int64_t cycles = (now - led_timeline.origin_us) / duration_us;
+        led_timeline.origin_us += cycles * duration_us;
+        led_timeline.next = 0;
+        taskENTER_CRITICAL(&led_timeline_lock);
+        led_timeline.status.loops += (uint32_t)cycles;
+        taskEXIT_CRITICAL(&led_timeline_lock);
+    }
+
+    timeline_set_status(LED_TIMELINE_PLAYING, (uint32_t)((now - led_timeline.origin_us) / 1000));
+    return true;
+}
+
+bool led_controller_timeline_tick(int64_t now_us)
+{
+    taskENTER_CRITICAL(&led_mailbox_lock);
+    led_timeline_request_t request = led_mailbox.timeline;
+    memset(&led_mailbox.timeline, 0, sizeof(led_mailbox.timeline));
+    taskEXIT_CRITICAL(&led_mailbox_lock);
+
+    led_layout_t layout;
+    layout_snapshot(&layout);
+    if (request.pending)
+    {
+        timeline_request(&request, now_us);
+    }
+    bool playing = timeline_advance(&layout, now_us);
+    segments_render(&layout, now_us);
+    return playing;
+}
+
+static bool control_apply(const led_control_t *control);
+
+// Toda a animação vive aqui: a task dorme até receber estado novo pela caixa de
+// correio ou, com um efeito ou transição em andamento em algum segmento, o
+// tick do agendador a cada prazo de frame.
+static void led_task(void *arg)
+{
+    led_layout_t layout;
+    bool streaming = false;
+    led_state.task_running = true;
+
+    while (1)
+    {
+        uint32_t bits = 0;
+        if (xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY) != pdTRUE)
+        {
+            continue;
+        }
+
+        output_take();
+        if (bits & LED_NOTIFY_CONTROL)
+        {
+            bool ok = control_apply(&led_control);
+            streaming = false; // os buffers do stream foram descartados
+            xQueueSend(led_control_done, &ok, portMAX_DELAY);
+        }
+
+        led_update_set_t set;
+        bool stream = false;
+        led_timeline_request_t timeline;
+        bool animating = false;
+        bool frame_due = (bits & LED_NOTIFY_FRAME) && led_sched.running;
+        if ((bits & LED_NOTIFY_UPDATE) && mailbox_take(&set, &stream, &timeline))
+        {
+            layout_snapshot(&layout);
+            // Tick que chegou junto com a atualização: o render abaixo é o frame
+            // dele, então o prazo avança aqui (senão o próximo tick contaria
+            // como prazo perdido).
+            int64_t now = frame_due ? scheduler_frame() : esp_timer_get_time();
+            for (int i = 0; i < LED_MAX_SEGMENTS; i++)
+            {
+                if (set.mask & (1u << i))
+                {
+                    segment_apply(&led_segment_states[i], &layout.segments[i], &set.updates[i], now);
+                }
+            }
+            if (timeline.pending)
+            {
+                timeline_request(&timeline, now);
+            }
+
+            if (stream)
+            {
+                // O stream ocupa a fita inteira: efeitos e transições param.
+                for (int i = 0; i < LED_MAX_SEGMENTS; i++)
+                {
+                    led_segment_states[i].effect = NULL;
+                    led_segment_states[i].transition.active = false;
+                }
+                streaming = true;
+                led_controller_stream_render();
+            }
+            else if (streaming && set.mask == 0 && led_timeline.status.state != LED_TIMELINE_PLAYING)
+            {
+                continue; // pause/stop da timeline não tiram a fita do stream
+            }
+            else
+            {
+                streaming = false;
+                bool playing = timeline_advance(&layout, now);
+                animating = segments_render(&layout, now) || playing;
+            }
+        }
+        else if (frame_due && !streaming)
+        {
+            layout_snapshot(&layout);
+            int64_t now = scheduler_frame();
+            bool playing = timeline_advance(&layout, now);
+            animating = segments_render(&layout, now) || playing;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (animating)
+        {
+            scheduler_start(esp_timer_get_time());
+        }
+        else
+        {
+            scheduler_stop(); // nada animando (ou transição para cor sólida terminou)
+        }
+    }
+}
 
-// Mensagens enviadas para a led_task: ou uma cor sólida, ou um comando de efeito.
-typedef enum {
-    LED_MSG_COLOR = 0,
-    LED_MSG_EFFECT
-} led_msg_type_t;
+// ===================== STREAM (frames por pixel do servidor) =====================
 
-typedef struct {
-    led_msg_type_t type;
-    led_color_t color;      // cor sólida (COLOR) ou cor base do efeito (EFFECT)
-    led_effect_t effect;    // usado quando type == LED_MSG_EFFECT
-} led_msg_t;
+static bool stream_alloc(int led_count)
+{
+    taskENTER_CRITICAL(&led_stream_lock);
+    uint8_t *old[2] = {led_stream.buffers[0], led_stream.buffers[1]};
+    led_stream_stats_t stats = led_stream.stats;
+    uint64_t latency_total_us = led_stream.latency_total_us;
+    memset(&led_stream, 0, sizeof(led_stream));
+    led_stream.stats = stats;
+    led_stream.latency_total_us = latency_total_us;
+    taskEXIT_CRITICAL(&led_stream_lock);
 
-typedef struct {
-    led_strip_handle_t strip;
-    QueueHandle_t queue;
-    int count;
-    int pin;
-    led_strip_type_t type;
-    bool config_ready;
-    led_color_t last_color;
-} led_controller_state_t;
+    free(old[0]);
+    free(old[1]);
 
-static led_controller_state_t led_state = {
-    .strip = NULL,
-    .queue = NULL,
-    .count = 0,
-    .pin = -1,
-    .type = LED_STRIP_TYPE_WS2812B,
-    .config_ready = false,
-    .last_color = {0}
-};
+    size_t size = (size_t)led_count * FRAME_BYTES_PER_PIXEL;
+    uint8_t *a = calloc(1, size);
+    uint8_t *b = calloc(1, size);
+    if (!a || !b)
+    {
+        free(a);
+        free(b);
+        return false;
+    }
+
+    led_stream.buffers[0] = a;
+    led_stream.buffers[1] = b;
+    led_stream.back_is_latest = true;
+    return true;
+}
 
-static led_model_t led_model_from_type(led_strip_type_t type)
+static bool seq_is_older(uint16_t seq, uint16_t reference)
 {
-    return (type == LED_STRIP_TYPE_SK6812) ? LED_MODEL_SK6812 : LED_MODEL_WS2812;
+    return (int16_t)(seq - reference) < 0;
 }
 
-static bool led_apply_color(const led_color_t *color)
+bool led_controller_stream_write(uint16_t seq, uint16_t offset, const uint8_t *pixels, int pixel_count,
+                                 bool rgbw, bool push)
 {
-    if (!led_state.strip || !led_state.config_ready)
+    if (!led_state.config_ready || !led_stream.buffers[0] || pixel_count < 0 ||
+        (pixel_count > 0 && !pixels) || (int)offset + pixel_count > led_state.count)
     {
         return false;
     }
 
-    for (int i = 0; i < led_state.count; i++)
+    int64_t now = esp_timer_get_time();
+
+    if (!led_stream.building || seq != led_stream.building_seq)
     {
-        if (led_state.type == LED_STRIP_TYPE_SK6812)
+        bool idle = (now - led_stream.last_push_us) > STREAM_IDLE_RESET_US;
+        uint16_t reference = led_stream.building ? led_stream.building_seq : led_stream.last_seq;
+        bool has_reference = led_stream.building || led_stream.has_last_seq;
+        if (has_reference && !idle && (seq == reference || seq_is_older(seq, reference)))
         {
-            led_strip_set_pixel_rgbw(led_state.strip, i, color->red, color->green, color->blue, color->white);
+            led_stream.stats.frames_stale++;
+            return true;
         }
-        else
+
+        if (led_stream.building)
+        {
+            led_stream.stats.frames_overrun++; // frame anterior nunca recebeu push
+        }
+
+        taskENTER_CRITICAL(&led_stream_lock);
+        if (led_stream.published)
+        {
+            // A led_task ainda não pegou o frame anterior: ele sai da fila e o
+            // novo é montado por cima (back continua sendo o mais recente).
+            led_stream.published = false;
+            led_stream.stats.frames_overrun++;
+        }
+        int back = led_stream.back;
+        bool back_is_latest = led_stream.back_is_latest;
+        taskEXIT_CRITICAL(&led_stream_lock);
+
+        if (!back_is_latest)
         {
-            led_strip_set_pixel(led_state.strip, i, color->red, color->green, color->blue);
+            // Pedaços parciais se aplicam sobre o último frame publicado.
+            memcpy(led_stream.buffers[back], led_stream.buffers[!back],
+                   (size_t)led_state.count * FRAME_BYTES_PER_PIXEL);
+            led_stream.back_is_latest = true;
         }
+
+        led_stream.building = true;
+        led_stream.building_seq = seq;
+        led_stream.building_started_us = now;
     }
 
-    esp_err_t err = led_strip_refresh(led_state.strip);
-    if (err != ESP_OK)
+    uint8_t *dst = led_stream.buffers[led_stream.back] + (size_t)offset * FRAME_BYTES_PER_PIXEL;
+    if (rgbw)
     {
-        ESP_LOGE(TAG, "Failed to refresh LED strip: %s", esp_err_to_name(err));
-        return false;
+        memcpy(dst, pixels, (size_t)pixel_count * FRAME_BYTES_PER_PIXEL);
+    }
+    else
+    {
+        for (int i = 0; i < pixel_count; i++, dst += FRAME_BYTES_PER_PIXEL, pixels += 3)
+        {
+            dst[0] = pixels[0];
+            dst[1] = pixels[1];
+            dst[2] = pixels[2];
+            dst[3] = 0;
+        }
     }
 
-    led_state.last_color = *color;
+    if (!push)
+    {
+        return true;
+    }
+
+    led_stream.building = false;
+    led_stream.has_last_seq = true;
+    led_stream.last_seq = seq;
+    led_stream.last_push_us = now;
+
+    taskENTER_CRITICAL(&led_stream_lock);
+    led_stream.published = true;
+    led_stream.published_started_us = led_stream.building_started_us;
+    taskEXIT_CRITICAL(&led_stream_lock);
+
+    // Passa pela caixa de correio para manter a ordem em relação a led/effect.
+    mailbox_post_stream();
     return true;
 }
 
-// ===================== EFEITOS (renderizados na led_task) =====================
-
-// HSV -> RGB inteiro (h,s,v em 0..255). Estilo clássico de 6 setores.
-static led_color_t hsv_to_rgb(uint8_t h, uint8_t s, uint8_t v)
+void led_controller_stream_render(void)
 {
-    led_color_t c = {0, 0, 0, 0};
-    uint8_t region = h / 43;                 // 0..5
-    uint8_t rem = (uint8_t)((h - region * 43) * 6);
-    uint8_t p = (uint8_t)((v * (255 - s)) / 255);
-    uint8_t q = (uint8_t)((v * (255 - (s * rem) / 255)) / 255);
-    uint8_t t = (uint8_t)((v * (255 - (s * (255 - rem)) / 255)) / 255);
+    taskENTER_CRITICAL(&led_stream_lock);
+    if (!led_stream.published)
+    {
+        taskEXIT_CRITICAL(&led_stream_lock);
+        return;
+    }
+    int front = led_stream.back;
+    led_stream.back = !front;
+    led_stream.back_is_latest = false;
+    led_stream.published = false;
+    int64_t started_us = led_stream.published_started_us;
+    taskEXIT_CRITICAL(&led_stream_lock);
+
+    if (!led_state.config_ready)
+    {
+        return;
+    }
+
+    if (!frame_flush(led_stream.buffers[front]))
+    {
+        return;
+    }
 
-    switch (region)
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - started_us);
+    led_stream_stats_t *stats = &led_stream.stats;
+    stats->frames_rendered++;
+    stats->last_latency_us = latency;
+    if (latency > stats->max_latency_us)
     {
-        case 0:  c.red = v; c.green = t; c.blue = p; break;
-        case 1:  c.red = q; c.green = v; c.blue = p; break;
-        case 2:  c.red = p; c.green = v; c.blue = t; break;
-        case 3:  c.red = p; c.green = q; c.blue = v; break;
-        case 4:  c.red = t; c.green = p; c.blue = v; break;
-        default: c.red = v; c.green = p; c.blue = q; break;
+        stats->max_latency_us = latency;
     }
-    return c;
+    led_stream.latency_total_us += latency;
+    stats->avg_latency_us = (uint32_t)(led_stream.latency_total_us / stats->frames_rendered);
 }
 
-// Escala um canal pelo nível mantendo piso 1 quando o canal é não-nulo,
-// para que o breathing nunca chegue a apagar a fita.
-static uint8_t scale_channel_min1(uint8_t base, uint8_t level)
+void led_controller_get_stream_stats(led_stream_stats_t *stats)
 {
-    if (base == 0)
+    if (stats)
     {
-        return 0;
+        *stats = led_stream.stats;
     }
-    uint16_t v = ((uint16_t)base * level) / 255;
-    return (v < 1) ? 1 : (uint8_t)v;
 }
 
-static void effect_fill(led_color_t c)
+void led_controller_get_frame_stats(led_frame_stats_t *stats)
 {
-    for (int i = 0; i < led_state.count; i++)
+    if (stats)
     {
-        if (led_state.type == LED_STRIP_TYPE_SK6812)
-        {
-            led_strip_set_pixel_rgbw(led_state.strip, i, c.red, c.green, c.blue, 0);
-        }
-        else
-        {
-            led_strip_set_pixel(led_state.strip, i, c.red, c.green, c.blue);
-        }
+        *stats = led_frame_stats;
     }
 }
 
-// Renderiza um frame do efeito. NÃO mexe em last_color (a cor sólida fica
-// preservada para quando o efeito for interrompido).
-static void effect_render(led_effect_t effect, const led_color_t *base, uint16_t step)
+void led_controller_get_scheduler_stats(led_scheduler_stats_t *stats)
 {
-    if (!led_state.strip || !led_state.config_ready || led_state.count <= 0)
+    if (stats)
     {
-        return;
+        *stats = led_sched.stats;
     }
+}
 
-    switch (effect)
+void led_controller_get_mailbox_stats(led_mailbox_stats_t *stats)
+{
+    if (stats)
     {
-        case LED_EFFECT_BREATHING:
-        {
-            // Onda senoidal mapeada para [BREATHING_MIN .. 255]. Nunca apaga:
-            // o piso garante brilho mínimo e scale_channel_min1 mantém >= 1.
-            float phase = (float)(step % 1024) / 1024.0f * 2.0f * (float)M_PI;
-            float wave = (sinf(phase) + 1.0f) / 2.0f; // 0..1
-            const uint8_t BREATHING_MIN = 6;          // piso de brilho (~2%)
-            uint8_t level = (uint8_t)(BREATHING_MIN + wave * (255 - BREATHING_MIN));
-            led_color_t c = {
-                scale_channel_min1(base->red, level),
-                scale_channel_min1(base->green, level),
-                scale_channel_min1(base->blue, level),
-                0
-            };
-            effect_fill(c);
-            break;
-        }
-        case LED_EFFECT_RAINBOW:
-        {
-            for (int i = 0; i < led_state.count; i++)
-            {
-                uint8_t h = (uint8_t)(step + (i * 256) / led_state.count);
-                led_color_t c = hsv_to_rgb(h, 255, 255);
-                if (led_state.type == LED_STRIP_TYPE_SK6812)
-                {
-                    led_strip_set_pixel_rgbw(led_state.strip, i, c.red, c.green, c.blue, 0);
-                }
-                else
-                {
-                    led_strip_set_pixel(led_state.strip, i, c.red, c.green, c.blue);
-                }
-            }
-            break;
-        }
-        case LED_EFFECT_FADE:
-        {
-            led_color_t c = hsv_to_rgb((uint8_t)step, 255, 255);
-            effect_fill(c);
-            break;
-        }
-        default:
-            return;
+        taskENTER_CRITICAL(&led_mailbox_lock);
+        *stats = led_mailbox.stats;
+        taskEXIT_CRITICAL(&led_mailbox_lock);
     }
-
-    led_strip_refresh(led_state.strip);
 }
 
-static uint16_t effect_step_increment(led_effect_t effect)
+void led_controller_set_output(uint8_t brightness, uint32_t max_milliamps)
 {
-    switch (effect)
+    taskENTER_CRITICAL(&led_mailbox_lock);
+    led_mailbox.output = (led_output_request_t){ .pending = true, .brightness = brightness,
+                                                 .max_milliamps = max_milliamps };
+    taskEXIT_CRITICAL(&led_mailbox_lock);
+
+    // Sem a led_task (build de host) a tabela é refeita aqui.
+    if (!led_state.task_running)
     {
-        // Breathing usa ciclo de 1024 passos; incremento 3 => ~6.8s por respiração
-        case LED_EFFECT_BREATHING: return 3;
-        case LED_EFFECT_RAINBOW:   return 2;
-        case LED_EFFECT_FADE:      return 1;
-        default:                   return 0;
+        output_take();
+        return;
     }
+    xTaskNotify(led_state.task, LED_NOTIFY_UPDATE, eSetBits);
 }
 
-// Toda a animação vive aqui: a task fica bloqueada na fila quando ocioso e,
-// quando um efeito está ativo, acorda a cada frame para renderizar.
-static void led_task(void *arg)
+void led_controller_get_power_stats(led_power_stats_t *stats)
 {
-    led_msg_t msg;
-    led_effect_t active = LED_EFFECT_NONE;
-    led_color_t base = {255, 255, 255, 0};
-    led_color_t solid = {0, 0, 0, 0};
-    uint16_t step = 0;
+    if (stats)
+    {
+        *stats = led_output.stats;
+    }
+}
 
-    const TickType_t frame_ticks = pdMS_TO_TICKS(EFFECT_FRAME_MS);
+bool led_controller_start(void)
+{
+    output_build_lut();
 
-    while (1)
+    if (led_control_done == NULL)
     {
-        TickType_t wait = (active == LED_EFFECT_NONE) ? portMAX_DELAY : frame_ticks;
-
-        if (xQueueReceive(led_state.queue, &msg, wait) == pdTRUE)
-        {
-            if (msg.type == LED_MSG_COLOR)
-            {
-                active = LED_EFFECT_NONE;
-                solid = msg.color;
-                led_apply_color(&msg.color);
-            }
-            else // LED_MSG_EFFECT
-            {
-                active = msg.effect;
-                base = msg.color;
-                step = 0;
-                if (active == LED_EFFECT_NONE)
-                {
-                    led_apply_color(&solid); // restaura cor sólida
-                }
-            }
-        }
-        else
+        led_control_done = xQueueCreate(1, sizeof(bool));
+        if (led_control_done == NULL)
         {
-            // timeout -> próximo frame do efeito
-            effect_render(active, &base, step);
-            step += effect_step_increment(active);
+            ESP_LOGE(TAG, "Failed to create LED control queue");
+            return false;
         }
     }
-}
 
-bool led_controller_start(void)
-{
-    if (led_state.queue == NULL)
+    if (led_sched.timer == NULL)
     {
-        led_state.queue = xQueueCreate(LED_QUEUE_LENGTH, sizeof(led_msg_t));
-        if (led_state.queue == NULL)
+        const esp_timer_create_args_t timer_args = {
+            .callback = frame_timer_callback,
+            .arg = NULL,
+            .name = "led_frame",
+        };
+        if (esp_timer_create(&timer_args, &led_sched.timer) != ESP_OK)
         {
-            ESP_LOGE(TAG, "Failed to create LED queue");
+            ESP_LOGE(TAG, "Failed to create LED frame timer");
             return false;
         }
     }
@@ -266,7 +1582,7 @@ bool led_controller_start(void)
         4096,
         NULL,
         5,
-        NULL,
+        &led_state.task,
         1);
 
     if (task_created != pdPASS)
@@ -279,106 +1595,371 @@ bool led_controller_start(void)
     return true;
 }
 
-bool led_controller_configure(int led_pin, int led_count, led_strip_type_t led_type)
+static void channels_release(void)
+{
+    for (int c = 0; c < led_state.channel_count; c++)
+    {
+        led_channel_t *channel = &led_state.channels[c];
+        channel->backend->deinit(channel->ctx);
+        channel->ctx = NULL;
+    }
+    led_state.channel_count = 0;
+    led_state.config_ready = false;
+}
+
+static const led_backend_t *const led_backends[] = {
+    &led_backend_rmt,
+    &led_backend_spi,
+};
+
+const led_backend_t *led_controller_find_backend(const char *name, int name_len)
+{
+    for (size_t i = 0; i < sizeof(led_backends) / sizeof(led_backends[0]); i++)
+    {
+        const char *backend_name = led_backends[i]->name;
+        if (name_len >= 0 && strlen(backend_name) == (size_t)name_len && memcmp(backend_name, name, name_len) == 0)
+        {
+            return led_backends[i];
+        }
+    }
+    return NULL;
+}
+
+static const led_backend_t *output_backend(const led_output_config_t *output)
+{
+    return output->backend ? output->backend : &led_backend_rmt;
+}
+
+static bool channel_create(led_channel_t *channel, const led_output_config_t *output, int instances)
 {
-    if (led_pin < 0 || led_count <= 0)
+    channel->backend = output_backend(output);
+    esp_err_t err = channel->backend->init(output, instances, &channel->ctx);
+    if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "Invalid LED config (pin=%d count=%d)", led_pin, led_count);
+        ESP_LOGE(TAG, "Failed to create %s LED output on pin %d: %s", channel->backend->name, output->pin,
+                 esp_err_to_name(err));
+        channel->ctx = NULL;
         return false;
     }
 
-    if (led_state.strip != NULL)
+    channel->pin = output->pin;
+    channel->count = output->count;
+    channel->type = output->type;
+    return true;
+}
+
+// Na led_task: troca canais e framebuffers e apaga a fita, ou troca o layout.
+static bool control_apply(const led_control_t *control)
+{
+    if (control->kind == LED_CONTROL_SEGMENTS)
     {
-        led_strip_clear(led_state.strip);
-        led_strip_del(led_state.strip);
-        led_state.strip = NULL;
-        led_state.config_ready = false;
+        layout_set(&control->layout);
+        return true;
     }
 
-    led_strip_config_t strip_config = {
-        .strip_gpio_num = led_pin,
-        .max_leds = led_count,
-        .led_model = led_model_from_type(led_type),
-        .color_component_format = (led_type == LED_STRIP_TYPE_SK6812)
-            ? LED_STRIP_COLOR_COMPONENT_FMT_GRBW
-            : LED_STRIP_COLOR_COMPONENT_FMT_GRB,
-        .flags = {
-            .invert_out = false,
-        },
-    };
+    const led_output_config_t *outputs = control->outputs;
+    int output_count = control->output_count;
+    int led_count = 0;
+    for (int i = 0; i < output_count; i++)
+    {
+        led_count += outputs[i].count;
+    }
 
-    led_strip_rmt_config_t rmt_config = {
-        .clk_src = RMT_CLK_SRC_DEFAULT,
-        .resolution_hz = 10 * 1000 * 1000,
-        // ESP32 não tem RMT-DMA: o buffer é realimentado por ISR durante a
-        // transmissão. Buffer maior => menos refills => menos glitches (LEDs
-        // "piscando") quando o WiFi disputa o barramento/interrupções.
-        // 256 symbols = 4 blocos de 64 words (~10 LEDs de folga por refill).
-        .mem_block_symbols = 256,
-        .flags = {
-            .with_dma = false,
-        },
-    };
+    channels_release();
 
-    esp_err_t err = led_strip_new_rmt_device(&strip_config, &rmt_config, &led_state.strip);
-    if (err != ESP_OK)
+    for (int i = 0; i < output_count; i++)
+    {
+        // Saídas que dividem o mesmo backend (ex.: memória RMT).
+        int instances = 0;
+        for (int j = 0; j < output_count; j++)
+        {
+            instances += (output_backend(&outputs[j]) == output_backend(&outputs[i]));
+        }
+
+        led_channel_t *channel = &led_state.channels[i];
+        if (!channel_create(channel, &outputs[i], instances))
+        {
+            channels_release();
+            return false;
+        }
+        channel->start = (i > 0) ? led_state.channels[i - 1].start + led_state.channels[i - 1].count : 0;
+        led_state.channel_count++;
+    }
+
+    if (!frame_alloc(led_count) || !stream_alloc(led_count))
     {
-        ESP_LOGE(TAG, "Failed to create LED strip: %s", esp_err_to_name(err));
-        led_state.strip = NULL;
-        led_state.config_ready = false;
+        ESP_LOGE(TAG, "Failed to allocate framebuffers (%d LEDs)", led_count);
+        channels_release();
         return false;
     }
 
-    led_state.pin = led_pin;
     led_state.count = led_count;
-    led_state.type = led_type;
     led_state.config_ready = true;
 
-    ESP_LOGI(TAG, "LED strip configured: pin=%d, count=%d, type=%d", led_pin, led_count, led_type);
+    // Até set_segments, um segmento único cobre a fita inteira.
+    led_layout_t layout = { .count = 1, .segments = {{ .start = 0, .length = led_count }} };
+    layout_set(&layout);
+
+    for (int i = 0; i < output_count; i++)
+    {
+        ESP_LOGI(TAG, "LED strip configured: pin=%d, count=%d, type=%d, backend=%s (pixels %d..%d)",
+                 outputs[i].pin, outputs[i].count, outputs[i].type, led_state.channels[i].backend->name,
+                 led_state.channels[i].start, led_state.channels[i].start + outputs[i].count - 1);
+    }
 
     led_color_t off = {0};
     led_apply_color(&off);
-
     return true;
 }
 
-bool led_controller_enqueue(const led_color_t *color, int timeout_ms)
+// Sem a led_task (build de host) quem pede aplica; senão espera a led_task.
+static bool control_request(void)
+{
+    if (!led_state.task_running)
+    {
+        return control_apply(&led_control);
+    }
+
+    xTaskNotify(led_state.task, LED_NOTIFY_CONTROL, eSetBits);
+    bool ok = false;
+    xQueueReceive(led_control_done, &ok, portMAX_DELAY);
+    return ok;
+}
+
+bool led_controller_configure_outputs(const led_output_config_t *outputs, int output_count)
 {
-    if (led_state.queue == NULL || color == NULL)
+    if (!outputs || output_count <= 0 || output_count > LED_MAX_OUTPUTS)
     {
+        ESP_LOGE(TAG, "Invalid LED output count: %d", output_count);
         return false;
     }
 
-    led_msg_t msg = { .type = LED_MSG_COLOR, .color = *color, .effect = LED_EFFECT_NONE };
-    if (xQueueSend(led_state.queue, &msg, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+    for (int i = 0; i < output_count; i++)
+    {
+        if (outputs[i].pin < 0 || outputs[i].count <= 0)
+        {
+            ESP_LOGE(TAG, "Invalid LED config (pin=%d count=%d)", outputs[i].pin, outputs[i].count);
+            return false;
+        }
+        for (int j = 0; j < i; j++)
+        {
+            if (outputs[j].pin == outputs[i].pin)
+            {
+                ESP_LOGE(TAG, "LED pin %d used by more than one output", outputs[i].pin);
+                return false;
+            }
+        }
+    }
+
+    led_control.kind = LED_CONTROL_OUTPUTS;
+    memcpy(led_control.outputs, outputs, (size_t)output_count * sizeof(*outputs));
+    led_control.output_count = output_count;
+    return control_request();
+}
+
+bool led_controller_configure(int led_pin, int led_count, led_strip_type_t led_type)
+{
+    const led_output_config_t output = { .pin = led_pin, .count = led_count, .type = led_type };
+    return led_controller_configure_outputs(&output, 1);
+}
+
+bool led_controller_set_segments(const led_segment_t *segments, int count)
+{
+    if (!led_state.config_ready || count < 0 || count > LED_MAX_SEGMENTS || (count > 0 && !segments))
     {
         return false;
     }
 
+    led_layout_t layout = { .count = 1, .segments = {{ .start = 0, .length = led_state.count }} };
+    if (count > 0)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            const led_segment_t *seg = &segments[i];
+            if (seg->start < 0 || seg->length <= 0 || seg->start + seg->length > led_state.count ||
+                memchr(seg->name, '\0', sizeof(seg->name)) == NULL || seg->name[0] == '\0')
+            {
+                ESP_LOGE(TAG, "Invalid LED segment %d (start=%d length=%d)", i, seg->start, seg->length);
+                return false;
+            }
+            for (int j = 0; j < i; j++)
+            {
+                if (strcmp(segments[j].name, seg->name) == 0)
+                {
+                    ESP_LOGE(TAG, "Duplicate LED segment name: %s", seg->name);
+                    return false;
+                }
+            }
+        }
+        memcpy(layout.segments, segments, (size_t)count * sizeof(*segments));
+        layout.count = count;
+    }
+
+    led_control.kind = LED_CONTROL_SEGMENTS;
+    led_control.layout = layout;
+    if (!control_request())
+    {
+        return false;
+    }
+    ESP_LOGI(TAG, "LED segments configured: %d", layout.count);
     return true;
 }
 
-bool led_controller_set_effect(led_effect_t effect, const led_color_t *base_color, int timeout_ms)
+int led_controller_find_segment(const char *name, int name_len)
+{
+    int found = -1;
+    taskENTER_CRITICAL(&led_layout_lock);
+    for (int i = 0; i < led_layout.count; i++)
+    {
+        const char *seg_name = led_layout.segments[i].name;
+        if (name_len > 0 && (int)strnlen(seg_name, LED_SEGMENT_NAME_MAX) == name_len &&
+            memcmp(seg_name, name, (size_t)name_len) == 0)
+        {
+            found = i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&led_layout_lock);
+    return found;
+}
+
+int led_controller_get_segment_count(void)
+{
+    taskENTER_CRITICAL(&led_layout_lock);
+    int count = led_layout.count;
+    taskEXIT_CRITICAL(&led_layout_lock);
+    return count;
+}
+
+static bool post_update(int segment, const led_update_t *update)
+{
+    if (segment != LED_SEGMENT_ALL && (segment < 0 || segment >= LED_MAX_SEGMENTS))
+    {
+        return false;
+    }
+
+    if (led_batch.active)
+    {
+        update_set_merge(&led_batch.set, segment_mask(segment), update);
+        return true;
+    }
+
+    return mailbox_post(segment, update);
+}
+
+bool led_controller_enqueue(int segment, const led_color_t *color, uint32_t transition_ms)
 {
-    if (led_state.queue == NULL)
+    if (color == NULL)
     {
         return false;
     }
 
-    led_msg_t msg = { .type = LED_MSG_EFFECT, .effect = effect, .color = {255, 255, 255, 0} };
-    if (base_color != NULL)
+    const led_update_t update = { .has_color = true, .color = *color, .transition_ms = transition_ms };
+    return post_update(segment, &update);
+}
+
+bool led_controller_set_effect(int segment, const led_effect_t *effect, const led_effect_params_t *params,
+                               uint32_t transition_ms)
+{
+    // "none" (sem kernel) é o mesmo que nenhum efeito.
+    led_update_t update = {
+        .has_effect = true, .effect = (effect && effect->render) ? effect : NULL, .transition_ms = transition_ms
+    };
+    if (params != NULL)
+    {
+        update.params = *params;
+    }
+    else
     {
-        msg.color = *base_color;
+        led_effect_params_init(effect, &update.params);
     }
 
-    if (xQueueSend(led_state.queue, &msg, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+    return post_update(segment, &update);
+}
+
+// edit só é trocado pela própria task do WS (no commit): sem spinlock.
+led_keyframe_t *led_controller_timeline_edit(void)
+{
+    return led_timeline.buffers[led_timeline.edit];
+}
+
+bool led_controller_timeline_valid(int count, uint32_t duration_ms)
+{
+    if (count < 0 || count > LED_TIMELINE_MAX_KEYFRAMES || duration_ms > LED_TIMELINE_MAX_MS)
     {
         return false;
     }
 
+    const led_keyframe_t *keyframes = led_timeline.buffers[led_timeline.edit];
+    for (int i = 0; i < count; i++)
+    {
+        const led_keyframe_t *keyframe = &keyframes[i];
+        if (keyframe->at_ms > duration_ms || (i > 0 && keyframe->at_ms < keyframes[i - 1].at_ms) ||
+            (keyframe->segment != LED_SEGMENT_ALL && (keyframe->segment < 0 || keyframe->segment >= LED_MAX_SEGMENTS)))
+        {
+            return false;
+        }
+    }
     return true;
 }
 
+bool led_controller_timeline_commit(int count, uint32_t duration_ms, bool loop)
+{
+    if (!led_controller_timeline_valid(count, duration_ms))
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL(&led_timeline_lock);
+    int ready = led_timeline.ready;
+    led_timeline.ready = led_timeline.edit;
+    led_timeline.edit = ready;
+    led_timeline.published = true;
+    led_timeline.published_count = count;
+    led_timeline.published_duration_ms = duration_ms;
+    led_timeline.published_loop = loop;
+    taskEXIT_CRITICAL(&led_timeline_lock);
+
+    return mailbox_post_timeline(true, LED_TIMELINE_SEEK, 0);
+}
+
+bool led_controller_timeline_control(led_timeline_control_t control, uint32_t position_ms)
+{
+    return mailbox_post_timeline(false, control, position_ms);
+}
+
+void led_controller_get_timeline_status(led_timeline_status_t *status)
+{
+    if (status)
+    {
+        taskENTER_CRITICAL(&led_timeline_lock);
+        *status = led_timeline.status;
+        taskEXIT_CRITICAL(&led_timeline_lock);
+    }
+}
+
+void led_controller_batch_begin(void)
+{
+    led_batch.active = true;
+    led_batch.set.mask = 0;
+}
+
+bool led_controller_batch_commit(void)
+{
+    if (!led_batch.active)
+    {
+        return true;
+    }
+
+    led_batch.active = false;
+    if (led_batch.set.mask == 0)
+    {
+        return true; // nada de LED no lote
+    }
+
+    return mailbox_post_set(&led_batch.set);
+}
+
 bool led_controller_is_configured(void)
 {
     return led_state.config_ready;
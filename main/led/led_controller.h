@@ -4,6 +4,18 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// Maior duração aceita para transições de cor/efeito.
+#define LED_TRANSITION_MAX_MS 60000
+
+// Saídas físicas (um pino e um canal RMT cada), atualizadas em paralelo.
+#define LED_MAX_OUTPUTS 4
+
+// Segmentos da fita declarados na config do servidor.
+#define LED_MAX_SEGMENTS 8
+#define LED_SEGMENT_NAME_MAX 16
+// Alvo de enqueue/set_effect que vale para todos os segmentos.
+#define LED_SEGMENT_ALL (-1)
+
 typedef struct
 {
     uint8_t red;
@@ -18,21 +30,209 @@ typedef enum
     LED_STRIP_TYPE_SK6812,
 } led_strip_type_t;
 
-// Efeitos rodam no próprio firmware (animação não-bloqueante na led_task).
+// Efeitos rodam no próprio firmware (animação não-bloqueante na led_task);
+// registro e sentido de cada parâmetro em led_effects.h.
+typedef struct led_effect led_effect_t;
+
+#define LED_EFFECT_MAX_COLORS 4
+
+typedef struct
+{
+    uint8_t speed;
+    uint8_t density;     // 0..255, sentido próprio de cada efeito (cauda, espaçamento, faíscas...)
+    uint8_t palette;     // índice em led_effect_palette_name
+    uint8_t color_count; // >= 1; colors[0] é a cor base
+    led_color_t colors[LED_EFFECT_MAX_COLORS];
+    // Instante do step 0 no relógio de parede (epoch, ms): dispositivos com o
+    // relógio sincronizado e o mesmo startAt animam em fase. 0 = quando a
+    // led_task aplica o efeito.
+    int64_t start_at_ms;
+} led_effect_params_t;
+
+// Transporte de uma saída (RMT, SPI, ...); ver led_backend.h.
+typedef struct led_backend led_backend_t;
+
+// Uma saída física. As saídas formam uma fita lógica única, concatenadas na
+// ordem em que foram configuradas (índices de pixel, segmentos e stream usam
+// essa numeração).
+typedef struct
+{
+    int pin;
+    int count;
+    led_strip_type_t type;
+    const led_backend_t *backend; // NULL = RMT
+} led_output_config_t;
+
+// Timeline: sequência de keyframes tocada pela própria led_task.
+#define LED_TIMELINE_MAX_KEYFRAMES 64
+// Maior instante (atMs/durationMs) aceito numa timeline: 24 h.
+#define LED_TIMELINE_MAX_MS (24u * 60 * 60 * 1000)
+
+// Um passo da timeline: em at_ms (desde o início), o segmento recebe a cor
+// sólida ou o efeito, com transição opcional (mesma semântica de enqueue e
+// set_effect).
+typedef struct
+{
+    uint32_t at_ms;
+    uint32_t transition_ms;
+    int segment; // índice do segmento ou LED_SEGMENT_ALL
+    bool has_effect;
+    led_color_t color;          // !has_effect
+    const led_effect_t *effect; // has_effect (NULL = interrompe o efeito)
+    led_effect_params_t params;
+} led_keyframe_t;
+
 typedef enum
 {
-    LED_EFFECT_NONE = 0,
-    LED_EFFECT_BREATHING,
-    LED_EFFECT_RAINBOW,
-    LED_EFFECT_FADE,
-} led_effect_t;
+    LED_TIMELINE_PLAY = 0, // continua de onde pausou; parada ou no fim, recomeça do início
+    LED_TIMELINE_PAUSE,    // congela a posição; transições e efeitos já iniciados seguem
+    LED_TIMELINE_STOP,     // para onde está; a fita fica no último estado aplicado
+    LED_TIMELINE_SEEK,     // toca a partir de position_ms
+} led_timeline_control_t;
+
+typedef enum
+{
+    LED_TIMELINE_STOPPED = 0,
+    LED_TIMELINE_PLAYING,
+    LED_TIMELINE_PAUSED,
+} led_timeline_state_t;
+
+typedef struct
+{
+    led_timeline_state_t state;
+    uint32_t position_ms; // no último frame tocado
+    int keyframes;
+    uint32_t duration_ms;
+    uint32_t loops;       // voltas completas desde o último load/play
+} led_timeline_status_t;
+
+// Zona da fita com cor/efeito/fase próprios: pixels [start, start + length).
+// reversed inverte o sentido dos efeitos que andam ao longo da fita.
+typedef struct
+{
+    char name[LED_SEGMENT_NAME_MAX];
+    int start;
+    int length;
+    bool reversed;
+} led_segment_t;
+
+// Estatísticas do modo stream (frames por pixel enviados pelo servidor).
+typedef struct
+{
+    uint32_t frames_rendered;
+    uint32_t frames_stale;   // seq mais antiga que a do último frame: descartado
+    uint32_t frames_overrun; // substituído por um mais novo antes de ir para a fita
+    uint32_t last_latency_us; // do primeiro pedaço recebido até o fim do refresh
+    uint32_t max_latency_us;
+    uint32_t avg_latency_us;
+} led_stream_stats_t;
+
+// Envios para a fita: frames idênticos ao último enviado não são transmitidos.
+// refresh_us mede do disparo da primeira saída até o fim da última.
+typedef struct
+{
+    uint32_t transmitted;
+    uint32_t skipped;
+    uint32_t last_refresh_us;
+    uint32_t max_refresh_us;
+} led_frame_stats_t;
+
+// Cadência dos efeitos: atraso de cada frame em relação ao prazo (jitter) e
+// prazos inteiros perdidos (frames que não chegaram a ser renderizados).
+typedef struct
+{
+    uint32_t frames;
+    uint32_t missed_deadlines;
+    uint32_t last_jitter_us;
+    uint32_t avg_jitter_us;
+    uint32_t max_jitter_us;
+} led_scheduler_stats_t;
+
+// Caixa de correio da led_task: posted conta as mudanças de estado recebidas e
+// superseded as que foram sobrescritas por uma mais nova antes de aplicadas.
+typedef struct
+{
+    uint32_t posted;
+    uint32_t superseded;
+} led_mailbox_stats_t;
+
+// Estágio de saída: corrente estimada do último frame (requested_ma antes do
+// limite de consumo, estimated_ma depois) e frames escalados pelo limite.
+typedef struct
+{
+    uint32_t requested_ma;
+    uint32_t estimated_ma;
+    uint32_t peak_ma;
+    uint32_t limited_frames;
+} led_power_stats_t;
 
 bool led_controller_start(void);
+// Fita com uma única saída.
 bool led_controller_configure(int led_pin, int led_count, led_strip_type_t led_type);
-bool led_controller_enqueue(const led_color_t *color, int timeout_ms);
-// Inicia/troca o efeito. base_color é a cor de referência (ex.: breathing).
-// LED_EFFECT_NONE interrompe o efeito e restaura a última cor sólida.
-bool led_controller_set_effect(led_effect_t effect, const led_color_t *base_color, int timeout_ms);
+// Até LED_MAX_OUTPUTS saídas (pinos distintos). Cada refresh dispara todas as
+// saídas alteradas e espera por elas juntas, então o tempo de envio segue a
+// saída mais longa, não o total de LEDs. A troca é feita pela led_task entre
+// dois frames; quem chama espera o resultado.
+bool led_controller_configure_outputs(const led_output_config_t *outputs, int output_count);
+// Backend do firmware pelo nome ("rmt", "spi"), ou NULL.
+const led_backend_t *led_controller_find_backend(const char *name, int name_len);
+// Troca os segmentos da fita (depois de configure, que volta a um segmento
+// único com a fita inteira). count = 0 também volta ao segmento único. Retorna
+// false, sem mudar nada, se algum segmento sai da fita ou repete nome. Como
+// configure, é aplicado pela led_task entre dois frames.
+bool led_controller_set_segments(const led_segment_t *segments, int count);
+// Índice do segmento com esse nome (name não precisa de terminador), ou -1.
+int led_controller_find_segment(const char *name, int name_len);
+int led_controller_get_segment_count(void);
+// Cor sólida e efeito vão para uma caixa de correio com um slot por segmento:
+// se a led_task ainda não aplicou a mudança anterior do segmento, ela é
+// substituída pela nova. segment é o índice do segmento ou LED_SEGMENT_ALL.
+// Nunca bloqueiam; só retornam false antes de led_controller_start.
+// transition_ms > 0 faz a led_task sair do que está na fita e chegar ao novo
+// estado em transition_ms (mistura em luz linear); 0 troca de uma vez.
+bool led_controller_enqueue(int segment, const led_color_t *color, uint32_t transition_ms);
+// Inicia/troca o efeito (de led_effect_find). params NULL usa os padrões do
+// efeito. effect NULL ou "none" interrompe o efeito e restaura a última cor
+// sólida.
+bool led_controller_set_effect(int segment, const led_effect_t *effect, const led_effect_params_t *params,
+                               uint32_t transition_ms);
+// Lote de mudanças (ação batch): entre begin e commit, enqueue/set_effect só
+// registram o estado final, e o commit o entrega à led_task de uma vez,
+// aplicado com um único refresh. Chamados pela mesma task que enfileira.
+void led_controller_batch_begin(void);
+bool led_controller_batch_commit(void);
+// Modo stream: escreve pixel_count pixels consecutivos a partir de offset no
+// frame seq (RGB ou RGBW, 3 ou 4 bytes por pixel). Pixels fora do pedaço
+// mantêm o valor do último frame. Com push, o frame montado é publicado e a
+// led_task o renderiza no próximo ciclo, interrompendo efeitos. Frames com seq
+// mais antiga são descartados (retorna true). Retorna false se o pedaço não
+// cabe na fita. Chamado sempre pela mesma task (a do WS).
+bool led_controller_stream_write(uint16_t seq, uint16_t offset, const uint8_t *pixels, int pixel_count,
+                                 bool rgbw, bool push);
+// Timeline: led_controller_timeline_edit devolve o buffer preallocado
+// (LED_TIMELINE_MAX_KEYFRAMES) onde a timeline nova é montada, e commit a
+// entrega à led_task, que a toca do início. Os keyframes vêm em ordem de
+// at_ms e duration_ms >= o último at_ms; com loop (e duration_ms > 0) a
+// timeline recomeça a cada duration_ms. Os keyframes são aplicados no frame
+// do seu instante, ancorados no horário previsto (transições e fase dos
+// efeitos não herdam o atraso do frame). Um led/effect/stream recebido depois
+// para a timeline. Chamados pela mesma task (a do WS). Um upload recusado
+// (sem commit, ou com commit que falha) não afeta a timeline já publicada.
+led_keyframe_t *led_controller_timeline_edit(void);
+// Confere os count keyframes do buffer de edição (a mesma checagem do commit).
+bool led_controller_timeline_valid(int count, uint32_t duration_ms);
+bool led_controller_timeline_commit(int count, uint32_t duration_ms, bool loop);
+bool led_controller_timeline_control(led_timeline_control_t control, uint32_t position_ms);
+void led_controller_get_timeline_status(led_timeline_status_t *status);
+void led_controller_get_stream_stats(led_stream_stats_t *stats);
+void led_controller_get_frame_stats(led_frame_stats_t *stats);
+void led_controller_get_scheduler_stats(led_scheduler_stats_t *stats);
+void led_controller_get_mailbox_stats(led_mailbox_stats_t *stats);
+// Brilho mestre (0..255, aplicado depois da correção de gama) e orçamento de
+// corrente da fita em mA (0 = sem limite). Passam pela caixa de correio e
+// valem a partir do próximo frame da led_task.
+void led_controller_set_output(uint8_t brightness, uint32_t max_milliamps);
+void led_controller_get_power_stats(led_power_stats_t *stats);
 bool led_controller_is_configured(void);
 led_color_t led_controller_get_current_color(void);
 
@@ -0,0 +1,20 @@
+#ifndef LED_CONTROLLER_INTERNAL_H
+#define LED_CONTROLLER_INTERNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "led_controller.h"
+
+// Renderiza e envia um frame do efeito. Chamado pela led_task a cada frame;
+// exposto aqui para o benchmark de host medir o custo de renderização.
+void led_controller_render_effect(const led_effect_t *effect, const led_effect_params_t *params, uint32_t step);
+// Troca os buffers do stream e envia o frame publicado, se houver. Chamado pela
+// led_task ao receber a notificação do stream; exposto para o benchmark.
+void led_controller_stream_render(void);
+// Aplica o pedido de timeline pendente e toca a timeline até now_us, como a
+// led_task a cada frame; exposto para o benchmark. Retorna true enquanto a
+// timeline estiver tocando.
+bool led_controller_timeline_tick(int64_t now_us);
+
+#endif
@@ -0,0 +1,501 @@
+#include "led_effects.h"
+
+#include <string.h>
+#include "led_tables.h"
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define EFFECT_BYTES_PER_PIXEL 4
+// Efeitos com simulação (twinkle, fire) avançam um passo por vez; depois de
+// uma parada longa (ex.: stream), só os últimos passos são simulados.
+#define EFFECT_MAX_CATCHUP_STEPS 8
+
+// ===================== PALETAS =====================
+
+// Gradiente por pontos de parada (posição 0..255 crescente, a última em 255),
+// expandido numa tabela de 256 cores quando o efeito começa.
+typedef struct
+{
+    uint8_t pos;
+    led_rgb_t color;
+} palette_stop_t;
+
+typedef struct
+{
+    const char *name;
+    const palette_stop_t *stops; // NULL: rainbow (tabela pronta) ou custom (cores do comando)
+    int stop_count;
+} palette_t;
+
+static const palette_stop_t heat_stops[] = {
+    {0, {0, 0, 0}}, {85, {255, 0, 0}}, {170, {255, 255, 0}}, {255, {255, 255, 255}},
+};
+// As demais fecham o ciclo na cor inicial, para rolar sem emenda.
+static const palette_stop_t ocean_stops[] = {
+    {0, {0, 0, 48}}, {80, {0, 48, 160}}, {144, {0, 160, 176}}, {208, {96, 208, 255}}, {255, {0, 0, 48}},
+};
+static const palette_stop_t forest_stops[] = {
+    {0, {0, 40, 0}}, {96, {0, 140, 20}}, {176, {110, 170, 0}}, {255, {0, 40, 0}},
+};
+static const palette_stop_t lava_stops[] = {
+    {0, {0, 0, 0}}, {64, {160, 0, 0}}, {128, {255, 64, 0}}, {192, {255, 170, 0}}, {255, {0, 0, 0}},
+};
+static const palette_stop_t party_stops[] = {
+    {0, {85, 0, 171}}, {64, {255, 0, 80}}, {128, {255, 160, 0}}, {192, {0, 200, 120}}, {255, {85, 0, 171}},
+};
+
+#define PALETTE(name, stops) {name, stops, (int)ARRAY_SIZE(stops)}
+
+enum
+{
+    PALETTE_HEAT = 0,
+    PALETTE_RAINBOW,
+    PALETTE_OCEAN,
+    PALETTE_FOREST,
+    PALETTE_LAVA,
+    PALETTE_PARTY,
+    PALETTE_CUSTOM,
+};
+
+static const palette_t led_palettes[] = {
+    [PALETTE_HEAT] = PALETTE("heat", heat_stops),
+    [PALETTE_RAINBOW] = {"rainbow", NULL, 0},
+    [PALETTE_OCEAN] = PALETTE("ocean", ocean_stops),
+    [PALETTE_FOREST] = PALETTE("forest", forest_stops),
+    [PALETTE_LAVA] = PALETTE("lava", lava_stops),
+    [PALETTE_PARTY] = PALETTE("party", party_stops),
+    [PALETTE_CUSTOM] = {"custom", NULL, 0}, // colors do comando, igualmente espaçadas, em ciclo
+};
+
+static void palette_expand_stops(const palette_stop_t *stops, int count, led_rgb_t lut[256])
+{
+    for (int s = 0; s + 1 < count; s++)
+    {
+        const palette_stop_t *a = &stops[s];
+        const palette_stop_t *b = &stops[s + 1];
+        int span = b->pos - a->pos;
+        for (int i = a->pos; i <= b->pos; i++)
+        {
+            // Divisão só na expansão; o kernel consulta a tabela.
+            int t = span > 0 ? ((i - a->pos) << 8) / span : 0;
+            lut[i].red = (uint8_t)(a->color.red + (((b->color.red - a->color.red) * t) >> 8));
+            lut[i].green = (uint8_t)(a->color.green + (((b->color.green - a->color.green) * t) >> 8));
+            lut[i].blue = (uint8_t)(a->color.blue + (((b->color.blue - a->color.blue) * t) >> 8));
+        }
+    }
+}
+
+static void palette_expand(const led_effect_params_t *params, led_rgb_t lut[256])
+{
+    int index = params->palette < ARRAY_SIZE(led_palettes) ? params->palette : PALETTE_RAINBOW;
+    const palette_t *palette = &led_palettes[index];
+    if (palette->stops)
+    {
+        palette_expand_stops(palette->stops, palette->stop_count, lut);
+        return;
+    }
+    if (index == PALETTE_RAINBOW)
+    {
+        memcpy(lut, led_rainbow_table, sizeof(led_rainbow_table));
+        return;
+    }
+
+    palette_stop_t stops[LED_EFFECT_MAX_COLORS + 1];
+    int count = params->color_count > 0 ? params->color_count : 1;
+    for (int i = 0; i <= count; i++)
+    {
+        const led_color_t *c = &params->colors[i % count];
+        stops[i].pos = (uint8_t)(i == count ? 255 : (i * 256) / count);
+        stops[i].color = (led_rgb_t){c->red, c->green, c->blue};
+    }
+    palette_expand_stops(stops, count + 1, lut);
+}
+
+int led_effect_find_palette(const char *name, int name_len)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(led_palettes); i++)
+    {
+        if (name_len >= 0 && strlen(led_palettes[i].name) == (size_t)name_len &&
+            memcmp(led_palettes[i].name, name, (size_t)name_len) == 0)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+const char *led_effect_palette_name(int palette)
+{
+    return (palette >= 0 && palette < (int)ARRAY_SIZE(led_palettes)) ? led_palettes[palette].name : NULL;
+}
+
+// ===================== AUXILIARES DOS KERNELS =====================
+
+static inline void pixel_set(uint8_t *px, uint8_t r, uint8_t g, uint8_t b)
+{
+    px[0] = r;
+    px[1] = g;
+    px[2] = b;
+    px[3] = 0;
+}
+
+// k-ésimo pixel no sentido do segmento.
+static inline uint8_t *pixel_at(const led_effect_frame_t *frame, int k)
+{
+    int index = frame->reversed ? frame->length - 1 - k : k;
+    return frame->pixels + (size_t)index * EFFECT_BYTES_PER_PIXEL;
+}
+
+static void frame_fill(const led_effect_frame_t *frame, uint8_t r, uint8_t g, uint8_t b)
+{
+    uint8_t *px = frame->pixels;
+    for (int i = 0; i < frame->length; i++, px += EFFECT_BYTES_PER_PIXEL)
+    {
+        pixel_set(px, r, g, b);
+    }
+}
+
+// v * level / 255, sem divisão (level 255 mantém v).
+static inline uint8_t scale8(uint8_t v, uint8_t level)
+{
+    return (uint8_t)(((uint32_t)v * (level + 1u)) >> 8);
+}
+
+static inline uint32_t random_next(uint32_t *seed)
+{
+    uint32_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+// Inteiro uniforme em [0, n), sem divisão.
+static inline uint32_t random_below(uint32_t *seed, uint32_t n)
+{
+    return (uint32_t)(((uint64_t)random_next(seed) * n) >> 32);
+}
+
+// Cabeçalho comum dos efeitos com simulação e paleta.
+typedef struct
+{
+    uint32_t seed;
+    uint32_t last_step;
+    led_rgb_t lut[256];
+} sim_state_t;
+
+static void sim_init(const led_effect_frame_t *frame, const led_effect_params_t *params, sim_state_t *sim)
+{
+    sim->seed = 0x9E3779B9u ^ (uint32_t)frame->length;
+    sim->last_step = frame->step;
+    palette_expand(params, sim->lut);
+}
+
+// Passos a simular neste frame.
+static uint32_t sim_steps(sim_state_t *sim, uint32_t step)
+{
+    uint32_t steps = step - sim->last_step;
+    sim->last_step = step;
+    return steps > EFFECT_MAX_CATCHUP_STEPS ? EFFECT_MAX_CATCHUP_STEPS : steps;
+}
+
+// ===================== KERNELS =====================
+
+// Escala um canal pelo nível mantendo piso 1 quando o canal é não-nulo,
+// para que o breathing nunca chegue a apagar a fita.
+static uint8_t scale_channel_min1(uint8_t base, uint8_t level)
+{
+    if (base == 0)
+    {
+        return 0;
+    }
+    uint16_t v = ((uint16_t)base * level) / 255;
+    return (v < 1) ? 1 : (uint8_t)v;
+}
+
+// Seno interpolado da tabela. phase é um acumulador de 16 bits: 65536 = um ciclo.
+static uint8_t sine_u8(uint16_t phase)
+{
+    uint8_t index = (uint8_t)(phase >> 8);
+    int a = led_sine_table[index];
+    int b = led_sine_table[(uint8_t)(index + 1)];
+    return (uint8_t)(a + (((b - a) * (int)(phase & 0xFF)) >> 8));
+}
+
+// Onda senoidal mapeada para [BREATHING_MIN .. 255] sobre a cor base. Nunca
+// apaga: o piso garante brilho mínimo e scale_channel_min1 mantém >= 1.
+static void breathing_render(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    // Ciclo de 1024 passos: step << 6 percorre a fase de 16 bits.
+    uint32_t wave = sine_u8((uint16_t)(frame->step << 6)); // 0..255
+    const uint8_t BREATHING_MIN = 6;                        // piso de brilho (~2%)
+    // x * 257 >> 16 ~= x / 255, sem divisão
+    uint8_t level = (uint8_t)(BREATHING_MIN + ((wave * (255 - BREATHING_MIN) * 257u + 32768u) >> 16));
+    const led_color_t *base = &params->colors[0];
+    frame_fill(frame, scale_channel_min1(base->red, level), scale_channel_min1(base->green, level),
+               scale_channel_min1(base->blue, level));
+}
+
+static void rainbow_render(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    // Deslocamento de matiz de cada pixel vem pronto do layout.
+    uint8_t *px = frame->pixels;
+    const uint8_t *offset = frame->hue_offsets;
+    for (int i = 0; i < frame->length; i++, px += EFFECT_BYTES_PER_PIXEL)
+    {
+        const led_rgb_t *c = &led_rainbow_table[(uint8_t)(frame->step + *offset++)];
+        pixel_set(px, c->red, c->green, c->blue);
+    }
+}
+
+static void fade_render(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    const led_rgb_t *c = &led_rainbow_table[(uint8_t)frame->step];
+    frame_fill(frame, c->red, c->green, c->blue);
+}
+
+// Cabeça na cor base com cauda que decai (quadrática) até apagar; density
+// define o tamanho da cauda (128 = 1/4 do segmento). A cabeça passa do fim
+// até a cauda sair, e recomeça.
+static void comet_render(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    int tail = 1 + ((frame->length * params->density) >> 9);
+    int head = (int)(frame->step % (uint32_t)(frame->length + tail));
+    uint32_t decay = (255u << 8) / (uint32_t)tail; // por pixel, Q8
+    const led_color_t *c = &params->colors[0];
+    for (int k = 0; k < frame->length; k++)
+    {
+        uint8_t *px = pixel_at(frame, k);
+        int distance = head - k;
+        if (distance < 0 || distance >= tail)
+        {
+            pixel_set(px, 0, 0, 0);
+            continue;
+        }
+        uint32_t linear = 255 - (((uint32_t)distance * decay) >> 8);
+        uint8_t level = (uint8_t)((linear * linear + 255) >> 8);
+        pixel_set(px, scale8(c->red, level), scale8(c->green, level), scale8(c->blue, level));
+    }
+}
+
+// Theater chase: um pixel aceso a cada spacing (2 + density / 16), andando
+// um pixel por passo; os grupos alternam entre as cores do comando.
+static void chase_render(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    int spacing = 2 + (params->density >> 4);
+    int color_count = params->color_count > 0 ? params->color_count : 1;
+    int period = spacing * color_count;
+    // Fase do pixel 0: contadores incrementais, sem divisão por pixel.
+    int u = period - (int)(frame->step % (uint32_t)period);
+    int phase = u % spacing;
+    int group = (u / spacing) % color_count;
+    for (int k = 0; k < frame->length; k++)
+    {
+        uint8_t *px = pixel_at(frame, k);
+        if (phase == 0)
+        {
+            const led_color_t *c = &params->colors[group];
+            pixel_set(px, c->red, c->green, c->blue);
+        }
+        else
+        {
+            pixel_set(px, 0, 0, 0);
+        }
+        if (++phase == spacing)
+        {
+            phase = 0;
+            if (++group == color_count)
+            {
+                group = 0;
+            }
+        }
+    }
+}
+
+// Pixels acendem em pontos aleatórios com uma cor da paleta e apagam aos
+// poucos. density = taxa de novos pontos (128 ~ metade da fita acesa).
+typedef struct
+{
+    sim_state_t sim;
+    uint32_t spawn; // acumulador de novos pontos, Q14
+} twinkle_state_t;
+
+// Estado por pixel: nível (brilho) e índice da cor na paleta.
+#define TWINKLE_PIXEL_BYTES 2
+#define TWINKLE_SPAWN_ONE (1u << 14)
+
+static void twinkle_init(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    sim_init(frame, params, &((twinkle_state_t *)state)->sim);
+}
+
+static void twinkle_render(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    twinkle_state_t *twinkle = state;
+    uint8_t *pixels = (uint8_t *)(twinkle + 1);
+    for (uint32_t steps = sim_steps(&twinkle->sim, frame->step); steps > 0; steps--)
+    {
+        for (int i = 0; i < frame->length; i++)
+        {
+            uint8_t level = pixels[i * TWINKLE_PIXEL_BYTES];
+            pixels[i * TWINKLE_PIXEL_BYTES] = level - ((level >> 4) | (level > 0));
+        }
+        twinkle->spawn += (uint32_t)frame->length * params->density;
+        while (twinkle->spawn >= TWINKLE_SPAWN_ONE)
+        {
+            twinkle->spawn -= TWINKLE_SPAWN_ONE;
+            uint8_t *px = pixels + random_below(&twinkle->sim.seed, (uint32_t)frame->length) * TWINKLE_PIXEL_BYTES;
+            px[0] = 255;
+            px[1] = (uint8_t)random_next(&twinkle->sim.seed);
+        }
+    }
+
+    uint8_t *out = frame->pixels;
+    for (int i = 0; i < frame->length; i++, out += EFFECT_BYTES_PER_PIXEL)
+    {
+        uint8_t level = pixels[i * TWINKLE_PIXEL_BYTES];
+        const led_rgb_t *c = &twinkle->sim.lut[pixels[i * TWINKLE_PIXEL_BYTES + 1]];
+        pixel_set(out, scale8(c->red, level), scale8(c->green, level), scale8(c->blue, level));
+    }
+}
+
+// Fogo 1D (calor por pixel): cada passo resfria, o calor sobe pela fita e
+// faíscas aleatórias nascem na base (início do segmento). density = chance
+// de faísca por passo. O calor indexa a paleta (padrão heat).
+#define FIRE_COOLING 55
+#define FIRE_SPARK_ZONE 7
+
+static void fire_init(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    sim_init(frame, params, state);
+}
+
+static void fire_render(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    sim_state_t *sim = state;
+    uint8_t *heat = (uint8_t *)(sim + 1);
+    int n = frame->length;
+    uint32_t cooling = (FIRE_COOLING * 10) / (uint32_t)n + 2;
+    for (uint32_t steps = sim_steps(sim, frame->step); steps > 0; steps--)
+    {
+        for (int k = 0; k < n; k++)
+        {
+            uint32_t cool = random_below(&sim->seed, cooling + 1);
+            heat[k] = heat[k] > cool ? (uint8_t)(heat[k] - cool) : 0;
+        }
+        // (h[k-1] + 2 * h[k-2]) / 3, com * 85 >> 8 no lugar da divisão.
+        for (int k = n - 1; k >= 2; k--)
+        {
+            heat[k] = (uint8_t)(((heat[k - 1] + 2u * heat[k - 2]) * 85u) >> 8);
+        }
+        if ((random_next(&sim->seed) & 0xFF) < params->density)
+        {
+            int zone = n < FIRE_SPARK_ZONE ? n : FIRE_SPARK_ZONE;
+            int k = (int)random_below(&sim->seed, (uint32_t)zone);
+            uint32_t h = heat[k] + 160 + random_below(&sim->seed, 96);
+            heat[k] = h > 255 ? 255 : (uint8_t)h;
+        }
+    }
+
+    for (int k = 0; k < n; k++)
+    {
+        // Até 240: o topo da paleta não volta para a primeira cor.
+        const led_rgb_t *c = &sim->lut[(heat[k] * 240u) >> 8];
+        pixel_set(pixel_at(frame, k), c->red, c->green, c->blue);
+    }
+}
+
+// Paleta espalhada pelo segmento, rolando com o tempo; density define quantas
+// vezes ela se repete (1 + density / 64).
+static void palette_init(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    palette_expand(params, state);
+}
+
+static void palette_render(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state)
+{
+    const led_rgb_t *lut = state;
+    uint32_t repeats = 1 + (params->density >> 6);
+    uint8_t *px = frame->pixels;
+    const uint8_t *offset = frame->hue_offsets;
+    for (int i = 0; i < frame->length; i++, px += EFFECT_BYTES_PER_PIXEL)
+    {
+        const led_rgb_t *c = &lut[(uint8_t)(frame->step + *offset++ * repeats)];
+        pixel_set(px, c->red, c->green, c->blue);
+    }
+}
+
+// ===================== REGISTRO =====================
+
+#define SPEED LED_EFFECT_PARAM_SPEED
+#define DENSITY LED_EFFECT_PARAM_DENSITY
+#define PALETTE_PARAM LED_EFFECT_PARAM_PALETTE
+#define COLORS LED_EFFECT_PARAM_COLORS
+#define NOMINAL LED_EFFECT_SPEED_NOMINAL
+
+// A posição é o id do formato binário: só acrescentar no fim.
+static const led_effect_t led_effects[] = {
+    {.name = "none"},
+    // Incremento 3 no ciclo de 1024 passos => ~6.8s por respiração.
+    {.name = "breathing", .schema = {SPEED | COLORS, NOMINAL, 0, 0, 1}, .step_rate = 3 << 8,
+     .render = breathing_render},
+    {.name = "rainbow", .schema = {SPEED, NOMINAL, 0, 0, 1}, .step_rate = 2 << 8, .render = rainbow_render},
+    {.name = "fade", .schema = {SPEED, NOMINAL, 0, 0, 1}, .step_rate = 1 << 8, .render = fade_render},
+    {.name = "comet", .schema = {SPEED | DENSITY | COLORS, NOMINAL, 128, 0, 1}, .step_rate = 1 << 8,
+     .render = comet_render},
+    {.name = "chase", .schema = {SPEED | DENSITY | COLORS, NOMINAL, 16, 0, LED_EFFECT_MAX_COLORS},
+     .step_rate = 1 << 6, .render = chase_render},
+    {.name = "twinkle",
+     .schema = {SPEED | DENSITY | PALETTE_PARAM | COLORS, NOMINAL, 128, PALETTE_PARTY, LED_EFFECT_MAX_COLORS},
+     .step_rate = 1 << 8, .state_size = sizeof(twinkle_state_t), .state_per_pixel = TWINKLE_PIXEL_BYTES,
+     .init = twinkle_init, .render = twinkle_render},
+    {.name = "fire",
+     .schema = {SPEED | DENSITY | PALETTE_PARAM | COLORS, NOMINAL, 120, PALETTE_HEAT, LED_EFFECT_MAX_COLORS},
+     .step_rate = 1 << 8, .state_size = sizeof(sim_state_t), .state_per_pixel = 1, .init = fire_init,
+     .render = fire_render},
+    {.name = "palette",
+     .schema = {SPEED | DENSITY | PALETTE_PARAM | COLORS, NOMINAL, 0, PALETTE_OCEAN, LED_EFFECT_MAX_COLORS},
+     .step_rate = 1 << 8, .state_size = sizeof(led_rgb_t) * 256, .init = palette_init, .render = palette_render},
+};
+
+const led_effect_t *led_effect_find(const char *name, int name_len)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(led_effects); i++)
+    {
+        if (name_len >= 0 && strlen(led_effects[i].name) == (size_t)name_len &&
+            memcmp(led_effects[i].name, name, (size_t)name_len) == 0)
+        {
+            return &led_effects[i];
+        }
+    }
+    return NULL;
+}
+
+const led_effect_t *led_effect_from_id(int id)
+{
+    return (id >= 0 && id < (int)ARRAY_SIZE(led_effects)) ? &led_effects[id] : NULL;
+}
+
+int led_effect_id(const led_effect_t *effect)
+{
+    return effect ? (int)(effect - led_effects) : 0;
+}
+
+int led_effect_count(void)
+{
+    return (int)ARRAY_SIZE(led_effects);
+}
+
+void led_effect_params_init(const led_effect_t *effect, led_effect_params_t *params)
+{
+    memset(params, 0, sizeof(*params));
+    params->speed = LED_EFFECT_SPEED_NOMINAL;
+    params->color_count = 1;
+    params->colors[0] = (led_color_t){255, 255, 255, 0};
+    if (effect && effect->render)
+    {
+        params->speed = effect->schema.speed;
+        params->density = effect->schema.density;
+        params->palette = effect->schema.palette;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef LED_EFFECTS_H
+#define LED_EFFECTS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "led_controller.h"
+
+// Registro dos efeitos do firmware. Cada efeito declara nome, parâmetros
+// aceitos (com valores padrão), memória por instância e um kernel que
+// renderiza um frame num trecho do framebuffer, só com aritmética inteira.
+// O protocolo e o led_controller só falam com o registro: um efeito novo é
+// uma entrada em led_effects.c.
+
+// Parâmetros que um efeito aceita (led_effect_schema_t.params).
+#define LED_EFFECT_PARAM_SPEED   (1u << 0)
+#define LED_EFFECT_PARAM_DENSITY (1u << 1)
+#define LED_EFFECT_PARAM_PALETTE (1u << 2)
+#define LED_EFFECT_PARAM_COLORS  (1u << 3)
+
+// speed = LED_EFFECT_SPEED_NOMINAL anda na cadência nominal do efeito; 255
+// dá ~2x, 1 dá 1/128.
+#define LED_EFFECT_SPEED_NOMINAL 128
+
+typedef struct
+{
+    uint8_t params; // LED_EFFECT_PARAM_*
+    uint8_t speed;
+    uint8_t density;
+    uint8_t palette;
+    uint8_t max_colors;
+} led_effect_schema_t;
+
+// Trecho do framebuffer (RGBW, 4 bytes por pixel) entregue ao kernel.
+typedef struct
+{
+    uint8_t *pixels;            // primeiro pixel do segmento
+    int length;
+    bool reversed;              // sentido do segmento (efeitos que andam pela fita)
+    const uint8_t *hue_offsets; // posição no segmento * 256 / length, já no sentido do segmento
+    uint32_t step;              // passos do efeito desde o início (cresce com o tempo e a velocidade)
+} led_effect_frame_t;
+
+struct led_effect
+{
+    const char *name;
+    led_effect_schema_t schema;
+    // Passos por frame nominal (20 ms) na velocidade nominal, em Q8.
+    uint32_t step_rate;
+    // Memória da instância: state_size + state_per_pixel * length bytes,
+    // zerada antes de init. O led_controller aloca de novo (e chama init)
+    // quando o efeito, os parâmetros ou o tamanho do segmento mudam.
+    size_t state_size;
+    size_t state_per_pixel;
+    // Opcional.
+    void (*init)(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state);
+    // NULL só no efeito "none" (interrompe o efeito).
+    void (*render)(const led_effect_frame_t *frame, const led_effect_params_t *params, void *state);
+};
+
+// O id de cada efeito (usado no formato binário) é a posição no registro:
+// efeitos novos entram no fim. O id 0 é "none".
+const led_effect_t *led_effect_find(const char *name, int name_len);
+const led_effect_t *led_effect_from_id(int id);
+int led_effect_id(const led_effect_t *effect);
+int led_effect_count(void);
+// Valores padrão do schema; colors[0] = branco.
+void led_effect_params_init(const led_effect_t *effect, led_effect_params_t *params);
+
+// Paletas (parâmetro palette): índice pelo nome, ou -1.
+int led_effect_find_palette(const char *name, int name_len);
+const char *led_effect_palette_name(int palette);
+
+#endif
@@ -0,0 +1,177 @@
+// Gerado por tools/gen_led_tables.py; não editar à mão.
+
+#include "led_tables.h"
+
+const uint8_t led_sine_table[256] = {
+    128, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+    176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+    218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+    245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+    245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+    218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+    176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+    128, 124, 121, 118, 115, 112, 109, 106, 103, 100, 97, 93, 90, 88, 85, 82,
+    79, 76, 73, 70, 67, 65, 62, 59, 57, 54, 52, 49, 47, 44, 42, 40,
+    37, 35, 33, 31, 29, 27, 25, 23, 21, 20, 18, 17, 15, 14, 12, 11,
+    10, 9, 7, 6, 5, 5, 4, 3, 2, 2, 1, 1, 1, 0, 0, 0,
+    0, 0, 0, 0, 1, 1, 1, 2, 2, 3, 4, 5, 5, 6, 7, 9,
+    10, 11, 12, 14, 15, 17, 18, 20, 21, 23, 25, 27, 29, 31, 33, 35,
+    37, 40, 42, 44, 47, 49, 52, 54, 57, 59, 62, 65, 67, 70, 73, 76,
+    79, 82, 85, 88, 90, 93, 97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+};
+
+const led_rgb_t led_rainbow_table[256] = {
+    {255, 0, 0}, {255, 6, 0}, {255, 12, 0}, {255, 18, 0}, {255, 24, 0}, {255, 30, 0}, {255, 36, 0}, {255, 42, 0},
+    {255, 48, 0}, {255, 54, 0}, {255, 60, 0}, {255, 66, 0}, {255, 72, 0}, {255, 78, 0}, {255, 84, 0}, {255, 90, 0},
+    {255, 96, 0}, {255, 102, 0}, {255, 108, 0}, {255, 114, 0}, {255, 120, 0}, {255, 126, 0}, {255, 132, 0}, {255, 138, 0},
+    {255, 144, 0}, {255, 150, 0}, {255, 156, 0}, {255, 162, 0}, {255, 168, 0}, {255, 174, 0}, {255, 180, 0}, {255, 186, 0},
+    {255, 192, 0}, {255, 198, 0}, {255, 204, 0}, {255, 210, 0}, {255, 216, 0}, {255, 222, 0}, {255, 228, 0}, {255, 234, 0},
+    {255, 240, 0}, {255, 246, 0}, {255, 252, 0}, {255, 255, 0}, {249, 255, 0}, {243, 255, 0}, {237, 255, 0}, {231, 255, 0},
+    {225, 255, 0}, {219, 255, 0}, {213, 255, 0}, {207, 255, 0}, {201, 255, 0}, {195, 255, 0}, {189, 255, 0}, {183, 255, 0},
+    {177, 255, 0}, {171, 255, 0}, {165, 255, 0}, {159, 255, 0}, {153, 255, 0}, {147, 255, 0}, {141, 255, 0}, {135, 255, 0},
+    {129, 255, 0}, {123, 255, 0}, {117, 255, 0}, {111, 255, 0}, {105, 255, 0}, {99, 255, 0}, {93, 255, 0}, {87, 255, 0},
+    {81, 255, 0}, {75, 255, 0}, {69, 255, 0}, {63, 255, 0}, {57, 255, 0}, {51, 255, 0}, {45, 255, 0}, {39, 255, 0},
+    {33, 255, 0}, {27, 255, 0}, {21, 255, 0}, {15, 255, 0}, {9, 255, 0}, {3, 255, 0}, {0, 255, 0}, {0, 255, 6},
+    {0, 255, 12}, {0, 255, 18}, {0, 255, 24}, {0, 255, 30}, {0, 255, 36}, {0, 255, 42}, {0, 255, 48}, {0, 255, 54},
+    {0, 255, 60}, {0, 255, 66}, {0, 255, 72}, {0, 255, 78}, {0, 255, 84}, {0, 255, 90}, {0, 255, 96}, {0, 255, 102},
+    {0, 255, 108}, {0, 255, 114}, {0, 255, 120}, {0, 255, 126}, {0, 255, 132}, {0, 255, 138}, {0, 255, 144}, {0, 255, 150},
+    {0, 255, 156}, {0, 255, 162}, {0, 255, 168}, {0, 255, 174}, {0, 255, 180}, {0, 255, 186}, {0, 255, 192}, {0, 255, 198},
+    {0, 255, 204}, {0, 255, 210}, {0, 255, 216}, {0, 255, 222}, {0, 255, 228}, {0, 255, 234}, {0, 255, 240}, {0, 255, 246},
+    {0, 255, 252}, {0, 255, 255}, {0, 249, 255}, {0, 243, 255}, {0, 237, 255}, {0, 231, 255}, {0, 225, 255}, {0, 219, 255},
+    {0, 213, 255}, {0, 207, 255}, {0, 201, 255}, {0, 195, 255}, {0, 189, 255}, {0, 183, 255}, {0, 177, 255}, {0, 171, 255},
+    {0, 165, 255}, {0, 159, 255}, {0, 153, 255}, {0, 147, 255}, {0, 141, 255}, {0, 135, 255}, {0, 129, 255}, {0, 123, 255},
+    {0, 117, 255}, {0, 111, 255}, {0, 105, 255}, {0, 99, 255}, {0, 93, 255}, {0, 87, 255}, {0, 81, 255}, {0, 75, 255},
+    {0, 69, 255}, {0, 63, 255}, {0, 57, 255}, {0, 51, 255}, {0, 45, 255}, {0, 39, 255}, {0, 33, 255}, {0, 27, 255},
+    {0, 21, 255}, {0, 15, 255}, {0, 9, 255}, {0, 3, 255}, {0, 0, 255}, {6, 0, 255}, {12, 0, 255}, {18, 0, 255},
+    {24, 0, 255}, {30, 0, 255}, {36, 0, 255}, {42, 0, 255}, {48, 0, 255}, {54, 0, 255}, {60, 0, 255}, {66, 0, 255},
+    {72, 0, 255}, {78, 0, 255}, {84, 0, 255}, {90, 0, 255}, {96, 0, 255}, {102, 0, 255}, {108, 0, 255}, {114, 0, 255},
+    {120, 0, 255}, {126, 0, 255}, {132, 0, 255}, {138, 0, 255}, {144, 0, 255}, {150, 0, 255}, {156, 0, 255}, {162, 0, 255},
+    {168, 0, 255}, {174, 0, 255}, {180, 0, 255}, {186, 0, 255}, {192, 0, 255}, {198, 0, 255}, {204, 0, 255}, {210, 0, 255},
+    {216, 0, 255}, {222, 0, 255}, {228, 0, 255}, {234, 0, 255}, {240, 0, 255}, {246, 0, 255}, {252, 0, 255}, {255, 0, 255},
+    {255, 0, 249}, {255, 0, 243}, {255, 0, 237}, {255, 0, 231}, {255, 0, 225}, {255, 0, 219}, {255, 0, 213}, {255, 0, 207},
+    {255, 0, 201}, {255, 0, 195}, {255, 0, 189}, {255, 0, 183}, {255, 0, 177}, {255, 0, 171}, {255, 0, 165}, {255, 0, 159},
+    {255, 0, 153}, {255, 0, 147}, {255, 0, 141}, {255, 0, 135}, {255, 0, 129}, {255, 0, 123}, {255, 0, 117}, {255, 0, 111},
+    {255, 0, 105}, {255, 0, 99}, {255, 0, 93}, {255, 0, 87}, {255, 0, 81}, {255, 0, 75}, {255, 0, 69}, {255, 0, 63},
+    {255, 0, 57}, {255, 0, 51}, {255, 0, 45}, {255, 0, 39}, {255, 0, 33}, {255, 0, 27}, {255, 0, 21}, {255, 0, 15},
+};
+
+// gamma 2.2
+const uint8_t led_gamma_table[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6,
+    6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 11, 11, 11, 12,
+    12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19,
+    20, 20, 21, 22, 22, 23, 23, 24, 25, 25, 26, 26, 27, 28, 28, 29,
+    30, 30, 31, 32, 33, 33, 34, 35, 35, 36, 37, 38, 39, 39, 40, 41,
+    42, 43, 43, 44, 45, 46, 47, 48, 49, 49, 50, 51, 52, 53, 54, 55,
+    56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+    73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88, 89, 90,
+    91, 93, 94, 95, 97, 98, 99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+const uint16_t led_linear_table[256] = {
+    0, 1, 2, 4, 7, 11, 17, 24, 32, 42, 53, 65, 79, 94, 111, 129,
+    148, 169, 192, 216, 242, 270, 299, 330, 362, 396, 432, 469, 508, 549, 591, 635,
+    681, 729, 779, 830, 883, 938, 995, 1053, 1113, 1175, 1239, 1305, 1373, 1443, 1514, 1587,
+    1663, 1740, 1819, 1900, 1983, 2068, 2155, 2243, 2334, 2427, 2521, 2618, 2717, 2817, 2920, 3024,
+    3131, 3240, 3350, 3463, 3578, 3694, 3813, 3934, 4057, 4182, 4309, 4438, 4570, 4703, 4838, 4976,
+    5115, 5257, 5401, 5547, 5695, 5845, 5998, 6152, 6309, 6468, 6629, 6792, 6957, 7124, 7294, 7466,
+    7640, 7816, 7994, 8175, 8358, 8543, 8730, 8919, 9111, 9305, 9501, 9699, 9900, 10102, 10307, 10515,
+    10724, 10936, 11150, 11366, 11585, 11806, 12029, 12254, 12482, 12712, 12944, 13179, 13416, 13655, 13896, 14140,
+    14386, 14635, 14885, 15138, 15394, 15652, 15912, 16174, 16439, 16706, 16975, 17247, 17521, 17798, 18077, 18358,
+    18642, 18928, 19216, 19507, 19800, 20095, 20393, 20694, 20996, 21301, 21609, 21919, 22231, 22546, 22863, 23182,
+    23504, 23829, 24156, 24485, 24817, 25151, 25487, 25826, 26168, 26512, 26858, 27207, 27558, 27912, 28268, 28627,
+    28988, 29351, 29717, 30086, 30457, 30830, 31206, 31585, 31966, 32349, 32735, 33124, 33514, 33908, 34304, 34702,
+    35103, 35507, 35913, 36321, 36732, 37146, 37562, 37981, 38402, 38825, 39252, 39680, 40112, 40546, 40982, 41421,
+    41862, 42306, 42753, 43202, 43654, 44108, 44565, 45025, 45487, 45951, 46418, 46888, 47360, 47835, 48313, 48793,
+    49275, 49761, 50249, 50739, 51232, 51728, 52226, 52727, 53230, 53736, 54245, 54756, 55270, 55787, 56306, 56828,
+    57352, 57879, 58409, 58941, 59476, 60014, 60554, 61097, 61642, 62190, 62741, 63295, 63851, 64410, 64971, 65535,
+};
+
+const uint8_t led_delinear_table[1024] = {
+    0, 10, 14, 18, 20, 22, 24, 26, 28, 29, 31, 32, 33, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 48, 49, 50, 51, 52,
+    52, 53, 54, 54, 55, 56, 57, 57, 58, 59, 59, 60, 60, 61, 62, 62, 63, 64, 64, 65, 65, 66, 66, 67, 68, 68, 69, 69, 70, 70, 71, 71,
+    72, 72, 73, 73, 74, 74, 75, 75, 76, 76, 77, 77, 78, 78, 79, 79, 80, 80, 80, 81, 81, 82, 82, 83, 83, 84, 84, 84, 85, 85, 86, 86,
+    86, 87, 87, 88, 88, 88, 89, 89, 90, 90, 90, 91, 91, 92, 92, 92, 93, 93, 94, 94, 94, 95, 95, 95, 96, 96, 96, 97, 97, 98, 98, 98,
+    99, 99, 99, 100, 100, 100, 101, 101, 101, 102, 102, 102, 103, 103, 103, 104, 104, 104, 105, 105, 105, 106, 106, 106, 107, 107, 107, 108, 108, 108, 109, 109,
+    109, 109, 110, 110, 110, 111, 111, 111, 112, 112, 112, 113, 113, 113, 113, 114, 114, 114, 115, 115, 115, 115, 116, 116, 116, 117, 117, 117, 118, 118, 118, 118,
+    119, 119, 119, 119, 120, 120, 120, 121, 121, 121, 121, 122, 122, 122, 123, 123, 123, 123, 124, 124, 124, 124, 125, 125, 125, 125, 126, 126, 126, 127, 127, 127,
+    127, 128, 128, 128, 128, 129, 129, 129, 129, 130, 130, 130, 130, 131, 131, 131, 131, 132, 132, 132, 132, 133, 133, 133, 133, 134, 134, 134, 134, 135, 135, 135,
+    135, 136, 136, 136, 136, 136, 137, 137, 137, 137, 138, 138, 138, 138, 139, 139, 139, 139, 140, 140, 140, 140, 140, 141, 141, 141, 141, 142, 142, 142, 142, 143,
+    143, 143, 143, 143, 144, 144, 144, 144, 145, 145, 145, 145, 145, 146, 146, 146, 146, 147, 147, 147, 147, 147, 148, 148, 148, 148, 149, 149, 149, 149, 149, 150,
+    150, 150, 150, 150, 151, 151, 151, 151, 151, 152, 152, 152, 152, 153, 153, 153, 153, 153, 154, 154, 154, 154, 154, 155, 155, 155, 155, 155, 156, 156, 156, 156,
+    156, 157, 157, 157, 157, 157, 158, 158, 158, 158, 158, 159, 159, 159, 159, 159, 160, 160, 160, 160, 160, 161, 161, 161, 161, 161, 162, 162, 162, 162, 162, 163,
+    163, 163, 163, 163, 164, 164, 164, 164, 164, 165, 165, 165, 165, 165, 165, 166, 166, 166, 166, 166, 167, 167, 167, 167, 167, 168, 168, 168, 168, 168, 168, 169,
+    169, 169, 169, 169, 170, 170, 170, 170, 170, 170, 171, 171, 171, 171, 171, 172, 172, 172, 172, 172, 172, 173, 173, 173, 173, 173, 174, 174, 174, 174, 174, 174,
+    175, 175, 175, 175, 175, 176, 176, 176, 176, 176, 176, 177, 177, 177, 177, 177, 177, 178, 178, 178, 178, 178, 178, 179, 179, 179, 179, 179, 180, 180, 180, 180,
+    180, 180, 181, 181, 181, 181, 181, 181, 182, 182, 182, 182, 182, 182, 183, 183, 183, 183, 183, 183, 184, 184, 184, 184, 184, 184, 185, 185, 185, 185, 185, 185,
+    186, 186, 186, 186, 186, 186, 187, 187, 187, 187, 187, 187, 188, 188, 188, 188, 188, 188, 189, 189, 189, 189, 189, 189, 190, 190, 190, 190, 190, 190, 190, 191,
+    191, 191, 191, 191, 191, 192, 192, 192, 192, 192, 192, 193, 193, 193, 193, 193, 193, 193, 194, 194, 194, 194, 194, 194, 195, 195, 195, 195, 195, 195, 196, 196,
+    196, 196, 196, 196, 196, 197, 197, 197, 197, 197, 197, 198, 198, 198, 198, 198, 198, 198, 199, 199, 199, 199, 199, 199, 199, 200, 200, 200, 200, 200, 200, 201,
+    201, 201, 201, 201, 201, 201, 202, 202, 202, 202, 202, 202, 203, 203, 203, 203, 203, 203, 203, 204, 204, 204, 204, 204, 204, 204, 205, 205, 205, 205, 205, 205,
+    205, 206, 206, 206, 206, 206, 206, 206, 207, 207, 207, 207, 207, 207, 207, 208, 208, 208, 208, 208, 208, 208, 209, 209, 209, 209, 209, 209, 209, 210, 210, 210,
+    210, 210, 210, 210, 211, 211, 211, 211, 211, 211, 211, 212, 212, 212, 212, 212, 212, 212, 213, 213, 213, 213, 213, 213, 213, 214, 214, 214, 214, 214, 214, 214,
+    215, 215, 215, 215, 215, 215, 215, 216, 216, 216, 216, 216, 216, 216, 217, 217, 217, 217, 217, 217, 217, 217, 218, 218, 218, 218, 218, 218, 218, 219, 219, 219,
+    219, 219, 219, 219, 220, 220, 220, 220, 220, 220, 220, 220, 221, 221, 221, 221, 221, 221, 221, 222, 222, 222, 222, 222, 222, 222, 222, 223, 223, 223, 223, 223,
+    223, 223, 224, 224, 224, 224, 224, 224, 224, 224, 225, 225, 225, 225, 225, 225, 225, 225, 226, 226, 226, 226, 226, 226, 226, 227, 227, 227, 227, 227, 227, 227,
+    227, 228, 228, 228, 228, 228, 228, 228, 228, 229, 229, 229, 229, 229, 229, 229, 229, 230, 230, 230, 230, 230, 230, 230, 231, 231, 231, 231, 231, 231, 231, 231,
+    232, 232, 232, 232, 232, 232, 232, 232, 233, 233, 233, 233, 233, 233, 233, 233, 234, 234, 234, 234, 234, 234, 234, 234, 235, 235, 235, 235, 235, 235, 235, 235,
+    236, 236, 236, 236, 236, 236, 236, 236, 237, 237, 237, 237, 237, 237, 237, 237, 238, 238, 238, 238, 238, 238, 238, 238, 239, 239, 239, 239, 239, 239, 239, 239,
+    239, 240, 240, 240, 240, 240, 240, 240, 240, 241, 241, 241, 241, 241, 241, 241, 241, 242, 242, 242, 242, 242, 242, 242, 242, 243, 243, 243, 243, 243, 243, 243,
+    243, 243, 244, 244, 244, 244, 244, 244, 244, 244, 245, 245, 245, 245, 245, 245, 245, 245, 245, 246, 246, 246, 246, 246, 246, 246, 246, 247, 247, 247, 247, 247,
+    247, 247, 247, 247, 248, 248, 248, 248, 248, 248, 248, 248, 249, 249, 249, 249, 249, 249, 249, 249, 249, 250, 250, 250, 250, 250, 250, 250, 250, 251, 251, 251,
+    251, 251, 251, 251, 251, 251, 252, 252, 252, 252, 252, 252, 252, 252, 252, 253, 253, 253, 253, 253, 253, 253, 253, 253, 254, 254, 254, 254, 254, 254, 254, 254,
+};
+
+const uint8_t led_spi_pattern_table[256][3] = {
+    {0x92, 0x49, 0x24}, {0x92, 0x49, 0x26}, {0x92, 0x49, 0x34}, {0x92, 0x49, 0x36}, {0x92, 0x49, 0xA4}, {0x92, 0x49, 0xA6},
+    {0x92, 0x49, 0xB4}, {0x92, 0x49, 0xB6}, {0x92, 0x4D, 0x24}, {0x92, 0x4D, 0x26}, {0x92, 0x4D, 0x34}, {0x92, 0x4D, 0x36},
+    {0x92, 0x4D, 0xA4}, {0x92, 0x4D, 0xA6}, {0x92, 0x4D, 0xB4}, {0x92, 0x4D, 0xB6}, {0x92, 0x69, 0x24}, {0x92, 0x69, 0x26},
+    {0x92, 0x69, 0x34}, {0x92, 0x69, 0x36}, {0x92, 0x69, 0xA4}, {0x92, 0x69, 0xA6}, {0x92, 0x69, 0xB4}, {0x92, 0x69, 0xB6},
+    {0x92, 0x6D, 0x24}, {0x92, 0x6D, 0x26}, {0x92, 0x6D, 0x34}, {0x92, 0x6D, 0x36}, {0x92, 0x6D, 0xA4}, {0x92, 0x6D, 0xA6},
+    {0x92, 0x6D, 0xB4}, {0x92, 0x6D, 0xB6}, {0x93, 0x49, 0x24}, {0x93, 0x49, 0x26}, {0x93, 0x49, 0x34}, {0x93, 0x49, 0x36},
+    {0x93, 0x49, 0xA4}, {0x93, 0x49, 0xA6}, {0x93, 0x49, 0xB4}, {0x93, 0x49, 0xB6}, {0x93, 0x4D, 0x24}, {0x93, 0x4D, 0x26},
+    {0x93, 0x4D, 0x34}, {0x93, 0x4D, 0x36}, {0x93, 0x4D, 0xA4}, {0x93, 0x4D, 0xA6}, {0x93, 0x4D, 0xB4}, {0x93, 0x4D, 0xB6},
+    {0x93, 0x69, 0x24}, {0x93, 0x69, 0x26}, {0x93, 0x69, 0x34}, {0x93, 0x69, 0x36}, {0x93, 0x69, 0xA4}, {0x93, 0x69, 0xA6},
+    {0x93, 0x69, 0xB4}, {0x93, 0x69, 0xB6}, {0x93, 0x6D, 0x24}, {0x93, 0x6D, 0x26}, {0x93, 0x6D, 0x34}, {0x93, 0x6D, 0x36},
+    {0x93, 0x6D, 0xA4}, {0x93, 0x6D, 0xA6}, {0x93, 0x6D, 0xB4}, {0x93, 0x6D, 0xB6}, {0x9A, 0x49, 0x24}, {0x9A, 0x49, 0x26},
+    {0x9A, 0x49, 0x34}, {0x9A, 0x49, 0x36}, {0x9A, 0x49, 0xA4}, {0x9A, 0x49, 0xA6}, {0x9A, 0x49, 0xB4}, {0x9A, 0x49, 0xB6},
+    {0x9A, 0x4D, 0x24}, {0x9A, 0x4D, 0x26}, {0x9A, 0x4D, 0x34}, {0x9A, 0x4D, 0x36}, {0x9A, 0x4D, 0xA4}, {0x9A, 0x4D, 0xA6},
+    {0x9A, 0x4D, 0xB4}, {0x9A, 0x4D, 0xB6}, {0x9A, 0x69, 0x24}, {0x9A, 0x69, 0x26}, {0x9A, 0x69, 0x34}, {0x9A, 0x69, 0x36},
+    {0x9A, 0x69, 0xA4}, {0x9A, 0x69, 0xA6}, {0x9A, 0x69, 0xB4}, {0x9A, 0x69, 0xB6}, {0x9A, 0x6D, 0x24}, {0x9A, 0x6D, 0x26},
+    {0x9A, 0x6D, 0x34}, {0x9A, 0x6D, 0x36}, {0x9A, 0x6D, 0xA4}, {0x9A, 0x6D, 0xA6}, {0x9A, 0x6D, 0xB4}, {0x9A, 0x6D, 0xB6},
+    {0x9B, 0x49, 0x24}, {0x9B, 0x49, 0x26}, {0x9B, 0x49, 0x34}, {0x9B, 0x49, 0x36}, {0x9B, 0x49, 0xA4}, {0x9B, 0x49, 0xA6},
+    {0x9B, 0x49, 0xB4}, {0x9B, 0x49, 0xB6}, {0x9B, 0x4D, 0x24}, {0x9B, 0x4D, 0x26}, {0x9B, 0x4D, 0x34}, {0x9B, 0x4D, 0x36},
+    {0x9B, 0x4D, 0xA4}, {0x9B, 0x4D, 0xA6}, {0x9B, 0x4D, 0xB4}, {0x9B, 0x4D, 0xB6}, {0x9B, 0x69, 0x24}, {0x9B, 0x69, 0x26},
+    {0x9B, 0x69, 0x34}, {0x9B, 0x69, 0x36}, {0x9B, 0x69, 0xA4}, {0x9B, 0x69, 0xA6}, {0x9B, 0x69, 0xB4}, {0x9B, 0x69, 0xB6},
+    {0x9B, 0x6D, 0x24}, {0x9B, 0x6D, 0x26}, {0x9B, 0x6D, 0x34}, {0x9B, 0x6D, 0x36}, {0x9B, 0x6D, 0xA4}, {0x9B, 0x6D, 0xA6},
+    {0x9B, 0x6D, 0xB4}, {0x9B, 0x6D, 0xB6}, {0xD2, 0x49, 0x24}, {0xD2, 0x49, 0x26}, {0xD2, 0x49, 0x34}, {0xD2, 0x49, 0x36},
+    {0xD2, 0x49, 0xA4}, {0xD2, 0x49, 0xA6}, {0xD2, 0x49, 0xB4}, {0xD2, 0x49, 0xB6}, {0xD2, 0x4D, 0x24}, {0xD2, 0x4D, 0x26},
+    {0xD2, 0x4D, 0x34}, {0xD2, 0x4D, 0x36}, {0xD2, 0x4D, 0xA4}, {0xD2, 0x4D, 0xA6}, {0xD2, 0x4D, 0xB4}, {0xD2, 0x4D, 0xB6},
+    {0xD2, 0x69, 0x24}, {0xD2, 0x69, 0x26}, {0xD2, 0x69, 0x34}, {0xD2, 0x69, 0x36}, {0xD2, 0x69, 0xA4}, {0xD2, 0x69, 0xA6},
+    {0xD2, 0x69, 0xB4}, {0xD2, 0x69, 0xB6}, {0xD2, 0x6D, 0x24}, {0xD2, 0x6D, 0x26}, {0xD2, 0x6D, 0x34}, {0xD2, 0x6D, 0x36},
+    {0xD2, 0x6D, 0xA4}, {0xD2, 0x6D, 0xA6}, {0xD2, 0x6D, 0xB4}, {0xD2, 0x6D, 0xB6}, {0xD3, 0x49, 0x24}, {0xD3, 0x49, 0x26},
+    {0xD3, 0x49, 0x34}, {0xD3, 0x49, 0x36}, {0xD3, 0x49, 0xA4}, {0xD3, 0x49, 0xA6}, {0xD3, 0x49, 0xB4}, {0xD3, 0x49, 0xB6},
+    {0xD3, 0x4D, 0x24}, {0xD3, 0x4D, 0x26}, {0xD3, 0x4D, 0x34}, {0xD3, 0x4D, 0x36}, {0xD3, 0x4D, 0xA4}, {0xD3, 0x4D, 0xA6},
+    {0xD3, 0x4D, 0xB4}, {0xD3, 0x4D, 0xB6}, {0xD3, 0x69, 0x24}, {0xD3, 0x69, 0x26}, {0xD3, 0x69, 0x34}, {0xD3, 0x69, 0x36},
+    {0xD3, 0x69, 0xA4}, {0xD3, 0x69, 0xA6}, {0xD3, 0x69, 0xB4}, {0xD3, 0x69, 0xB6}, {0xD3, 0x6D, 0x24}, {0xD3, 0x6D, 0x26},
+    {0xD3, 0x6D, 0x34}, {0xD3, 0x6D, 0x36}, {0xD3, 0x6D, 0xA4}, {0xD3, 0x6D, 0xA6}, {0xD3, 0x6D, 0xB4}, {0xD3, 0x6D, 0xB6},
+    {0xDA, 0x49, 0x24}, {0xDA, 0x49, 0x26}, {0xDA, 0x49, 0x34}, {0xDA, 0x49, 0x36}, {0xDA, 0x49, 0xA4}, {0xDA, 0x49, 0xA6},
+    {0xDA, 0x49, 0xB4}, {0xDA, 0x49, 0xB6}, {0xDA, 0x4D, 0x24}, {0xDA, 0x4D, 0x26}, {0xDA, 0x4D, 0x34}, {0xDA, 0x4D, 0x36},
+    {0xDA, 0x4D, 0xA4}, {0xDA, 0x4D, 0xA6}, {0xDA, 0x4D, 0xB4}, {0xDA, 0x4D, 0xB6}, {0xDA, 0x69, 0x24}, {0xDA, 0x69, 0x26},
+    {0xDA, 0x69, 0x34}, {0xDA, 0x69, 0x36}, {0xDA, 0x69, 0xA4}, {0xDA, 0x69, 0xA6}, {0xDA, 0x69, 0xB4}, {0xDA, 0x69, 0xB6},
+    {0xDA, 0x6D, 0x24}, {0xDA, 0x6D, 0x26}, {0xDA, 0x6D, 0x34}, {0xDA, 0x6D, 0x36}, {0xDA, 0x6D, 0xA4}, {0xDA, 0x6D, 0xA6},
+    {0xDA, 0x6D, 0xB4}, {0xDA, 0x6D, 0xB6}, {0xDB, 0x49, 0x24}, {0xDB, 0x49, 0x26}, {0xDB, 0x49, 0x34}, {0xDB, 0x49, 0x36},
+    {0xDB, 0x49, 0xA4}, {0xDB, 0x49, 0xA6}, {0xDB, 0x49, 0xB4}, {0xDB, 0x49, 0xB6}, {0xDB, 0x4D, 0x24}, {0xDB, 0x4D, 0x26},
+    {0xDB, 0x4D, 0x34}, {0xDB, 0x4D, 0x36}, {0xDB, 0x4D, 0xA4}, {0xDB, 0x4D, 0xA6}, {0xDB, 0x4D, 0xB4}, {0xDB, 0x4D, 0xB6},
+    {0xDB, 0x69, 0x24}, {0xDB, 0x69, 0x26}, {0xDB, 0x69, 0x34}, {0xDB, 0x69, 0x36}, {0xDB, 0x69, 0xA4}, {0xDB, 0x69, 0xA6},
+    {0xDB, 0x69, 0xB4}, {0xDB, 0x69, 0xB6}, {0xDB, 0x6D, 0x24}, {0xDB, 0x6D, 0x26}, {0xDB, 0x6D, 0x34}, {0xDB, 0x6D, 0x36},
+    {0xDB, 0x6D, 0xA4}, {0xDB, 0x6D, 0xA6}, {0xDB, 0x6D, 0xB4}, {0xDB, 0x6D, 0xB6},
+};
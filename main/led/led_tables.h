@@ -0,0 +1,33 @@
+#ifndef LED_TABLES_H
+#define LED_TABLES_H
+
+#include <stdint.h>
+
+// Tabelas de consulta dos efeitos, geradas por tools/gen_led_tables.py (em
+// led_tables.c). Com elas os kernels dos efeitos não usam float nem divisão
+// por pixel.
+
+typedef struct
+{
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+} led_rgb_t;
+
+// (sin(2*pi*i/256) + 1) / 2 em 0..255.
+extern const uint8_t led_sine_table[256];
+// HSV -> RGB com saturação e valor máximos, indexado pelo matiz.
+extern const led_rgb_t led_rainbow_table[256];
+// Correção de gama (linear -> PWM percebido).
+extern const uint8_t led_gamma_table[256];
+// Mesma curva em 16 bits, para misturar cores em luz linear: valor do canal ->
+// luz em 0..65535, e o caminho de volta (luz >> LED_DELINEAR_SHIFT -> maior
+// valor de canal com luz menor ou igual).
+#define LED_DELINEAR_SHIFT 6
+extern const uint16_t led_linear_table[256];
+extern const uint8_t led_delinear_table[65536 >> LED_DELINEAR_SHIFT];
+// Byte da fita -> 24 bits SPI (3 por bit: 1 = 110, 0 = 100), para o backend
+// SPI a 2,5 MHz (0,4 µs por bit SPI, 1,2 µs por bit da fita).
+extern const uint8_t led_spi_pattern_table[256][3];
+
+#endif
@@ -1,7 +1,14 @@
+#include <string.h>
+
 #include "nvs_flash.h"
 #include "esp_log.h"
+#include "config.h"
+#include "net_hmac.h"
 #include "net_utils.h"
 #include "led_controller.h"
+#include "wol_groups.h"
+#include "wol_sender.h"
+#include "wol_verify.h"
 #include "ws_client.h"
 
 static const char *TAG = "ESP_WOL_MAIN";
@@ -15,6 +22,13 @@ void app_main()
         return;
     }
 
+    // Chave do HMAC importada uma vez; handshake e comandos assinados a reutilizam.
+    if (!net_hmac_init((const uint8_t *)SECRET, strlen(SECRET)))
+    {
+        ESP_LOGE(TAG, "Failed to load HMAC key");
+        return;
+    }
+
     wifi_init();
 
     char device_mac[18] = "00:00:00:00:00:00";
@@ -26,6 +40,16 @@ void app_main()
 
     sync_time();
 
+    if (!wol_sender_start())
+    {
+        ESP_LOGE(TAG, "Failed to start WoL sender");
+    }
+    if (!wol_verify_start())
+    {
+        ESP_LOGE(TAG, "Failed to start WoL verify task");
+    }
+    wol_groups_load();
+
     if (!led_controller_start())
     {
         ESP_LOGE(TAG, "Failed to start LED controller");
@@ -0,0 +1,71 @@
+#include "esp_log.h"
+
+#include "net_hmac.h"
+
+static const char *TAG = "ESP_WOL_HMAC";
+
+#define NET_HMAC_ALG PSA_ALG_HMAC(PSA_ALG_SHA_256)
+
+static psa_key_id_t net_hmac_key = 0;
+
+bool net_hmac_init(const uint8_t *secret, size_t secret_len)
+{
+    if (net_hmac_key != 0)
+    {
+        return true;
+    }
+
+    // PSA é a API pública de HMAC no mbedtls 4 (IDF v6); mbedtls_md_hmac_* virou privada
+    if (psa_crypto_init() != PSA_SUCCESS)
+    {
+        ESP_LOGE(TAG, "psa_crypto_init failed");
+        return false;
+    }
+
+    // A política aceita o HMAC inteiro (handshake) e a tag truncada (comandos).
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+    psa_set_key_usage_flags(&attr, PSA_KEY_USAGE_SIGN_MESSAGE | PSA_KEY_USAGE_VERIFY_MESSAGE);
+    psa_set_key_algorithm(&attr, PSA_ALG_AT_LEAST_THIS_LENGTH_MAC(NET_HMAC_ALG, NET_HMAC_TAG_LEN));
+    psa_set_key_type(&attr, PSA_KEY_TYPE_HMAC);
+
+    psa_key_id_t key = 0;
+    if (psa_import_key(&attr, secret, secret_len, &key) != PSA_SUCCESS)
+    {
+        ESP_LOGE(TAG, "HMAC key import failed");
+        return false;
+    }
+    net_hmac_key = key;
+    return true;
+}
+
+bool net_hmac_sign(const uint8_t *data, size_t len, uint8_t *out)
+{
+    size_t mac_len = 0;
+    return net_hmac_key != 0 &&
+           psa_mac_compute(net_hmac_key, NET_HMAC_ALG, data, len, out, NET_HMAC_LEN, &mac_len) == PSA_SUCCESS &&
+           mac_len == NET_HMAC_LEN;
+}
+
+bool net_hmac_verify_begin(net_hmac_verify_t *verify)
+{
+    verify->op = (psa_mac_operation_t)PSA_MAC_OPERATION_INIT;
+    return net_hmac_key != 0 &&
+           psa_mac_verify_setup(&verify->op, net_hmac_key,
+                                PSA_ALG_TRUNCATED_MAC(NET_HMAC_ALG, NET_HMAC_TAG_LEN)) == PSA_SUCCESS;
+}
+
+void net_hmac_verify_update(net_hmac_verify_t *verify, const void *data, size_t len)
+{
+    // Erro aqui deixa a operação inválida e o end falha.
+    if (psa_mac_update(&verify->op, data, len) != PSA_SUCCESS)
+    {
+        psa_mac_abort(&verify->op);
+    }
+}
+
+bool net_hmac_verify_end(net_hmac_verify_t *verify, const uint8_t *tag)
+{
+    bool ok = psa_mac_verify_finish(&verify->op, tag, NET_HMAC_TAG_LEN) == PSA_SUCCESS;
+    psa_mac_abort(&verify->op);
+    return ok;
+}
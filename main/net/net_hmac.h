@@ -0,0 +1,35 @@
+#ifndef NET_HMAC_H
+#define NET_HMAC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/crypto.h"
+
+// HMAC-SHA256 com o SECRET compartilhado. A chave é importada uma vez no
+// boot (net_hmac_init) e fica num slot volátil do PSA até o reboot: o
+// handshake e a verificação de cada comando só pagam o hash.
+
+#define NET_HMAC_LEN 32
+// Tag truncada dos comandos assinados (HMAC-SHA256-128).
+#define NET_HMAC_TAG_LEN 16
+
+// Idempotente: chamadas depois da primeira só retornam o estado.
+bool net_hmac_init(const uint8_t *secret, size_t secret_len);
+// out recebe NET_HMAC_LEN bytes.
+bool net_hmac_sign(const uint8_t *data, size_t len, uint8_t *out);
+
+// Verificação incremental de uma tag de NET_HMAC_TAG_LEN bytes: os pedaços da
+// mensagem entram em ordem por update, sem cópia nem alocação.
+typedef struct
+{
+    psa_mac_operation_t op;
+} net_hmac_verify_t;
+
+bool net_hmac_verify_begin(net_hmac_verify_t *verify);
+void net_hmac_verify_update(net_hmac_verify_t *verify, const void *data, size_t len);
+// Comparação em tempo constante; encerra a operação em qualquer caso.
+bool net_hmac_verify_end(net_hmac_verify_t *verify, const uint8_t *tag);
+
+#endif
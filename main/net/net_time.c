@@ -0,0 +1,91 @@
+#include <string.h>
+#include <sys/time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "net_time.h"
+
+static const char *TAG = "ESP_WOL_TIME";
+
+// Antes disso o relógio ainda não foi acertado (mesmo limite do sync_time).
+#define NET_TIME_VALID_EPOCH_S 1000000000
+
+typedef struct
+{
+    int64_t last_timer_us; // esp_timer e horário da última sincronização
+    int64_t last_epoch_us;
+    net_time_stats_t stats;
+} net_time_state_t;
+
+// Escrito pela task do SNTP (lwIP), lido pela do WS.
+static net_time_state_t net_time = {0};
+static portMUX_TYPE net_time_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void net_time_on_sync(int64_t timer_us, int64_t epoch_us)
+{
+    taskENTER_CRITICAL(&net_time_lock);
+    net_time_stats_t *stats = &net_time.stats;
+    int64_t interval_us = timer_us - net_time.last_timer_us;
+    bool measured = stats->syncs > 0 && interval_us > 0;
+    int64_t correction = 0;
+    if (measured)
+    {
+        // O relógio local, sem a correção, estaria em last_epoch + interval.
+        correction = epoch_us - (net_time.last_epoch_us + interval_us);
+        uint32_t magnitude = (uint32_t)(correction < 0 ? -correction : correction);
+        stats->last_correction_us = (int32_t)correction;
+        if (magnitude > stats->max_correction_us)
+        {
+            stats->max_correction_us = magnitude;
+        }
+        stats->drift_ppb = (int32_t)(correction * 1000000000 / interval_us);
+    }
+    stats->syncs++;
+    net_time.last_timer_us = timer_us;
+    net_time.last_epoch_us = epoch_us;
+    taskEXIT_CRITICAL(&net_time_lock);
+
+    if (measured)
+    {
+        ESP_LOGI(TAG, "Time sync: correction %lld us over %lld s", (long long)correction,
+                 (long long)(interval_us / 1000000));
+    }
+}
+
+int64_t net_time_now_ms(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+bool net_time_is_synced(void)
+{
+    return net_time_now_ms() / 1000 > NET_TIME_VALID_EPOCH_S;
+}
+
+void net_time_get_stats(net_time_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL(&net_time_lock);
+    *stats = net_time.stats;
+    int64_t last_timer_us = net_time.last_timer_us;
+    taskEXIT_CRITICAL(&net_time_lock);
+
+    stats->synced = net_time_is_synced();
+    if (stats->syncs > 0)
+    {
+        int64_t since_us = esp_timer_get_time() - last_timer_us;
+        int64_t drift = stats->drift_ppb < 0 ? -(int64_t)stats->drift_ppb : stats->drift_ppb;
+        stats->since_sync_s = (uint32_t)(since_us / 1000000);
+        stats->estimated_error_us = (uint32_t)(since_us * drift / 1000000000);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef NET_TIME_H
+#define NET_TIME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Acompanhamento do relógio sincronizado por SNTP. A cada sincronização, a
+// correção aplicada (quanto o relógio local andou diferente do servidor desde
+// a anterior) dá a deriva do oscilador; com ela se estima o erro acumulado até
+// a próxima, que é o limite de sincronia entre dispositivos (startAt).
+
+// Intervalo entre as sincronizações periódicas.
+#define NET_TIME_SYNC_INTERVAL_MS (10 * 60 * 1000)
+
+typedef struct
+{
+    bool synced;                 // relógio de parede válido
+    uint32_t syncs;              // sincronizações recebidas
+    int32_t last_correction_us;  // correção da última sincronização (servidor - local)
+    uint32_t max_correction_us;  // maior |correção| desde o boot
+    int32_t drift_ppb;           // deriva do relógio local medida na última sincronização
+    uint32_t since_sync_s;       // tempo desde a última sincronização
+    uint32_t estimated_error_us; // |deriva| * tempo desde a última sincronização
+} net_time_stats_t;
+
+// Chamado pelo callback do SNTP com o instante do esp_timer e o horário
+// recebido (epoch, µs).
+void net_time_on_sync(int64_t timer_us, int64_t epoch_us);
+// Horário de parede (epoch, ms). net_time_is_synced indica se ele é válido.
+int64_t net_time_now_ms(void);
+bool net_time_is_synced(void);
+void net_time_get_stats(net_time_stats_t *stats);
+
+#endif
@@ -2,13 +2,23 @@
 #define NET_UTILS_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+// "AA:BB:CC:DD:EE:FF", sem o '\0'.
+#define MAC_STRING_LEN 17
+
 void wifi_init(void);
 void sync_time(void);
 void make_hmac(const char *token, char *output);
 bool get_device_mac_string(char *output, int output_size);
+// Formatos aceitos: AA:BB:CC:DD:EE:FF, AA-BB-CC-DD-EE-FF e AABBCCDDEEFF
+// (hexa em maiúsculas ou minúsculas, sempre dois dígitos por byte, o mesmo
+// separador em todo o MAC e nada antes ou depois). mac só é escrito se o
+// texto for válido.
+bool parse_mac(const char *input, size_t len, uint8_t *mac);
 bool parse_mac_string(const char *input, uint8_t *mac);
-bool send_wake_on_lan(const unsigned char *mac);
+// Escreve MAC_STRING_LEN caracteres (maiúsculas, com ':') e o '\0'.
+void format_mac_string(const uint8_t *mac, char *output);
 
 #endif
@@ -0,0 +1,85 @@
+#include <string.h>
+
+#include "net_utils.h"
+
+#define MAC_BARE_LEN 12
+// Bit de dígito válido em mac_hex_digit (o valor fica nos 4 bits de baixo).
+#define MAC_HEX_VALID 0x10
+
+static const uint8_t mac_hex_digit[256] = {
+    ['0'] = 0x10, ['1'] = 0x11, ['2'] = 0x12, ['3'] = 0x13, ['4'] = 0x14,
+    ['5'] = 0x15, ['6'] = 0x16, ['7'] = 0x17, ['8'] = 0x18, ['9'] = 0x19,
+    ['A'] = 0x1A, ['B'] = 0x1B, ['C'] = 0x1C, ['D'] = 0x1D, ['E'] = 0x1E, ['F'] = 0x1F,
+    ['a'] = 0x1A, ['b'] = 0x1B, ['c'] = 0x1C, ['d'] = 0x1D, ['e'] = 0x1E, ['f'] = 0x1F,
+};
+
+static const char mac_hex_upper[16] = "0123456789ABCDEF";
+
+// Passada única: o tamanho escolhe o formato (17 com separador, 12 sem) e
+// cada byte consome dois dígitos (e o separador seguinte). Os erros são
+// acumulados em valid, sem desvio por caractere.
+bool parse_mac(const char *input, size_t len, uint8_t *mac)
+{
+    if (!input || !mac)
+    {
+        return false;
+    }
+
+    size_t stride;
+    char separator = 0;
+    if (len == MAC_STRING_LEN)
+    {
+        separator = input[2];
+        if (separator != ':' && separator != '-')
+        {
+            return false;
+        }
+        stride = 3;
+    }
+    else if (len == MAC_BARE_LEN)
+    {
+        stride = 2;
+    }
+    else
+    {
+        return false;
+    }
+
+    const uint8_t *p = (const uint8_t *)input;
+    uint8_t bytes[6];
+    uint8_t valid = MAC_HEX_VALID;
+    for (int i = 0; i < 6; i++, p += stride)
+    {
+        uint8_t high = mac_hex_digit[p[0]];
+        uint8_t low = mac_hex_digit[p[1]];
+        valid &= high & low;
+        if (separator && i < 5 && p[2] != (uint8_t)separator)
+        {
+            valid = 0;
+        }
+        bytes[i] = (uint8_t)(high << 4) | (low & 0x0F);
+    }
+
+    if (!valid)
+    {
+        return false;
+    }
+    memcpy(mac, bytes, sizeof(bytes));
+    return true;
+}
+
+bool parse_mac_string(const char *input, uint8_t *mac)
+{
+    return input && parse_mac(input, strlen(input), mac);
+}
+
+void format_mac_string(const uint8_t *mac, char *output)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        output[i * 3] = mac_hex_upper[mac[i] >> 4];
+        output[i * 3 + 1] = mac_hex_upper[mac[i] & 0x0F];
+        output[i * 3 + 2] = ':';
+    }
+    output[MAC_STRING_LEN] = 0;
+}
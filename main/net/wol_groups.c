@@ -0,0 +1,144 @@
+#include <string.h>
+
+#include "esp_log.h"
+#include "nvs.h"
+
+#include "wol_groups.h"
+
+static const char *TAG = "ESP_WOL_GROUPS";
+
+#define WOL_GROUPS_NAMESPACE "wol"
+#define WOL_GROUPS_KEY "groups"
+
+// Blob na NVS: os grupos em uso, em sequência.
+static wol_group_t wol_groups[WOL_GROUP_MAX];
+static int wol_group_count = 0;
+
+static bool group_is_valid(const wol_group_t *group)
+{
+    size_t name_len = strnlen(group->name, WOL_GROUP_NAME_MAX);
+    return name_len > 0 && name_len < WOL_GROUP_NAME_MAX && group->count > 0 && group->count <= WOL_MAX_TARGETS;
+}
+
+void wol_groups_load(void)
+{
+    wol_group_count = 0;
+
+    nvs_handle_t handle;
+    if (nvs_open(WOL_GROUPS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK)
+    {
+        return;
+    }
+
+    size_t size = sizeof(wol_groups);
+    esp_err_t err = nvs_get_blob(handle, WOL_GROUPS_KEY, wol_groups, &size);
+    nvs_close(handle);
+    if (err != ESP_OK || size % sizeof(wol_group_t) != 0)
+    {
+        return;
+    }
+
+    int count = (int)(size / sizeof(wol_group_t));
+    for (int i = 0; i < count; i++)
+    {
+        if (!group_is_valid(&wol_groups[i]))
+        {
+            ESP_LOGW(TAG, "Discarding invalid WoL groups");
+            return;
+        }
+    }
+    wol_group_count = count;
+    ESP_LOGI(TAG, "Loaded %d WoL groups", count);
+}
+
+static bool groups_save(void)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(WOL_GROUPS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK)
+    {
+        err = (wol_group_count > 0)
+                  ? nvs_set_blob(handle, WOL_GROUPS_KEY, wol_groups, (size_t)wol_group_count * sizeof(wol_group_t))
+                  : nvs_erase_key(handle, WOL_GROUPS_KEY);
+        if (err == ESP_ERR_NVS_NOT_FOUND)
+        {
+            err = ESP_OK; // nada a apagar
+        }
+        if (err == ESP_OK)
+        {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to save WoL groups: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+static int group_index(const char *name, int name_len)
+{
+    for (int i = 0; i < wol_group_count; i++)
+    {
+        if (strlen(wol_groups[i].name) == (size_t)name_len && memcmp(wol_groups[i].name, name, name_len) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const wol_group_t *wol_groups_find(const char *name, int name_len)
+{
+    int index = group_index(name, name_len);
+    return index >= 0 ? &wol_groups[index] : NULL;
+}
+
+bool wol_groups_set(const char *name, int name_len, const uint8_t (*macs)[WOL_MAC_LEN], int count)
+{
+    if (!name || name_len <= 0 || name_len >= WOL_GROUP_NAME_MAX || count < 0 || count > WOL_MAX_TARGETS)
+    {
+        return false;
+    }
+
+    int index = group_index(name, name_len);
+    if (count == 0)
+    {
+        if (index < 0)
+        {
+            return true;
+        }
+        memmove(&wol_groups[index], &wol_groups[index + 1], (size_t)(wol_group_count - index - 1) * sizeof(wol_group_t));
+        wol_group_count--;
+        return groups_save();
+    }
+
+    if (index < 0)
+    {
+        if (wol_group_count >= WOL_GROUP_MAX)
+        {
+            return false;
+        }
+        index = wol_group_count++;
+    }
+
+    wol_group_t *group = &wol_groups[index];
+    memset(group, 0, sizeof(*group));
+    memcpy(group->name, name, (size_t)name_len);
+    group->count = (uint8_t)count;
+    memcpy(group->macs, macs, (size_t)count * WOL_MAC_LEN);
+    return groups_save();
+}
+
+int wol_groups_count(void)
+{
+    return wol_group_count;
+}
+
+const wol_group_t *wol_groups_get(int index)
+{
+    return (index >= 0 && index < wol_group_count) ? &wol_groups[index] : NULL;
+}
@@ -0,0 +1,32 @@
+#ifndef WOL_GROUPS_H
+#define WOL_GROUPS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "wol_packet.h"
+
+// Grupos nomeados de alvos de WoL ("lab", "rack1"...), guardados na NVS:
+// o servidor acorda um grupo inteiro com {"action":"wol","group":"lab"}.
+// Usados só pela task do WS (e por wol_groups_load no boot).
+
+#define WOL_GROUP_MAX 8
+#define WOL_GROUP_NAME_MAX 16 // com o '\0'
+
+typedef struct
+{
+    char name[WOL_GROUP_NAME_MAX];
+    uint8_t count;
+    uint8_t macs[WOL_MAX_TARGETS][WOL_MAC_LEN];
+} wol_group_t;
+
+// Lê os grupos salvos. Sem nada salvo (ou com dados inválidos), começa vazio.
+void wol_groups_load(void);
+const wol_group_t *wol_groups_find(const char *name, int name_len);
+// Cria ou substitui o grupo e salva; count 0 remove. Retorna false com nome
+// inválido, sem espaço para outro grupo ou se a NVS falhar.
+bool wol_groups_set(const char *name, int name_len, const uint8_t (*macs)[WOL_MAC_LEN], int count);
+int wol_groups_count(void);
+const wol_group_t *wol_groups_get(int index);
+
+#endif
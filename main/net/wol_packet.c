@@ -0,0 +1,57 @@
+#include <string.h>
+
+#include "wol_packet.h"
+
+static wol_packet_t wol_packet_cache[WOL_PACKET_CACHE_SIZE];
+static int wol_packet_cache_next = 0;
+
+void wol_options_init(wol_options_t *options)
+{
+    memset(options, 0, sizeof(*options));
+    options->burst = WOL_DEFAULT_BURST;
+    options->spacing_ms = WOL_DEFAULT_SPACING_MS;
+    options->rate_pps = WOL_DEFAULT_RATE_PPS;
+    options->ports = WOL_SEND_PORT_9;
+}
+
+void wol_packet_build(wol_packet_t *packet, const uint8_t *mac, const uint8_t *password)
+{
+    memset(packet->data, 0xFF, WOL_MAC_LEN);
+    for (int i = 0; i < 16; i++)
+    {
+        memcpy(&packet->data[WOL_MAC_LEN + i * WOL_MAC_LEN], mac, WOL_MAC_LEN);
+    }
+    packet->len = WOL_PACKET_LEN;
+    if (password)
+    {
+        memcpy(&packet->data[WOL_PACKET_LEN], password, WOL_SECUREON_LEN);
+        packet->len += WOL_SECUREON_LEN;
+    }
+}
+
+// O próprio pacote é a chave: MAC logo depois do cabeçalho e a senha no fim.
+static bool packet_matches(const wol_packet_t *packet, const uint8_t *mac, const uint8_t *password)
+{
+    if (packet->len != (password ? WOL_PACKET_MAX_LEN : WOL_PACKET_LEN) ||
+        memcmp(&packet->data[WOL_MAC_LEN], mac, WOL_MAC_LEN) != 0)
+    {
+        return false;
+    }
+    return !password || memcmp(&packet->data[WOL_PACKET_LEN], password, WOL_SECUREON_LEN) == 0;
+}
+
+const wol_packet_t *wol_packet_get(const uint8_t *mac, const uint8_t *password)
+{
+    for (int i = 0; i < WOL_PACKET_CACHE_SIZE; i++)
+    {
+        if (packet_matches(&wol_packet_cache[i], mac, password))
+        {
+            return &wol_packet_cache[i];
+        }
+    }
+
+    wol_packet_t *packet = &wol_packet_cache[wol_packet_cache_next];
+    wol_packet_cache_next = (wol_packet_cache_next + 1) % WOL_PACKET_CACHE_SIZE;
+    wol_packet_build(packet, mac, password);
+    return packet;
+}
@@ -0,0 +1,57 @@
+#ifndef WOL_PACKET_H
+#define WOL_PACKET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pacote mágico do Wake-on-LAN e opções de envio, sem dependências do IDF
+// (também compilam no build de host). O envio fica em wol_sender.c.
+
+#define WOL_MAC_LEN 6
+#define WOL_SECUREON_LEN 6
+#define WOL_PACKET_LEN 102 // 6 x 0xFF + 16 x MAC
+#define WOL_PACKET_MAX_LEN (WOL_PACKET_LEN + WOL_SECUREON_LEN)
+#define WOL_PACKET_CACHE_SIZE 8
+
+// Portas de destino (wol_options_t.ports).
+#define WOL_SEND_PORT_9 (1u << 0) // discard, a padrão
+#define WOL_SEND_PORT_7 (1u << 1) // echo
+
+#define WOL_MAX_BURST 10
+#define WOL_MAX_SPACING_MS 1000
+// Uma cópia por padrão, como antes do burst; em Wi-Fi congestionado o
+// servidor pede mais.
+#define WOL_DEFAULT_BURST 1
+#define WOL_DEFAULT_SPACING_MS 20
+// Alvos num único envio (lista de MACs ou grupo).
+#define WOL_MAX_TARGETS 64
+// Ritmo dos envios para vários alvos: 64 alvos saem em ~320 ms sem inundar o AP.
+#define WOL_DEFAULT_RATE_PPS 200
+#define WOL_MAX_RATE_PPS 1000
+
+typedef struct
+{
+    uint8_t data[WOL_PACKET_MAX_LEN];
+    int len;
+} wol_packet_t;
+
+typedef struct
+{
+    uint8_t burst;       // cópias por porta (1..WOL_MAX_BURST)
+    uint16_t spacing_ms; // intervalo entre as cópias
+    uint16_t rate_pps;   // pacotes por segundo, somando todos os alvos
+    uint8_t ports;       // WOL_SEND_PORT_*
+    bool directed;       // broadcast da sub-rede da interface em vez de 255.255.255.255
+    bool secureon;       // anexa password (SecureOn)
+    uint8_t password[WOL_SECUREON_LEN];
+} wol_options_t;
+
+void wol_options_init(wol_options_t *options);
+
+void wol_packet_build(wol_packet_t *packet, const uint8_t *mac, const uint8_t *password);
+// Pacote do alvo (password NULL = sem SecureOn), montado uma vez e guardado
+// num cache dos últimos WOL_PACKET_CACHE_SIZE alvos. O ponteiro vale até a
+// próxima chamada; usado só pela task do WS.
+const wol_packet_t *wol_packet_get(const uint8_t *mac, const uint8_t *password);
+
+#endif
@@ -0,0 +1,162 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/select.h>
+
+#include "esp_timer.h"
+
+#include "lwip/inet.h"
+#include "lwip/sockets.h"
+
+#include "wol_probe.h"
+
+#define WOL_PROBE_ICMP_ECHO_REQUEST 8
+#define WOL_PROBE_ICMP_ECHO_REPLY 0
+#define WOL_PROBE_ICMP_ID 0x574F // "WO"
+#define WOL_PROBE_ICMP_HEADER_LEN 8
+#define WOL_PROBE_ICMP_PAYLOAD_LEN 16
+
+static uint16_t wol_probe_seq = 0;
+
+static struct timeval timeval_from_us(int64_t us)
+{
+    struct timeval tv = {
+        .tv_sec = (long)(us / 1000000),
+        .tv_usec = (long)(us % 1000000),
+    };
+    return tv;
+}
+
+// Espera o socket ficar pronto para leitura (ou escrita) até deadline_us.
+static bool wait_ready(int sock, bool write, int64_t deadline_us)
+{
+    int64_t remaining_us = deadline_us - esp_timer_get_time();
+    if (remaining_us <= 0)
+    {
+        return false;
+    }
+
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(sock, &fds);
+    struct timeval tv = timeval_from_us(remaining_us);
+    int ready = write ? select(sock + 1, NULL, &fds, NULL, &tv) : select(sock + 1, &fds, NULL, NULL, &tv);
+    return ready > 0;
+}
+
+// RST também prova que o host está de pé: só a porta não está aberta.
+static wol_probe_result_t probe_tcp(uint32_t address, uint16_t port, int64_t deadline_us)
+{
+    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock < 0)
+    {
+        return WOL_PROBE_ERROR;
+    }
+
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = address,
+    };
+    wol_probe_result_t result = WOL_PROBE_NO_REPLY;
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0 || errno == ECONNREFUSED)
+    {
+        result = WOL_PROBE_ALIVE;
+    }
+    else if (errno == EINPROGRESS && wait_ready(sock, true, deadline_us))
+    {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && (err == 0 || err == ECONNREFUSED))
+        {
+            result = WOL_PROBE_ALIVE;
+        }
+    }
+    close(sock);
+    return result;
+}
+
+static uint16_t icmp_checksum(const uint8_t *data, int len)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i + 1 < len; i += 2)
+    {
+        sum += (uint32_t)(data[i] << 8 | data[i + 1]);
+    }
+    if (len & 1)
+    {
+        sum += (uint32_t)data[len - 1] << 8;
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (uint16_t)~sum;
+}
+
+// Socket raw: o que chega traz o cabeçalho IP antes do ICMP.
+static bool is_echo_reply(const uint8_t *data, int len, uint16_t seq)
+{
+    if (len < 20)
+    {
+        return false;
+    }
+    int ip_len = (data[0] & 0x0F) * 4;
+    if (len < ip_len + WOL_PROBE_ICMP_HEADER_LEN)
+    {
+        return false;
+    }
+    const uint8_t *icmp = data + ip_len;
+    return icmp[0] == WOL_PROBE_ICMP_ECHO_REPLY && (icmp[4] << 8 | icmp[5]) == WOL_PROBE_ICMP_ID &&
+           (icmp[6] << 8 | icmp[7]) == seq;
+}
+
+static wol_probe_result_t probe_icmp(uint32_t address, int64_t deadline_us)
+{
+    int sock = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+    if (sock < 0)
+    {
+        return WOL_PROBE_ERROR;
+    }
+
+    uint16_t seq = ++wol_probe_seq;
+    uint8_t echo[WOL_PROBE_ICMP_HEADER_LEN + WOL_PROBE_ICMP_PAYLOAD_LEN] = {
+        WOL_PROBE_ICMP_ECHO_REQUEST, 0, 0, 0, WOL_PROBE_ICMP_ID >> 8, WOL_PROBE_ICMP_ID & 0xFF, seq >> 8, seq & 0xFF,
+    };
+    memset(echo + WOL_PROBE_ICMP_HEADER_LEN, 0xA5, WOL_PROBE_ICMP_PAYLOAD_LEN);
+    uint16_t checksum = icmp_checksum(echo, sizeof(echo));
+    echo[2] = checksum >> 8;
+    echo[3] = checksum & 0xFF;
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = address,
+    };
+    wol_probe_result_t result = WOL_PROBE_NO_REPLY;
+    if (sendto(sock, echo, sizeof(echo), 0, (struct sockaddr *)&addr, sizeof(addr)) == (int)sizeof(echo))
+    {
+        uint8_t reply[128];
+        while (result != WOL_PROBE_ALIVE && wait_ready(sock, false, deadline_us))
+        {
+            struct sockaddr_in from;
+            socklen_t from_len = sizeof(from);
+            int len = recvfrom(sock, reply, sizeof(reply), 0, (struct sockaddr *)&from, &from_len);
+            if (len > 0 && from.sin_addr.s_addr == address && is_echo_reply(reply, len, seq))
+            {
+                result = WOL_PROBE_ALIVE;
+            }
+        }
+    }
+    close(sock);
+    return result;
+}
+
+wol_probe_result_t wol_probe(wol_probe_kind_t kind, uint32_t address, uint16_t port, uint32_t timeout_ms)
+{
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    return (kind == WOL_PROBE_TCP) ? probe_tcp(address, port, deadline_us) : probe_icmp(address, deadline_us);
+}
@@ -0,0 +1,25 @@
+#ifndef WOL_PROBE_H
+#define WOL_PROBE_H
+
+#include <stdint.h>
+
+// Sonda de alcance de um alvo do WoL: eco ICMP ou connect TCP numa porta.
+// Bloqueia quem chama por até timeout_ms (usada só pela task de verificação).
+
+typedef enum
+{
+    WOL_PROBE_ICMP = 0,
+    WOL_PROBE_TCP,
+} wol_probe_kind_t;
+
+typedef enum
+{
+    WOL_PROBE_ALIVE = 0, // eco respondido, ou connect aceito/recusado (RST = host de pé)
+    WOL_PROBE_NO_REPLY,  // nada dentro do prazo (ou rede inalcançável)
+    WOL_PROBE_ERROR,     // não deu para abrir o socket
+} wol_probe_result_t;
+
+// address em ordem de rede; port só vale para WOL_PROBE_TCP.
+wol_probe_result_t wol_probe(wol_probe_kind_t kind, uint32_t address, uint16_t port, uint32_t timeout_ms);
+
+#endif
@@ -0,0 +1,305 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+
+#include "lwip/inet.h"
+#include "lwip/sockets.h"
+
+#include "wol_sender.h"
+
+static const char *TAG = "ESP_WOL_SEND";
+
+#define WOL_QUEUE_LENGTH 4
+
+// Envio entregue à task do sender, em rodadas de uma cópia por alvo.
+// first_round = 1 quando a primeira cópia já saiu na task de quem chamou.
+typedef struct
+{
+    uint8_t macs[WOL_MAX_TARGETS][WOL_MAC_LEN];
+    uint8_t count;
+    uint8_t first_round;
+    wol_options_t options;
+    uint32_t address; // ordem de rede
+    int64_t start_us; // início da rodada 0 (esp_timer)
+} wol_job_t;
+
+static const struct
+{
+    uint8_t flag;
+    uint16_t port;
+} wol_ports[] = {
+    {WOL_SEND_PORT_9, 9},
+    {WOL_SEND_PORT_7, 7},
+};
+
+static int wol_socket = -1;
+static QueueHandle_t wol_queue = NULL;
+static wol_job_t wol_staging; // job sendo montado (task do WS)
+static wol_sender_stats_t wol_stats = {0};
+static portMUX_TYPE wol_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int wol_socket_open(void)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0)
+    {
+        return -1;
+    }
+
+    int broadcast = 1;
+    struct sockaddr_in local = {
+        .sin_family = AF_INET,
+        .sin_port = 0,
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast)) != 0 ||
+        bind(sock, (struct sockaddr *)&local, sizeof(local)) != 0)
+    {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// Broadcast dirigido (ip | ~máscara) da interface STA; sem IP, o limitado.
+static uint32_t wol_broadcast_address(bool directed)
+{
+    if (directed)
+    {
+        esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+        esp_netif_ip_info_t info;
+        if (netif && esp_netif_get_ip_info(netif, &info) == ESP_OK && info.ip.addr != 0)
+        {
+            return info.ip.addr | ~info.netmask.addr;
+        }
+    }
+    return htonl(INADDR_BROADCAST);
+}
+
+// Uma cópia para cada porta pedida. Retorna quantas saíram.
+static int wol_send_copy(const wol_packet_t *packet, uint32_t address, uint8_t ports)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = address,
+    };
+
+    int sent = 0;
+    int failed = 0;
+    for (size_t i = 0; i < sizeof(wol_ports) / sizeof(wol_ports[0]); i++)
+    {
+        if (!(ports & wol_ports[i].flag))
+        {
+            continue;
+        }
+        addr.sin_port = htons(wol_ports[i].port);
+        if (sendto(wol_socket, packet->data, packet->len, 0, (struct sockaddr *)&addr, sizeof(addr)) == packet->len)
+        {
+            sent++;
+        }
+        else
+        {
+            failed++;
+        }
+    }
+
+    taskENTER_CRITICAL(&wol_stats_lock);
+    wol_stats.packets += sent;
+    wol_stats.failures += failed;
+    taskEXIT_CRITICAL(&wol_stats_lock);
+    return sent;
+}
+
+// Espera até target_us. Esperas menores que um tick não dormem: o ritmo
+// médio se mantém, com as cópias saindo em grupos de até um tick.
+static void wol_wait_until(int64_t target_us)
+{
+    int64_t wait_us = target_us - esp_timer_get_time();
+    if (wait_us >= (int64_t)portTICK_PERIOD_MS * 1000)
+    {
+        vTaskDelay((TickType_t)(wait_us / 1000 / portTICK_PERIOD_MS));
+    }
+}
+
+// Uma cópia para cada alvo por rodada, a rate_pps cópias por segundo no
+// total; cada rodada começa spacing_ms depois da anterior (ou quando ela
+// termina, se os alvos forem muitos). Os pacotes são montados uma vez por
+// job, antes das rodadas (o cache de wol_packet_get é só da task do WS).
+static void wol_run_job(const wol_job_t *job)
+{
+    static wol_packet_t packets[WOL_MAX_TARGETS]; // só a task do sender usa
+    const wol_options_t *options = &job->options;
+    const uint8_t *password = options->secureon ? options->password : NULL;
+    for (int i = 0; i < job->count; i++)
+    {
+        wol_packet_build(&packets[i], job->macs[i], password);
+    }
+
+    int64_t interval_us = 1000000 / options->rate_pps;
+    int64_t next_us = job->start_us;
+    for (int round = job->first_round; round < options->burst; round++)
+    {
+        int64_t round_us = job->start_us + (int64_t)round * options->spacing_ms * 1000;
+        if (round_us > next_us)
+        {
+            next_us = round_us;
+        }
+        for (int i = 0; i < job->count; i++)
+        {
+            wol_wait_until(next_us);
+            wol_send_copy(&packets[i], job->address, options->ports);
+            next_us += interval_us;
+        }
+    }
+}
+
+static void wol_task(void *arg)
+{
+    static wol_job_t job; // grande demais para a pilha da task
+    while (1)
+    {
+        if (xQueueReceive(wol_queue, &job, portMAX_DELAY) == pdTRUE)
+        {
+            wol_run_job(&job);
+        }
+    }
+}
+
+static bool wol_enqueue(const wol_job_t *job, int targets)
+{
+    bool queued = xQueueSend(wol_queue, job, 0) == pdTRUE;
+    taskENTER_CRITICAL(&wol_stats_lock);
+    wol_stats.targets += targets;
+    if (!queued)
+    {
+        wol_stats.dropped++;
+    }
+    taskEXIT_CRITICAL(&wol_stats_lock);
+    return queued;
+}
+
+bool wol_sender_start(void)
+{
+    if (wol_queue != NULL)
+    {
+        return true;
+    }
+
+    wol_socket = wol_socket_open();
+    if (wol_socket < 0)
+    {
+        ESP_LOGE(TAG, "Failed to open UDP socket");
+        return false;
+    }
+
+    wol_queue = xQueueCreate(WOL_QUEUE_LENGTH, sizeof(wol_job_t));
+    if (wol_queue == NULL ||
+        xTaskCreatePinnedToCore(wol_task, "wol_sender", 3072, NULL, 4, NULL, 0) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create WoL sender task");
+        if (wol_queue)
+        {
+            vQueueDelete(wol_queue);
+            wol_queue = NULL;
+        }
+        close(wol_socket);
+        wol_socket = -1;
+        return false;
+    }
+    return true;
+}
+
+bool wol_send(const uint8_t *mac, const wol_options_t *options)
+{
+    if (!mac || wol_queue == NULL)
+    {
+        return false;
+    }
+
+    wol_options_t defaults;
+    if (!options)
+    {
+        wol_options_init(&defaults);
+        options = &defaults;
+    }
+
+    const wol_packet_t *packet = wol_packet_get(mac, options->secureon ? options->password : NULL);
+    uint32_t address = wol_broadcast_address(options->directed);
+    if (wol_send_copy(packet, address, options->ports) == 0)
+    {
+        ESP_LOGE(TAG, "Failed to send Wake-on-LAN packet");
+        return false;
+    }
+
+    if (options->burst > 1)
+    {
+        wol_job_t *job = &wol_staging;
+        memcpy(job->macs[0], mac, WOL_MAC_LEN);
+        job->count = 1;
+        job->first_round = 1;
+        job->options = *options;
+        job->address = address;
+        job->start_us = esp_timer_get_time();
+        wol_enqueue(job, 1); // sem espaço, ao menos a primeira cópia saiu
+    }
+    else
+    {
+        taskENTER_CRITICAL(&wol_stats_lock);
+        wol_stats.targets++;
+        taskEXIT_CRITICAL(&wol_stats_lock);
+    }
+
+    ESP_LOGI(TAG, "Wake-on-LAN sent to %02X:%02X:%02X:%02X:%02X:%02X (burst %u)", mac[0], mac[1], mac[2], mac[3],
+             mac[4], mac[5], options->burst);
+    return true;
+}
+
+bool wol_send_many(const uint8_t (*macs)[WOL_MAC_LEN], int count, const wol_options_t *options)
+{
+    if (!macs || count <= 0 || count > WOL_MAX_TARGETS || wol_queue == NULL)
+    {
+        return false;
+    }
+
+    wol_options_t defaults;
+    if (!options)
+    {
+        wol_options_init(&defaults);
+        options = &defaults;
+    }
+
+    wol_job_t *job = &wol_staging;
+    memcpy(job->macs, macs, (size_t)count * WOL_MAC_LEN);
+    job->count = (uint8_t)count;
+    job->first_round = 0;
+    job->options = *options;
+    job->address = wol_broadcast_address(options->directed);
+    job->start_us = esp_timer_get_time();
+    if (!wol_enqueue(job, 0))
+    {
+        ESP_LOGW(TAG, "WoL sender busy, %d targets dropped", count);
+        return false;
+    }
+
+    taskENTER_CRITICAL(&wol_stats_lock);
+    wol_stats.targets += count;
+    taskEXIT_CRITICAL(&wol_stats_lock);
+    ESP_LOGI(TAG, "Wake-on-LAN queued for %d targets (burst %u, %u pps)", count, options->burst, options->rate_pps);
+    return true;
+}
+
+void wol_sender_get_stats(wol_sender_stats_t *stats)
+{
+    if (stats)
+    {
+        taskENTER_CRITICAL(&wol_stats_lock);
+        *stats = wol_stats;
+        taskEXIT_CRITICAL(&wol_stats_lock);
+    }
+}
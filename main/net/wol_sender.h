@@ -0,0 +1,31 @@
+#ifndef WOL_SENDER_H
+#define WOL_SENDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "wol_packet.h"
+
+// Envio de Wake-on-LAN por um socket UDP único, aberto (com SO_BROADCAST) no
+// boot. A primeira cópia de um alvo sai na hora, na task de quem chama; as
+// demais da rajada, e os envios para vários alvos, ficam com a task do
+// sender, espaçados sem bloquear o WS. Chamados só pela task do WS.
+
+typedef struct
+{
+    uint32_t targets;  // alvos aceitos
+    uint32_t packets;  // cópias enviadas (todas as portas)
+    uint32_t failures; // sendto com erro
+    uint32_t dropped;  // envios descartados com a fila do sender cheia
+} wol_sender_stats_t;
+
+bool wol_sender_start(void);
+// options NULL usa os padrões. Retorna false se a primeira cópia não saiu
+// por nenhuma porta.
+bool wol_send(const uint8_t *mac, const wol_options_t *options);
+// Vários alvos (até WOL_MAX_TARGETS), inteiramente na task do sender, no
+// ritmo de options->rate_pps. Retorna false com a fila do sender cheia.
+bool wol_send_many(const uint8_t (*macs)[WOL_MAC_LEN], int count, const wol_options_t *options);
+void wol_sender_get_stats(wol_sender_stats_t *stats);
+
+#endif
@@ -0,0 +1,218 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "wol_verify.h"
+
+static const char *TAG = "ESP_WOL_VERIFY";
+
+// Intervalo entre sondas: começa em WOL_VERIFY_BACKOFF_MIN_MS e dobra até o
+// teto, que limita a resolução de aliveAfterMs numa máquina que demora a subir.
+#define WOL_VERIFY_BACKOFF_MIN_MS 250
+#define WOL_VERIFY_BACKOFF_MAX_MS 4000
+// Prazo de cada sonda (sem resposta nesse tempo, tenta de novo depois).
+#define WOL_VERIFY_PROBE_TIMEOUT_MS 500
+
+typedef struct
+{
+    bool active;
+    wol_verify_request_t request;
+    int64_t start_us;
+    int64_t next_us;
+    uint32_t backoff_ms;
+    uint16_t probes;
+} wol_verify_slot_t;
+
+// A task do WS só ocupa vagas livres; a task de verificação só as libera.
+static wol_verify_slot_t wol_verify_slots[WOL_VERIFY_MAX];
+static TaskHandle_t wol_verify_task_handle = NULL;
+static wol_verify_stats_t wol_verify_stats = {0};
+static portMUX_TYPE wol_verify_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void verify_finish(wol_verify_slot_t *slot, wol_probe_result_t status, int64_t now_us)
+{
+    wol_verify_result_t result = {
+        .request = slot->request,
+        .status = status,
+        .elapsed_ms = (uint32_t)((now_us - slot->start_us) / 1000),
+        .probes = slot->probes,
+    };
+
+    taskENTER_CRITICAL(&wol_verify_lock);
+    if (status == WOL_PROBE_ALIVE)
+    {
+        wol_verify_stats.alive++;
+        wol_verify_stats.last_alive_ms = result.elapsed_ms;
+        if (result.elapsed_ms > wol_verify_stats.max_alive_ms)
+        {
+            wol_verify_stats.max_alive_ms = result.elapsed_ms;
+        }
+    }
+    else if (status == WOL_PROBE_NO_REPLY)
+    {
+        wol_verify_stats.timeouts++;
+    }
+    else
+    {
+        wol_verify_stats.errors++;
+    }
+    slot->active = false;
+    taskEXIT_CRITICAL(&wol_verify_lock);
+
+    const uint8_t *mac = result.request.mac;
+    ESP_LOGI(TAG, "%02X:%02X:%02X:%02X:%02X:%02X %s after %u ms (%u probes)", mac[0], mac[1], mac[2], mac[3], mac[4],
+             mac[5], status == WOL_PROBE_ALIVE ? "alive" : "not alive", (unsigned)result.elapsed_ms,
+             (unsigned)result.probes);
+    if (result.request.callback)
+    {
+        result.request.callback(&result);
+    }
+}
+
+static void verify_probe(wol_verify_slot_t *slot)
+{
+    int64_t probe_us = esp_timer_get_time();
+    int64_t deadline_us = slot->start_us + (int64_t)slot->request.timeout_ms * 1000;
+    int64_t remaining_ms = (deadline_us - probe_us) / 1000;
+    uint32_t probe_timeout_ms = WOL_VERIFY_PROBE_TIMEOUT_MS;
+    if (remaining_ms < probe_timeout_ms)
+    {
+        probe_timeout_ms = remaining_ms > 0 ? (uint32_t)remaining_ms : 1;
+    }
+
+    wol_probe_result_t status =
+        wol_probe(slot->request.kind, slot->request.address, slot->request.port, probe_timeout_ms);
+    slot->probes++;
+
+    int64_t now_us = esp_timer_get_time();
+    if (status != WOL_PROBE_NO_REPLY || now_us >= deadline_us)
+    {
+        verify_finish(slot, status, now_us);
+        return;
+    }
+
+    slot->next_us = probe_us + (int64_t)slot->backoff_ms * 1000;
+    if (slot->next_us > deadline_us)
+    {
+        slot->next_us = deadline_us; // última sonda no prazo
+    }
+    if (slot->backoff_ms < WOL_VERIFY_BACKOFF_MAX_MS)
+    {
+        slot->backoff_ms *= 2;
+    }
+}
+
+int64_t wol_verify_run_due(void)
+{
+    int64_t next_us = -1;
+    for (int i = 0; i < WOL_VERIFY_MAX; i++)
+    {
+        wol_verify_slot_t *slot = &wol_verify_slots[i];
+        taskENTER_CRITICAL(&wol_verify_lock);
+        bool active = slot->active;
+        taskEXIT_CRITICAL(&wol_verify_lock);
+        if (!active)
+        {
+            continue;
+        }
+
+        if (slot->next_us <= esp_timer_get_time())
+        {
+            verify_probe(slot);
+        }
+        if (slot->active && (next_us < 0 || slot->next_us < next_us))
+        {
+            next_us = slot->next_us;
+        }
+    }
+    return next_us;
+}
+
+static void wol_verify_task(void *arg)
+{
+    while (1)
+    {
+        int64_t next_us = wol_verify_run_due();
+        TickType_t wait = portMAX_DELAY;
+        if (next_us >= 0)
+        {
+            int64_t wait_us = next_us - esp_timer_get_time();
+            wait = (wait_us > 0) ? pdMS_TO_TICKS((wait_us + 999) / 1000) : 0;
+        }
+        // Um pedido novo acorda a task antes do prazo.
+        xTaskNotifyWait(0, UINT32_MAX, NULL, wait);
+    }
+}
+
+bool wol_verify_start(void)
+{
+    if (wol_verify_task_handle != NULL)
+    {
+        return true;
+    }
+
+    if (xTaskCreatePinnedToCore(wol_verify_task, "wol_verify", 3072, NULL, 3, &wol_verify_task_handle, 0) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create WoL verify task");
+        wol_verify_task_handle = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool wol_verify_request(const wol_verify_request_t *request)
+{
+    if (!request || request->timeout_ms == 0 || request->timeout_ms > WOL_VERIFY_MAX_TIMEOUT_MS)
+    {
+        return false;
+    }
+
+    wol_verify_slot_t *slot = NULL;
+    for (int i = 0; i < WOL_VERIFY_MAX && !slot; i++)
+    {
+        taskENTER_CRITICAL(&wol_verify_lock);
+        if (!wol_verify_slots[i].active)
+        {
+            slot = &wol_verify_slots[i];
+        }
+        taskEXIT_CRITICAL(&wol_verify_lock);
+    }
+    if (!slot)
+    {
+        taskENTER_CRITICAL(&wol_verify_lock);
+        wol_verify_stats.rejected++;
+        taskEXIT_CRITICAL(&wol_verify_lock);
+        return false;
+    }
+
+    // A primeira sonda sai na hora: um alvo que já estava ligado responde nela.
+    slot->request = *request;
+    slot->start_us = esp_timer_get_time();
+    slot->next_us = slot->start_us;
+    slot->backoff_ms = WOL_VERIFY_BACKOFF_MIN_MS;
+    slot->probes = 0;
+    taskENTER_CRITICAL(&wol_verify_lock);
+    slot->active = true;
+    wol_verify_stats.started++;
+    taskEXIT_CRITICAL(&wol_verify_lock);
+
+    if (wol_verify_task_handle)
+    {
+        xTaskNotify(wol_verify_task_handle, 0, eNoAction);
+    }
+    return true;
+}
+
+void wol_verify_get_stats(wol_verify_stats_t *stats)
+{
+    if (stats)
+    {
+        taskENTER_CRITICAL(&wol_verify_lock);
+        *stats = wol_verify_stats;
+        taskEXIT_CRITICAL(&wol_verify_lock);
+    }
+}
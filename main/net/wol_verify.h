@@ -0,0 +1,60 @@
+#ifndef WOL_VERIFY_H
+#define WOL_VERIFY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "wol_packet.h"
+#include "wol_probe.h"
+
+// Verificação do WoL: depois do envio, uma task própria sonda o IP do alvo
+// (wol_probe) com back-off exponencial até ele responder ou o prazo estourar,
+// e entrega o resultado por callback. As sondas bloqueiam só essa task.
+
+#define WOL_VERIFY_MAX 4 // verificações em andamento
+#define WOL_VERIFY_DEFAULT_TIMEOUT_MS 120000
+#define WOL_VERIFY_MAX_TIMEOUT_MS 600000
+
+typedef struct wol_verify_result wol_verify_result_t;
+// Chamado na task de verificação.
+typedef void (*wol_verify_callback_t)(const wol_verify_result_t *result);
+
+typedef struct
+{
+    uint8_t mac[WOL_MAC_LEN];
+    uint32_t address; // IPv4, ordem de rede
+    wol_probe_kind_t kind;
+    uint16_t port; // WOL_PROBE_TCP
+    uint32_t timeout_ms;
+    wol_verify_callback_t callback;
+} wol_verify_request_t;
+
+struct wol_verify_result
+{
+    wol_verify_request_t request;
+    wol_probe_result_t status; // ALIVE; NO_REPLY = prazo estourado; ERROR = sonda impossível
+    uint32_t elapsed_ms;       // do pedido até a resposta (ou até desistir)
+    uint16_t probes;
+};
+
+typedef struct
+{
+    uint32_t started;
+    uint32_t alive;
+    uint32_t timeouts;
+    uint32_t errors;
+    uint32_t rejected; // pedidos sem vaga
+    uint32_t last_alive_ms;
+    uint32_t max_alive_ms;
+} wol_verify_stats_t;
+
+bool wol_verify_start(void);
+// Chamado pela task do WS. Retorna false sem vaga (WOL_VERIFY_MAX em andamento).
+bool wol_verify_request(const wol_verify_request_t *request);
+// Faz as sondas vencidas e devolve quando vence a próxima (esp_timer, µs), ou
+// -1 sem verificação pendente. Usado pela task; exposto para o build de host
+// rodar as verificações de forma síncrona.
+int64_t wol_verify_run_due(void);
+void wol_verify_get_stats(wol_verify_stats_t *stats);
+
+#endif
@@ -0,0 +1,1152 @@
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+#include "ws_command.h"
+#include "ws_name_index.h"
+
+static const char *TAG = "ESP_WOL_CMD";
+
+// Profundidade máxima de objetos/arrays ignorados; acima disso usa o cJSON.
+#define WS_COMMAND_MAX_DEPTH 16
+
+typedef struct
+{
+    const char *p;
+    const char *end;
+} ws_cursor_t;
+
+typedef struct
+{
+    ws_field_t *field;        // destino do valor (NULL = ignorar)
+    ws_rgbw_fields_t *nested; // destino dos membros quando o valor é objeto
+} ws_member_target_t;
+
+typedef ws_member_target_t (*ws_member_lookup_fn)(const void *context, void *target, const char *key, int key_len);
+// Lê um item de array em target pelo tokenizer; false = usar o cJSON.
+typedef bool (*ws_fields_parse_fn)(const void *context, const char *json, size_t len, void *target);
+// Preenche target a partir de um objeto do cJSON; com NULL (ou não-objeto),
+// só zera.
+typedef void (*ws_fields_from_cjson_fn)(const void *context, const cJSON *object, void *target);
+
+// Membro de um struct de campos: a chave no JSON e as posições (offsetof) do
+// ws_field_t e, quando houver, dos canais do objeto aninhado e do nó do cJSON
+// do array.
+typedef struct
+{
+    const char *name;
+    uint16_t field;
+    int16_t nested; // ws_rgbw_fields_t; -1 = nenhum
+    int16_t json;   // const cJSON *; -1 = nenhum
+} ws_member_def_t;
+
+// Membros de um struct de campos e o índice das chaves (até
+// WS_NAME_INDEX_SLOTS / 2), montado na primeira mensagem.
+typedef struct
+{
+    const ws_member_def_t *members;
+    int count;
+    size_t size;
+    ws_name_index_t index;
+} ws_schema_t;
+
+#define MEMBER(type, key, member) {key, offsetof(type, member), -1, -1}
+#define MEMBER_ARRAY(type, key, member, json_member) {key, offsetof(type, member), -1, offsetof(type, json_member)}
+#define MEMBER_OBJECT(type, key, member, nested_member) \
+    {key, offsetof(type, member), offsetof(type, nested_member), -1}
+#define SCHEMA(type, table) \
+    {.members = table, .count = (int)(sizeof(table) / sizeof(table[0])), .size = sizeof(type)}
+
+static const ws_member_def_t rgbw_members[] = {
+    MEMBER(ws_rgbw_fields_t, "r", r),
+    MEMBER(ws_rgbw_fields_t, "g", g),
+    MEMBER(ws_rgbw_fields_t, "b", b),
+    MEMBER(ws_rgbw_fields_t, "w", w),
+};
+
+static const ws_member_def_t led_members[] = {
+    MEMBER(ws_led_fields_t, "r", color.r),
+    MEMBER(ws_led_fields_t, "g", color.g),
+    MEMBER(ws_led_fields_t, "b", color.b),
+    MEMBER(ws_led_fields_t, "w", color.w),
+    MEMBER(ws_led_fields_t, "effect", effect),
+    MEMBER(ws_led_fields_t, "speed", speed),
+    MEMBER(ws_led_fields_t, "density", density),
+    MEMBER(ws_led_fields_t, "palette", palette),
+    MEMBER_ARRAY(ws_led_fields_t, "colors", colors, colors_json),
+    MEMBER(ws_led_fields_t, "startAt", start_at),
+    MEMBER(ws_led_fields_t, "transitionMs", transition_ms),
+    MEMBER(ws_led_fields_t, "segment", segment),
+    MEMBER(ws_led_fields_t, "atMs", at_ms),
+};
+
+static const ws_member_def_t output_members[] = {
+    MEMBER(ws_output_fields_t, "ledCount", led_count),
+    MEMBER(ws_output_fields_t, "ledPin", led_pin),
+    MEMBER(ws_output_fields_t, "ledType", led_type),
+    MEMBER(ws_output_fields_t, "backend", backend),
+};
+
+static const ws_member_def_t segment_members[] = {
+    MEMBER(ws_segment_fields_t, "name", name),
+    MEMBER(ws_segment_fields_t, "start", start),
+    MEMBER(ws_segment_fields_t, "length", length),
+    MEMBER(ws_segment_fields_t, "reversed", reversed),
+};
+
+static const ws_member_def_t wol_members[] = {
+    MEMBER(ws_wol_fields_t, "mac", mac),
+    MEMBER_ARRAY(ws_wol_fields_t, "macs", macs, macs_json),
+    MEMBER(ws_wol_fields_t, "group", group),
+    MEMBER(ws_wol_fields_t, "name", name),
+    MEMBER(ws_wol_fields_t, "rate", rate),
+    MEMBER(ws_wol_fields_t, "burst", burst),
+    MEMBER(ws_wol_fields_t, "spacingMs", spacing_ms),
+    MEMBER(ws_wol_fields_t, "port", port),
+    MEMBER(ws_wol_fields_t, "directed", directed),
+    MEMBER(ws_wol_fields_t, "password", password),
+    MEMBER(ws_wol_fields_t, "verify", verify),
+    MEMBER(ws_wol_fields_t, "ip", ip),
+    MEMBER(ws_wol_fields_t, "probePort", probe_port),
+    MEMBER(ws_wol_fields_t, "timeoutMs", timeout_ms),
+};
+
+static const ws_member_def_t config_members[] = {
+    MEMBER(ws_config_fields_t, "ledCount", output.led_count),
+    MEMBER(ws_config_fields_t, "ledPin", output.led_pin),
+    MEMBER(ws_config_fields_t, "ledType", output.led_type),
+    MEMBER(ws_config_fields_t, "backend", output.backend),
+    MEMBER(ws_config_fields_t, "brightness", brightness),
+    MEMBER(ws_config_fields_t, "maxMilliamps", max_milliamps),
+    MEMBER(ws_config_fields_t, "signedCommands", signed_commands),
+    MEMBER_OBJECT(ws_config_fields_t, "lastLedColor", last_led_color, last_color),
+    MEMBER_ARRAY(ws_config_fields_t, "outputs", outputs, outputs_json),
+    MEMBER_ARRAY(ws_config_fields_t, "segments", segments, segments_json),
+};
+
+static const ws_member_def_t timeline_members[] = {
+    MEMBER_ARRAY(ws_timeline_fields_t, "keyframes", keyframes, keyframes_json),
+    MEMBER(ws_timeline_fields_t, "durationMs", duration_ms),
+    MEMBER(ws_timeline_fields_t, "loop", loop),
+    MEMBER(ws_timeline_fields_t, "control", control),
+    MEMBER(ws_timeline_fields_t, "positionMs", position_ms),
+};
+
+static const ws_member_def_t batch_members[] = {
+    MEMBER_ARRAY(ws_batch_fields_t, "commands", commands, commands_json),
+};
+
+static ws_schema_t rgbw_schema = SCHEMA(ws_rgbw_fields_t, rgbw_members);
+static ws_schema_t led_schema = SCHEMA(ws_led_fields_t, led_members);
+static ws_schema_t output_schema = SCHEMA(ws_output_fields_t, output_members);
+static ws_schema_t segment_schema = SCHEMA(ws_segment_fields_t, segment_members);
+static ws_schema_t wol_schema = SCHEMA(ws_wol_fields_t, wol_members);
+static ws_schema_t config_schema = SCHEMA(ws_config_fields_t, config_members);
+static ws_schema_t timeline_schema = SCHEMA(ws_timeline_fields_t, timeline_members);
+static ws_schema_t batch_schema = SCHEMA(ws_batch_fields_t, batch_members);
+
+static ws_schema_t *const schemas[] = {
+    &rgbw_schema, &led_schema, &output_schema, &segment_schema,
+    &wol_schema, &config_schema, &timeline_schema, &batch_schema,
+};
+
+// Payload de cada tipo de comando; NULL = sem chaves no JSON (stream é só
+// binário).
+static const ws_schema_t *const command_payloads[WS_COMMAND_KIND_COUNT] = {
+    [WS_COMMAND_KIND_WOL] = &wol_schema,
+    [WS_COMMAND_KIND_LED] = &led_schema,
+    [WS_COMMAND_KIND_CONFIG] = &config_schema,
+    [WS_COMMAND_KIND_TIMELINE] = &timeline_schema,
+    [WS_COMMAND_KIND_BATCH] = &batch_schema,
+};
+
+typedef struct
+{
+    const char *action;
+    ws_command_kind_t kind;
+} ws_action_kind_t;
+
+static const ws_action_kind_t action_kinds[] = {
+    {"wol", WS_COMMAND_KIND_WOL},
+    {"wol_group", WS_COMMAND_KIND_WOL},
+    {"led", WS_COMMAND_KIND_LED},
+    {"effect", WS_COMMAND_KIND_LED},
+    {"config", WS_COMMAND_KIND_CONFIG},
+    {"timeline", WS_COMMAND_KIND_TIMELINE},
+    {"stream", WS_COMMAND_KIND_STREAM},
+    {"batch", WS_COMMAND_KIND_BATCH},
+};
+
+static ws_name_index_t action_kind_index;
+static bool schemas_ready = false;
+
+static void index_name(ws_name_index_t *index, const char *name, int value)
+{
+    if (!ws_name_index_add(index, name, value))
+    {
+        ESP_LOGE(TAG, "Failed to index key '%s'", name);
+    }
+}
+
+// Como os índices do dispatch: montados uma única vez, na task do WS.
+static void ensure_schemas(void)
+{
+    if (schemas_ready)
+    {
+        return;
+    }
+
+    for (size_t s = 0; s < sizeof(schemas) / sizeof(schemas[0]); s++)
+    {
+        ws_name_index_init(&schemas[s]->index);
+        for (int i = 0; i < schemas[s]->count; i++)
+        {
+            index_name(&schemas[s]->index, schemas[s]->members[i].name, i);
+        }
+    }
+    ws_name_index_init(&action_kind_index);
+    for (size_t i = 0; i < sizeof(action_kinds) / sizeof(action_kinds[0]); i++)
+    {
+        index_name(&action_kind_index, action_kinds[i].action, action_kinds[i].kind);
+    }
+    schemas_ready = true;
+}
+
+static ws_command_kind_t command_kind(const ws_field_t *action)
+{
+    if (!ws_field_is_string(action))
+    {
+        return WS_COMMAND_KIND_NONE;
+    }
+    int kind = ws_name_index_find(&action_kind_index, action->str, action->len);
+    return kind < 0 ? WS_COMMAND_KIND_NONE : (ws_command_kind_t)kind;
+}
+
+// Todos os membros da união começam no mesmo endereço.
+static void *command_payload(ws_command_t *cmd)
+{
+    return &cmd->wol;
+}
+
+static bool key_is(const char *key, int key_len, const char *name, int name_len)
+{
+    return key_len == name_len && memcmp(key, name, name_len) == 0;
+}
+
+#define KEY_IS(name) key_is(key, key_len, name, (int)sizeof(name) - 1)
+
+// context: o ws_schema_t de target.
+static ws_member_target_t schema_member(const void *context, void *target, const char *key, int key_len)
+{
+    const ws_schema_t *schema = (const ws_schema_t *)context;
+    ws_member_target_t member = {NULL, NULL};
+
+    int index = ws_name_index_find(&schema->index, key, key_len);
+    if (index >= 0)
+    {
+        const ws_member_def_t *def = &schema->members[index];
+        member.field = (ws_field_t *)((char *)target + def->field);
+        if (def->nested >= 0)
+        {
+            member.nested = (ws_rgbw_fields_t *)((char *)target + def->nested);
+        }
+    }
+    return member;
+}
+
+// Cabeçalho por comparação direta; o resto pelo esquema do payload
+// (context, NULL = sem payload).
+static ws_member_target_t command_member(const void *context, void *target, const char *key, int key_len)
+{
+    ws_command_t *cmd = (ws_command_t *)target;
+    ws_member_target_t member = {NULL, NULL};
+
+    if (KEY_IS("action"))
+    {
+        member.field = &cmd->action;
+    }
+    else if (KEY_IS("status"))
+    {
+        member.field = &cmd->status;
+    }
+    else if (KEY_IS("error"))
+    {
+        member.field = &cmd->error;
+    }
+    else if (context)
+    {
+        member = schema_member(context, command_payload(cmd), key, key_len);
+    }
+    return member;
+}
+
+static void skip_whitespace(ws_cursor_t *c)
+{
+    while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r'))
+    {
+        c->p++;
+    }
+}
+
+static bool consume(ws_cursor_t *c, char expected)
+{
+    skip_whitespace(c);
+    if (c->p >= c->end || *c->p != expected)
+    {
+        return false;
+    }
+    c->p++;
+    return true;
+}
+
+static bool consume_literal(ws_cursor_t *c, const char *literal, int len)
+{
+    if (c->end - c->p < len || memcmp(c->p, literal, len) != 0)
+    {
+        return false;
+    }
+    c->p += len;
+    return true;
+}
+
+static bool is_hex(char ch)
+{
+    return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+}
+
+// Cursor em '"'. Valida a string e devolve o conteúdo cru; has_escape indica
+// se ela precisa de decodificação (não feita aqui).
+static bool scan_string(ws_cursor_t *c, const char **out, int *out_len, bool *has_escape)
+{
+    if (c->p >= c->end || *c->p != '"')
+    {
+        return false;
+    }
+
+    const char *start = ++c->p;
+    *has_escape = false;
+    while (c->p < c->end)
+    {
+        char ch = *c->p;
+        if (ch == '"')
+        {
+            *out = start;
+            *out_len = (int)(c->p - start);
+            c->p++;
+            return true;
+        }
+
+        if ((unsigned char)ch < 0x20)
+        {
+            return false;
+        }
+
+        if (ch == '\\')
+        {
+            *has_escape = true;
+            c->p++;
+            if (c->p >= c->end)
+            {
+                return false;
+            }
+
+            if (*c->p == 'u')
+            {
+                if (c->end - c->p < 5 || !is_hex(c->p[1]) || !is_hex(c->p[2]) || !is_hex(c->p[3]) || !is_hex(c->p[4]))
+                {
+                    return false;
+                }
+                c->p += 4;
+            }
+            else if (!strchr("\"\\/bfnrt", *c->p))
+            {
+                return false;
+            }
+        }
+        c->p++;
+    }
+    return false;
+}
+
+static bool scan_number(ws_cursor_t *c, double *out)
+{
+    const char *start = c->p;
+    bool negative = false;
+    if (c->p < c->end && *c->p == '-')
+    {
+        negative = true;
+        c->p++;
+    }
+
+    if (c->p >= c->end || *c->p < '0' || *c->p > '9')
+    {
+        return false;
+    }
+
+    // Inteiros pequenos (o caso comum: r/g/b, ledCount) sem strtod.
+    int64_t integer = 0;
+    int digits = 0;
+    if (*c->p == '0')
+    {
+        c->p++;
+        digits = 1;
+    }
+    else
+    {
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9')
+        {
+            if (digits < 18)
+            {
+                integer = integer * 10 + (*c->p - '0');
+            }
+            digits++;
+            c->p++;
+        }
+    }
+
+    bool is_integer = digits < 18;
+    if (c->p < c->end && *c->p == '.')
+    {
+        is_integer = false;
+        c->p++;
+        if (c->p >= c->end || *c->p < '0' || *c->p > '9')
+        {
+            return false;
+        }
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9')
+        {
+            c->p++;
+        }
+    }
+
+    if (c->p < c->end && (*c->p == 'e' || *c->p == 'E'))
+    {
+        is_integer = false;
+        c->p++;
+        if (c->p < c->end && (*c->p == '+' || *c->p == '-'))
+        {
+            c->p++;
+        }
+        if (c->p >= c->end || *c->p < '0' || *c->p > '9')
+        {
+            return false;
+        }
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9')
+        {
+            c->p++;
+        }
+    }
+
+    if (is_integer)
+    {
+        *out = (double)(negative ? -integer : integer);
+        return true;
+    }
+
+    // O token é delimitado pela gramática acima; copia para garantir o NUL.
+    char buffer[64];
+    size_t len = (size_t)(c->p - start);
+    if (len >= sizeof(buffer))
+    {
+        return false;
+    }
+    memcpy(buffer, start, len);
+    buffer[len] = 0;
+    *out = strtod(buffer, NULL);
+    return true;
+}
+
+static bool parse_object(ws_cursor_t *c, ws_member_lookup_fn lookup, const void *context, void *target, int depth);
+
+// Lê um valor qualquer. Se field != NULL, registra tipo e conteúdo nele.
+static bool parse_value(ws_cursor_t *c, ws_field_t *field, int depth)
+{
+    skip_whitespace(c);
+    if (c->p >= c->end)
+    {
+        return false;
+    }
+
+    const char *start = c->p;
+    ws_field_kind_t kind = WS_FIELD_OTHER;
+    double number = 0;
+    const char *str = start;
+    int len = 0;
+
+    switch (*c->p)
+    {
+    case '"':
+    {
+        bool has_escape = false;
+        if (!scan_string(c, &str, &len, &has_escape))
+        {
+            return false;
+        }
+        if (has_escape && field)
+        {
+            return false; // campo conhecido precisa de decodificação -> cJSON
+        }
+        kind = WS_FIELD_STRING;
+        break;
+    }
+    case '{':
+        if (!parse_object(c, NULL, NULL, NULL, depth + 1))
+        {
+            return false;
+        }
+        kind = WS_FIELD_OBJECT;
+        break;
+    case '[':
+    {
+        if (depth + 1 > WS_COMMAND_MAX_DEPTH)
+        {
+            return false;
+        }
+        c->p++;
+        skip_whitespace(c);
+        if (c->p < c->end && *c->p == ']')
+        {
+            c->p++;
+        }
+        else
+        {
+            do
+            {
+                if (!parse_value(c, NULL, depth + 1))
+                {
+                    return false;
+                }
+            } while (consume(c, ','));
+
+            if (!consume(c, ']'))
+            {
+                return false;
+            }
+        }
+        kind = WS_FIELD_ARRAY;
+        break;
+    }
+    case 't':
+        if (!consume_literal(c, "true", 4))
+        {
+            return false;
+        }
+        break;
+    case 'f':
+        if (!consume_literal(c, "false", 5))
+        {
+            return false;
+        }
+        break;
+    case 'n':
+        if (!consume_literal(c, "null", 4))
+        {
+            return false;
+        }
+        break;
+    default:
+        if (!scan_number(c, &number))
+        {
+            return false;
+        }
+        kind = WS_FIELD_NUMBER;
+        break;
+    }
+
+    if (field && field->kind == WS_FIELD_ABSENT)
+    {
+        field->kind = kind;
+        field->number = number;
+        if (kind == WS_FIELD_STRING)
+        {
+            field->str = str;
+            field->len = len;
+        }
+        else
+        {
+            field->str = start;
+            field->len = (int)(c->p - start);
+        }
+    }
+    return true;
+}
+
+// Cursor antes de '{'. Membros reconhecidos por lookup são gravados; os demais
+// são validados e ignorados. Chaves duplicadas: vale a primeira (como no cJSON).
+static bool parse_object(ws_cursor_t *c, ws_member_lookup_fn lookup, const void *context, void *target, int depth)
+{
+    if (depth > WS_COMMAND_MAX_DEPTH || !consume(c, '{'))
+    {
+        return false;
+    }
+
+    skip_whitespace(c);
+    if (c->p < c->end && *c->p == '}')
+    {
+        c->p++;
+        return true;
+    }
+
+    do
+    {
+        skip_whitespace(c);
+        const char *key = NULL;
+        int key_len = 0;
+        bool key_escaped = false;
+        if (!scan_string(c, &key, &key_len, &key_escaped) || !consume(c, ':'))
+        {
+            return false;
+        }
+
+        ws_member_target_t member = {NULL, NULL};
+        if (lookup && !key_escaped)
+        {
+            member = lookup(context, target, key, key_len);
+        }
+
+        skip_whitespace(c);
+        if (member.nested && member.field && member.field->kind == WS_FIELD_ABSENT &&
+            c->p < c->end && *c->p == '{')
+        {
+            const char *start = c->p;
+            if (!parse_object(c, schema_member, &rgbw_schema, member.nested, depth + 1))
+            {
+                return false;
+            }
+            member.field->kind = WS_FIELD_OBJECT;
+            member.field->str = start;
+            member.field->len = (int)(c->p - start);
+        }
+        else if (!parse_value(c, member.field, depth))
+        {
+            return false;
+        }
+    } while (consume(c, ','));
+
+    return consume(c, '}');
+}
+
+// Lê um objeto inteiro em target (size bytes), zerando antes; em erro, target
+// volta zerado.
+static bool parse_fields(const char *json, size_t len, ws_member_lookup_fn lookup, const void *context, void *target,
+                         size_t size)
+{
+    memset(target, 0, size);
+    ws_cursor_t cursor = {json, json + len};
+    // Como o cJSON_Parse, o que vier depois do objeto raiz é ignorado.
+    if (!parse_object(&cursor, lookup, context, target, 0))
+    {
+        memset(target, 0, size);
+        return false;
+    }
+    return true;
+}
+
+// Acha "action" no objeto raiz antes do parse, para saber qual payload ler.
+// O servidor manda a ação primeiro, então em geral só a primeira chave é
+// lida. false = formato que o tokenizer não cobre.
+static bool scan_action(const char *json, size_t len, ws_field_t *action)
+{
+    ws_cursor_t cursor = {json, json + len};
+    if (!consume(&cursor, '{'))
+    {
+        return false;
+    }
+
+    skip_whitespace(&cursor);
+    if (cursor.p < cursor.end && *cursor.p == '}')
+    {
+        return true;
+    }
+
+    do
+    {
+        skip_whitespace(&cursor);
+        const char *key = NULL;
+        int key_len = 0;
+        bool key_escaped = false;
+        if (!scan_string(&cursor, &key, &key_len, &key_escaped) || !consume(&cursor, ':'))
+        {
+            return false;
+        }
+
+        if (!key_escaped && KEY_IS("action"))
+        {
+            return parse_value(&cursor, action, 0);
+        }
+        if (!parse_value(&cursor, NULL, 0))
+        {
+            return false;
+        }
+    } while (consume(&cursor, ','));
+
+    return consume(&cursor, '}');
+}
+
+bool ws_command_parse(const char *json, size_t len, ws_command_t *cmd)
+{
+    if (!json || !cmd)
+    {
+        return false;
+    }
+
+    ensure_schemas();
+    ws_field_t action = {0};
+    if (!scan_action(json, len, &action))
+    {
+        memset(cmd, 0, sizeof(*cmd));
+        return false;
+    }
+
+    ws_command_kind_t kind = command_kind(&action);
+    if (!parse_fields(json, len, command_member, command_payloads[kind], cmd, sizeof(*cmd)))
+    {
+        return false;
+    }
+    cmd->kind = kind;
+    return true;
+}
+
+static void set_number(ws_field_t *field, uint8_t value)
+{
+    field->kind = WS_FIELD_NUMBER;
+    field->number = value;
+}
+
+// Extensões opcionais de led/effect após o layout fixo: transição (2 bytes) e
+// índice do segmento (1 byte; WS_BINARY_SEGMENT_ALL = fita inteira).
+static void set_transition(ws_led_fields_t *led, const uint8_t *payload, size_t payload_len, size_t fixed_len)
+{
+    if (payload_len >= fixed_len + 2)
+    {
+        led->transition_ms.kind = WS_FIELD_NUMBER;
+        led->transition_ms.number = (uint16_t)((payload[fixed_len] << 8) | payload[fixed_len + 1]);
+    }
+    if (payload_len >= fixed_len + 3 && payload[fixed_len + 2] != WS_BINARY_SEGMENT_ALL)
+    {
+        set_number(&led->segment, payload[fixed_len + 2]);
+    }
+}
+
+static void set_name(ws_field_t *field, const char *name)
+{
+    field->kind = WS_FIELD_STRING;
+    field->str = name;
+    field->len = (int)strlen(name);
+}
+
+ws_status_t ws_command_parse_binary(const uint8_t *data, size_t len, ws_command_t *cmd)
+{
+    if (!data || !cmd)
+    {
+        return WS_STATUS_INVALID_PAYLOAD;
+    }
+
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->encoding = WS_ENCODING_BINARY;
+    if (len < WS_BINARY_HEADER_LEN)
+    {
+        return WS_STATUS_INVALID_PAYLOAD;
+    }
+
+    cmd->binary_action = data[1];
+    if (data[0] != WS_BINARY_VERSION)
+    {
+        return WS_STATUS_BAD_VERSION;
+    }
+
+    const uint8_t *payload = data + WS_BINARY_HEADER_LEN;
+    size_t payload_len = len - WS_BINARY_HEADER_LEN;
+    switch (cmd->binary_action)
+    {
+    case WS_BINARY_ACTION_WOL:
+        if (payload_len < 6)
+        {
+            return WS_STATUS_INVALID_PAYLOAD;
+        }
+        set_name(&cmd->action, "wol");
+        cmd->kind = WS_COMMAND_KIND_WOL;
+        cmd->wol.mac.kind = WS_FIELD_BYTES;
+        cmd->wol.mac.str = (const char *)payload;
+        cmd->wol.mac.len = 6;
+        return WS_STATUS_OK;
+    case WS_BINARY_ACTION_LED:
+        if (payload_len < 4)
+        {
+            return WS_STATUS_INVALID_PAYLOAD;
+        }
+        set_name(&cmd->action, "led");
+        cmd->kind = WS_COMMAND_KIND_LED;
+        set_number(&cmd->led.color.r, payload[0]);
+        set_number(&cmd->led.color.g, payload[1]);
+        set_number(&cmd->led.color.b, payload[2]);
+        set_number(&cmd->led.color.w, payload[3]);
+        set_transition(&cmd->led, payload, payload_len, 4);
+        return WS_STATUS_OK;
+    case WS_BINARY_ACTION_EFFECT:
+        if (payload_len < 4)
+        {
+            return WS_STATUS_INVALID_PAYLOAD;
+        }
+        set_name(&cmd->action, "effect");
+        cmd->kind = WS_COMMAND_KIND_LED;
+        set_number(&cmd->led.effect, payload[0]);
+        set_number(&cmd->led.color.r, payload[1]);
+        set_number(&cmd->led.color.g, payload[2]);
+        set_number(&cmd->led.color.b, payload[3]);
+        set_transition(&cmd->led, payload, payload_len, 4);
+        return WS_STATUS_OK;
+    case WS_BINARY_ACTION_PING:
+        set_name(&cmd->action, "ping");
+        return WS_STATUS_OK;
+    case WS_BINARY_ACTION_STREAM:
+    {
+        if (payload_len < WS_STREAM_HEADER_LEN)
+        {
+            return WS_STATUS_INVALID_PAYLOAD;
+        }
+        // Diferente das outras ações, o payload não tem tamanho fixo: tudo
+        // após o cabeçalho são pixels, e precisa fechar um número inteiro deles.
+        size_t pixel_bytes = payload_len - WS_STREAM_HEADER_LEN;
+        size_t bytes_per_pixel = (payload[0] & WS_STREAM_FLAG_RGBW) ? 4 : 3;
+        if (pixel_bytes % bytes_per_pixel != 0)
+        {
+            return WS_STATUS_INVALID_PAYLOAD;
+        }
+        set_name(&cmd->action, "stream");
+        cmd->kind = WS_COMMAND_KIND_STREAM;
+        set_number(&cmd->stream.flags, payload[0]);
+        cmd->stream.seq.kind = WS_FIELD_NUMBER;
+        cmd->stream.seq.number = (uint16_t)((payload[1] << 8) | payload[2]);
+        cmd->stream.offset.kind = WS_FIELD_NUMBER;
+        cmd->stream.offset.number = (uint16_t)((payload[3] << 8) | payload[4]);
+        cmd->stream.pixels.kind = WS_FIELD_BYTES;
+        cmd->stream.pixels.str = (const char *)(payload + WS_STREAM_HEADER_LEN);
+        cmd->stream.pixels.len = (int)pixel_bytes;
+        return WS_STATUS_OK;
+    }
+    default:
+        return WS_STATUS_UNSUPPORTED;
+    }
+}
+
+static void field_from_cjson(const cJSON *item, ws_field_t *field)
+{
+    if (!item)
+    {
+        field->kind = WS_FIELD_ABSENT;
+    }
+    else if (cJSON_IsNumber(item))
+    {
+        field->kind = WS_FIELD_NUMBER;
+        field->number = item->valuedouble;
+    }
+    else if (cJSON_IsString(item) && item->valuestring)
+    {
+        field->kind = WS_FIELD_STRING;
+        field->str = item->valuestring;
+        field->len = (int)strlen(item->valuestring);
+    }
+    else if (cJSON_IsObject(item))
+    {
+        field->kind = WS_FIELD_OBJECT;
+    }
+    else if (cJSON_IsArray(item))
+    {
+        field->kind = WS_FIELD_ARRAY;
+    }
+    else
+    {
+        field->kind = WS_FIELD_OTHER;
+        if (cJSON_IsBool(item))
+        {
+            // Mesmo formato do tokenizer: o literal em str.
+            field->str = cJSON_IsTrue(item) ? "true" : "false";
+            field->len = (int)strlen(field->str);
+        }
+    }
+}
+
+static void fields_from_cjson(const ws_schema_t *schema, const cJSON *object, char *base)
+{
+    for (int i = 0; i < schema->count; i++)
+    {
+        const ws_member_def_t *def = &schema->members[i];
+        const cJSON *item = cJSON_GetObjectItemCaseSensitive(object, def->name);
+        field_from_cjson(item, (ws_field_t *)(base + def->field));
+        if (def->nested >= 0 && cJSON_IsObject(item))
+        {
+            fields_from_cjson(&rgbw_schema, item, base + def->nested);
+        }
+        if (def->json >= 0 && cJSON_IsArray(item))
+        {
+            *(const cJSON **)(base + def->json) = item;
+        }
+    }
+}
+
+void ws_command_from_cjson(const cJSON *root, ws_command_t *cmd)
+{
+    if (!cmd)
+    {
+        return;
+    }
+
+    memset(cmd, 0, sizeof(*cmd));
+    if (!cJSON_IsObject(root))
+    {
+        return;
+    }
+
+    ensure_schemas();
+    field_from_cjson(cJSON_GetObjectItemCaseSensitive(root, "action"), &cmd->action);
+    field_from_cjson(cJSON_GetObjectItemCaseSensitive(root, "status"), &cmd->status);
+    field_from_cjson(cJSON_GetObjectItemCaseSensitive(root, "error"), &cmd->error);
+    cmd->kind = command_kind(&cmd->action);
+    if (command_payloads[cmd->kind])
+    {
+        fields_from_cjson(command_payloads[cmd->kind], root, command_payload(cmd));
+    }
+}
+
+bool ws_command_iter_init(ws_command_iter_t *iter, const ws_command_t *batch)
+{
+    if (!batch || batch->kind != WS_COMMAND_KIND_BATCH)
+    {
+        return false;
+    }
+    return ws_command_iter_init_array(iter, &batch->batch.commands, batch->batch.commands_json);
+}
+
+bool ws_command_iter_init_array(ws_command_iter_t *iter, const ws_field_t *array, const cJSON *array_json)
+{
+    if (!iter || !array || array->kind != WS_FIELD_ARRAY)
+    {
+        return false;
+    }
+
+    memset(iter, 0, sizeof(*iter));
+    if (array_json)
+    {
+        iter->node = array_json->child;
+        return true;
+    }
+
+    // O tokenizer já validou o array inteiro; aqui só se separa os itens.
+    if (!array->str || array->len < 2)
+    {
+        return false;
+    }
+    iter->p = array->str + 1;
+    iter->end = array->str + array->len - 1;
+    return true;
+}
+
+// Próximo item do array em target, pelo tokenizer (parse) ou pelo cJSON
+// (from_cjson). Itens que o tokenizer não cobre são decodificados com o cJSON
+// e o DOM vai para *item_root.
+static ws_command_iter_result_t iter_next_fields(ws_command_iter_t *iter, ws_fields_parse_fn parse,
+                                                 ws_fields_from_cjson_fn from_cjson, const void *context,
+                                                 void *target, cJSON **item_root)
+{
+    *item_root = NULL;
+    ensure_schemas();
+
+    if (!iter->p)
+    {
+        if (!iter->node)
+        {
+            return WS_COMMAND_ITER_END;
+        }
+        const cJSON *node = iter->node;
+        iter->node = node->next;
+        from_cjson(context, node, target);
+        return cJSON_IsObject(node) ? WS_COMMAND_ITER_ITEM : WS_COMMAND_ITER_INVALID;
+    }
+
+    ws_cursor_t cursor = {iter->p, iter->end};
+    skip_whitespace(&cursor);
+    if (cursor.p >= cursor.end)
+    {
+        iter->p = iter->end;
+        return WS_COMMAND_ITER_END;
+    }
+
+    const char *start = cursor.p;
+    if (!parse_value(&cursor, NULL, 1))
+    {
+        iter->p = iter->end;
+        return WS_COMMAND_ITER_INVALID;
+    }
+    size_t len = (size_t)(cursor.p - start);
+    consume(&cursor, ',');
+    iter->p = cursor.p;
+
+    if (*start != '{')
+    {
+        from_cjson(context, NULL, target);
+        return WS_COMMAND_ITER_INVALID;
+    }
+
+    if (parse(context, start, len, target))
+    {
+        return WS_COMMAND_ITER_ITEM;
+    }
+
+    *item_root = cJSON_ParseWithLength(start, len);
+    if (!*item_root)
+    {
+        return WS_COMMAND_ITER_INVALID;
+    }
+    from_cjson(context, *item_root, target);
+    return WS_COMMAND_ITER_ITEM;
+}
+
+// context: o ws_schema_t de target.
+static bool schema_parse(const void *context, const char *json, size_t len, void *target)
+{
+    const ws_schema_t *schema = (const ws_schema_t *)context;
+    return parse_fields(json, len, schema_member, schema, target, schema->size);
+}
+
+static void schema_from_cjson(const void *context, const cJSON *object, void *target)
+{
+    const ws_schema_t *schema = (const ws_schema_t *)context;
+    memset(target, 0, schema->size);
+    if (cJSON_IsObject(object))
+    {
+        fields_from_cjson(schema, object, (char *)target);
+    }
+}
+
+static bool command_parse(const void *context, const char *json, size_t len, void *target)
+{
+    return ws_command_parse(json, len, (ws_command_t *)target);
+}
+
+static void command_from_cjson(const void *context, const cJSON *object, void *target)
+{
+    ws_command_from_cjson(object, (ws_command_t *)target);
+}
+
+ws_command_iter_result_t ws_command_iter_next(ws_command_iter_t *iter, ws_command_t *item, cJSON **item_root)
+{
+    return iter_next_fields(iter, command_parse, command_from_cjson, NULL, item, item_root);
+}
+
+ws_command_iter_result_t ws_command_iter_next_color(ws_command_iter_t *iter, ws_rgbw_fields_t *color,
+                                                    cJSON **item_root)
+{
+    return iter_next_fields(iter, schema_parse, schema_from_cjson, &rgbw_schema, color, item_root);
+}
+
+ws_command_iter_result_t ws_command_iter_next_keyframe(ws_command_iter_t *iter, ws_led_fields_t *keyframe,
+                                                       cJSON **item_root)
+{
+    return iter_next_fields(iter, schema_parse, schema_from_cjson, &led_schema, keyframe, item_root);
+}
+
+ws_command_iter_result_t ws_command_iter_next_output(ws_command_iter_t *iter, ws_output_fields_t *output,
+                                                     cJSON **item_root)
+{
+    return iter_next_fields(iter, schema_parse, schema_from_cjson, &output_schema, output, item_root);
+}
+
+ws_command_iter_result_t ws_command_iter_next_segment(ws_command_iter_t *iter, ws_segment_fields_t *segment,
+                                                      cJSON **item_root)
+{
+    return iter_next_fields(iter, schema_parse, schema_from_cjson, &segment_schema, segment, item_root);
+}
+
+ws_command_iter_result_t ws_command_iter_next_value(ws_command_iter_t *iter, ws_field_t *value)
+{
+    memset(value, 0, sizeof(*value));
+
+    if (!iter->p)
+    {
+        if (!iter->node)
+        {
+            return WS_COMMAND_ITER_END;
+        }
+        const cJSON *node = iter->node;
+        iter->node = node->next;
+        field_from_cjson(node, value);
+        return WS_COMMAND_ITER_ITEM;
+    }
+
+    ws_cursor_t cursor = {iter->p, iter->end};
+    skip_whitespace(&cursor);
+    if (cursor.p >= cursor.end)
+    {
+        iter->p = iter->end;
+        return WS_COMMAND_ITER_END;
+    }
+
+    if (!parse_value(&cursor, value, 1))
+    {
+        iter->p = iter->end;
+        return WS_COMMAND_ITER_INVALID;
+    }
+    consume(&cursor, ',');
+    iter->p = cursor.p;
+    return WS_COMMAND_ITER_ITEM;
+}
+
+bool ws_field_is_string(const ws_field_t *field)
+{
+    return field && field->kind == WS_FIELD_STRING;
+}
+
+bool ws_field_is_number(const ws_field_t *field)
+{
+    return field && field->kind == WS_FIELD_NUMBER;
+}
+
+bool ws_field_equals(const ws_field_t *field, const char *value)
+{
+    if (!ws_field_is_string(field) || !value)
+    {
+        return false;
+    }
+
+    size_t len = strlen(value);
+    return (size_t)field->len == len && memcmp(field->str, value, len) == 0;
+}
+
+bool ws_field_is_true(const ws_field_t *field)
+{
+    return field && field->kind == WS_FIELD_OTHER && field->str && field->len == 4 &&
+           memcmp(field->str, "true", 4) == 0;
+}
+
+int ws_field_to_int(const ws_field_t *field)
+{
+    if (!ws_field_is_number(field))
+    {
+        return 0;
+    }
+
+    if (field->number >= INT_MAX)
+    {
+        return INT_MAX;
+    }
+    if (field->number <= (double)INT_MIN)
+    {
+        return INT_MIN;
+    }
+    return (int)field->number;
+}
+
+bool ws_field_to_u8(const ws_field_t *field, uint8_t *value)
+{
+    if (!ws_field_is_number(field) || field->number < 0 || field->number > 255)
+    {
+        return false;
+    }
+
+    *value = (uint8_t)ws_field_to_int(field);
+    return true;
+}
@@ -0,0 +1,276 @@
+#ifndef WS_COMMAND_H
+#define WS_COMMAND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cJSON.h"
+
+// Comando recebido do servidor, extraído em passada única e sem alocação.
+// Strings apontam para dentro do payload original (ou do DOM do cJSON no
+// fallback) e só são válidas enquanto ele existir.
+
+// Formato binário compacto (opcode 0x02):
+//   [versão][ação][payload de layout fixo]
+// Bytes além do layout fixo são reservados para extensões e ignorados na v1.
+// O ack repete a versão, devolve ação | WS_BINARY_ACK_FLAG e um ws_status_t.
+#define WS_BINARY_VERSION 1
+#define WS_BINARY_HEADER_LEN 2
+#define WS_BINARY_ACK_FLAG 0x80
+// Byte de segmento de led/effect que vale para a fita inteira.
+#define WS_BINARY_SEGMENT_ALL 0xFF
+
+typedef enum
+{
+    WS_BINARY_ACTION_WOL = 0x01,    // mac[6]
+    WS_BINARY_ACTION_LED = 0x02,    // r, g, b, w [, transição em ms (u16 BE) [, segmento]]
+    WS_BINARY_ACTION_EFFECT = 0x03, // id do efeito, r, g, b (cor base) [, transição (u16 BE) [, segmento]]
+    WS_BINARY_ACTION_PING = 0x04,   // sem payload
+    WS_BINARY_ACTION_STREAM = 0x05, // flags, seq (u16 BE), offset (u16 BE), pixels
+} ws_binary_action_t;
+
+// Flags do stream de pixels. Sem RGBW, cada pixel ocupa 3 bytes (r, g, b).
+#define WS_STREAM_FLAG_RGBW 0x01
+// Último pedaço do frame: o frame montado é publicado para a led_task.
+#define WS_STREAM_FLAG_PUSH 0x02
+#define WS_STREAM_HEADER_LEN 5
+
+typedef enum
+{
+    WS_STATUS_OK = 0,
+    WS_STATUS_INVALID_PAYLOAD,
+    WS_STATUS_NOT_CONFIGURED,
+    WS_STATUS_BUSY,
+    WS_STATUS_FAILED,
+    WS_STATUS_UNSUPPORTED,
+    WS_STATUS_BAD_VERSION,
+    WS_STATUS_UNAUTHORIZED, // comandos assinados: trailer ausente, MAC inválido ou seq repetida
+} ws_status_t;
+
+typedef enum
+{
+    WS_ENCODING_JSON = 0,
+    WS_ENCODING_BINARY,
+} ws_encoding_t;
+
+typedef enum
+{
+    WS_FIELD_ABSENT = 0,
+    WS_FIELD_NUMBER,
+    WS_FIELD_STRING,
+    WS_FIELD_OBJECT,
+    WS_FIELD_ARRAY,
+    WS_FIELD_OTHER, // true/false/null (str aponta para o literal)
+    WS_FIELD_BYTES, // binário: bytes crus (ex.: MAC de 6 bytes)
+} ws_field_kind_t;
+
+typedef struct
+{
+    ws_field_kind_t kind;
+    const char *str; // STRING: conteúdo sem aspas; BYTES: bytes crus
+    int len;
+    double number;
+} ws_field_t;
+
+typedef struct
+{
+    ws_field_t r;
+    ws_field_t g;
+    ws_field_t b;
+    ws_field_t w;
+} ws_rgbw_fields_t;
+
+// Cor ou efeito: campos de led/effect e de cada item de keyframes.
+typedef struct
+{
+    ws_rgbw_fields_t color;
+    ws_field_t effect;
+    ws_field_t speed;         // effect: parâmetros (ver led_effects.h)
+    ws_field_t density;
+    ws_field_t palette;
+    ws_field_t colors;        // effect: ARRAY de cores ({r, g, b})
+    const cJSON *colors_json;
+    ws_field_t start_at;      // effect: instante do início (epoch, ms)
+    ws_field_t transition_ms; // duração da transição
+    ws_field_t segment;       // nome (ou índice) do segmento
+    ws_field_t at_ms;         // item de keyframes: instante desde o início
+} ws_led_fields_t;
+
+// Uma saída da fita (config): no topo ou em cada item de outputs.
+typedef struct
+{
+    ws_field_t led_count;
+    ws_field_t led_pin;
+    ws_field_t led_type;
+    ws_field_t backend; // transporte ("rmt", "spi")
+} ws_output_fields_t;
+
+// Item de segments da config.
+typedef struct
+{
+    ws_field_t name;
+    ws_field_t start;
+    ws_field_t length;
+    ws_field_t reversed;
+} ws_segment_fields_t;
+
+// Campos de wol e wol_group.
+typedef struct
+{
+    ws_field_t mac;
+    ws_field_t macs;       // ARRAY de MACs (strings)
+    const cJSON *macs_json;
+    ws_field_t group;      // nome de um grupo salvo no dispositivo
+    ws_field_t name;       // wol_group: nome do grupo
+    ws_field_t rate;       // pacotes por segundo na rajada para vários alvos
+    ws_field_t burst;      // cópias do pacote mágico
+    ws_field_t spacing_ms; // intervalo entre as cópias
+    ws_field_t port;       // 7, 9 ou "both"
+    ws_field_t directed;   // broadcast da sub-rede
+    ws_field_t password;   // senha SecureOn (formato de MAC)
+    ws_field_t verify;     // sonda depois do envio ("icmp" ou "tcp")
+    ws_field_t ip;         // IPv4 do alvo, para a sonda
+    ws_field_t probe_port; // porta do connect TCP
+    ws_field_t timeout_ms; // prazo da verificação
+} ws_wol_fields_t;
+
+// Campos de config (resposta do get_config).
+typedef struct
+{
+    ws_output_fields_t output;  // saída única descrita no topo
+    ws_field_t brightness;      // brilho mestre 0..255
+    ws_field_t max_milliamps;   // orçamento de corrente (0 = sem limite)
+    ws_field_t signed_commands; // exige comandos assinados (ver ws_command_auth.h)
+    ws_field_t last_led_color;  // OBJECT => membros em last_color
+    ws_rgbw_fields_t last_color;
+    ws_field_t outputs;         // ARRAY de saídas ({ledPin, ledCount, ledType, backend})
+    const cJSON *outputs_json;
+    ws_field_t segments;        // ARRAY de segmentos ({name, start, length, reversed})
+    const cJSON *segments_json;
+} ws_config_fields_t;
+
+// Campos de timeline: carga de keyframes ou controle da reprodução.
+typedef struct
+{
+    ws_field_t keyframes;   // ARRAY de keyframes (ws_led_fields_t por item)
+    const cJSON *keyframes_json;
+    ws_field_t duration_ms; // duração de uma volta
+    ws_field_t loop;
+    ws_field_t control;     // play, pause, stop, seek, status
+    ws_field_t position_ms; // posição do seek
+} ws_timeline_fields_t;
+
+// Só no formato binário.
+typedef struct
+{
+    ws_field_t flags; // WS_STREAM_FLAG_*
+    ws_field_t seq;
+    ws_field_t offset; // índice do primeiro pixel do pedaço
+    ws_field_t pixels; // BYTES com os pixels do pedaço
+} ws_stream_fields_t;
+
+typedef struct
+{
+    ws_field_t commands; // ARRAY com o texto cru de '[' a ']'
+    const cJSON *commands_json;
+} ws_batch_fields_t;
+
+// Qual membro da união de ws_command_t vale, derivado da ação. Ações sem
+// payload (ping, stats) e desconhecidas ficam em NONE: só o cabeçalho.
+typedef enum
+{
+    WS_COMMAND_KIND_NONE = 0,
+    WS_COMMAND_KIND_WOL,      // wol, wol_group
+    WS_COMMAND_KIND_LED,      // led, effect
+    WS_COMMAND_KIND_CONFIG,
+    WS_COMMAND_KIND_TIMELINE,
+    WS_COMMAND_KIND_STREAM,
+    WS_COMMAND_KIND_BATCH,
+    WS_COMMAND_KIND_COUNT,
+} ws_command_kind_t;
+
+// Cabeçalho comum e o payload da ação. Chaves de outras ações são ignoradas
+// como chaves desconhecidas.
+typedef struct
+{
+    ws_encoding_t encoding; // define o formato da resposta
+    uint8_t binary_action;  // ws_binary_action_t quando encoding == BINARY
+    ws_command_kind_t kind;
+    ws_field_t action;
+    ws_field_t status;
+    ws_field_t error;
+    union
+    {
+        ws_wol_fields_t wol;
+        ws_led_fields_t led;
+        ws_config_fields_t config;
+        ws_timeline_fields_t timeline;
+        ws_stream_fields_t stream;
+        ws_batch_fields_t batch;
+    };
+} ws_command_t;
+
+// Percorre os itens de um array de objetos (sub-comandos de um batch,
+// segmentos da config), venha ele do tokenizer ou do cJSON.
+typedef struct
+{
+    const char *p;
+    const char *end;
+    const cJSON *node;
+} ws_command_iter_t;
+
+typedef enum
+{
+    WS_COMMAND_ITER_END = 0,
+    WS_COMMAND_ITER_ITEM,
+    WS_COMMAND_ITER_INVALID, // item que não é um objeto JSON válido
+} ws_command_iter_result_t;
+
+// Caminho rápido: tokenizer de passada única sobre o payload. Retorna false
+// quando o formato não é suportado (strings com escapes nos campos conhecidos,
+// raiz que não é objeto, aninhamento profundo ou JSON inválido); nesse caso o
+// chamador deve usar ws_command_from_cjson.
+bool ws_command_parse(const char *json, size_t len, ws_command_t *cmd);
+
+// Decodifica um frame binário no mesmo ws_command_t do JSON, para que os dois
+// formatos passem pelos mesmos handlers. Em caso de erro devolve o status do ack.
+ws_status_t ws_command_parse_binary(const uint8_t *data, size_t len, ws_command_t *cmd);
+
+// Fallback: preenche o comando a partir de um DOM do cJSON.
+void ws_command_from_cjson(const cJSON *root, ws_command_t *cmd);
+
+// Retorna false se o comando não tem um array "commands".
+bool ws_command_iter_init(ws_command_iter_t *iter, const ws_command_t *batch);
+// Mesmo iterador sobre outro array do comando (ex.: segments/segments_json).
+bool ws_command_iter_init_array(ws_command_iter_t *iter, const ws_field_t *array, const cJSON *array_json);
+// Preenche item com o próximo sub-comando. Se o item precisou do cJSON (ex.:
+// strings com escapes), *item_root recebe o DOM e o chamador deve liberá-lo
+// com cJSON_Delete depois de usar o item.
+ws_command_iter_result_t ws_command_iter_next(ws_command_iter_t *iter, ws_command_t *item, cJSON **item_root);
+// Mesmo iterador, para arrays de cores ({r, g, b[, w]}): só os canais são
+// lidos, sem um ws_command_t inteiro por item.
+ws_command_iter_result_t ws_command_iter_next_color(ws_command_iter_t *iter, ws_rgbw_fields_t *color,
+                                                    cJSON **item_root);
+// Mesmo iterador, para os itens de keyframes da timeline.
+ws_command_iter_result_t ws_command_iter_next_keyframe(ws_command_iter_t *iter, ws_led_fields_t *keyframe,
+                                                       cJSON **item_root);
+// Mesmo iterador, para os itens de outputs e de segments da config.
+ws_command_iter_result_t ws_command_iter_next_output(ws_command_iter_t *iter, ws_output_fields_t *output,
+                                                     cJSON **item_root);
+ws_command_iter_result_t ws_command_iter_next_segment(ws_command_iter_t *iter, ws_segment_fields_t *segment,
+                                                      cJSON **item_root);
+// Mesmo iterador, para arrays de valores simples (ex.: lista de MACs): value
+// recebe o próximo item. Strings com escapes contam como item inválido.
+ws_command_iter_result_t ws_command_iter_next_value(ws_command_iter_t *iter, ws_field_t *value);
+
+bool ws_field_is_string(const ws_field_t *field);
+bool ws_field_is_number(const ws_field_t *field);
+bool ws_field_equals(const ws_field_t *field, const char *value);
+bool ws_field_is_true(const ws_field_t *field);
+// Mesma semântica de valueint do cJSON (truncado e saturado em int).
+int ws_field_to_int(const ws_field_t *field);
+// Número em [0, 255]; false se ausente, não numérico ou fora da faixa.
+bool ws_field_to_u8(const ws_field_t *field, uint8_t *value);
+
+#endif
@@ -0,0 +1,180 @@
+#include <string.h>
+
+#include "esp_log.h"
+
+#include "ws_command_auth.h"
+
+static const char *TAG = "ESP_WOL_AUTH";
+
+#define SIG_PREFIX "{\"sig\":\""
+#define SEQ_PREFIX "\",\"seq\":"
+#define SIG_PREFIX_LEN (sizeof(SIG_PREFIX) - 1)
+#define SEQ_PREFIX_LEN (sizeof(SEQ_PREFIX) - 1)
+
+// Token seguido do nonce: o prefixo de todo MAC da conexão.
+static char auth_context[WS_AUTH_TOKEN_MAX + WS_AUTH_NONCE_HEX_LEN];
+static size_t auth_context_len = 0;
+static bool auth_required = false;
+static bool auth_enabled = false;
+static uint32_t auth_last_seq = 0;
+static ws_command_auth_stats_t auth_stats;
+
+void ws_command_auth_reset(const char *token, const char *nonce, bool required)
+{
+    size_t token_len = strnlen(token, WS_AUTH_TOKEN_MAX - 1);
+    size_t nonce_len = strnlen(nonce, WS_AUTH_NONCE_HEX_LEN);
+    memcpy(auth_context, token, token_len);
+    memcpy(auth_context + token_len, nonce, nonce_len);
+    auth_context_len = token_len + nonce_len;
+    auth_required = required;
+    auth_enabled = required;
+    auth_last_seq = 0;
+}
+
+void ws_command_auth_set_enabled(bool enabled)
+{
+    if (!enabled && auth_required)
+    {
+        ESP_LOGW(TAG, "Signed commands are required by the firmware; ignoring disable");
+        return;
+    }
+    if (enabled != auth_enabled)
+    {
+        ESP_LOGI(TAG, "Signed commands %s", enabled ? "enabled" : "disabled");
+    }
+    auth_enabled = enabled;
+}
+
+bool ws_command_auth_enabled(void)
+{
+    return auth_enabled;
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+static bool decode_sig(const char *hex, uint8_t *tag)
+{
+    for (int i = 0; i < NET_HMAC_TAG_LEN; i++)
+    {
+        int high = hex_value(hex[i * 2]);
+        int low = hex_value(hex[i * 2 + 1]);
+        if (high < 0 || low < 0)
+        {
+            return false;
+        }
+        tag[i] = (uint8_t)(high << 4 | low);
+    }
+    return true;
+}
+
+// Depois do MAC: só a sequência decide se a mensagem é nova.
+static ws_auth_result_t accept_seq(uint32_t seq)
+{
+    if (seq <= auth_last_seq)
+    {
+        auth_stats.replays++;
+        return WS_AUTH_REPLAY;
+    }
+    auth_last_seq = seq;
+    auth_stats.verified++;
+    return WS_AUTH_OK;
+}
+
+static ws_auth_result_t reject(void)
+{
+    auth_stats.rejected++;
+    return WS_AUTH_MISSING;
+}
+
+static bool verify_tag(const void *data, size_t len, const uint8_t *tag)
+{
+    net_hmac_verify_t verify;
+    if (!net_hmac_verify_begin(&verify))
+    {
+        return false;
+    }
+    net_hmac_verify_update(&verify, auth_context, auth_context_len);
+    net_hmac_verify_update(&verify, data, len);
+    return net_hmac_verify_end(&verify, tag);
+}
+
+ws_auth_result_t ws_command_auth_check_text(const char *payload, size_t len)
+{
+    const size_t sig_end = SIG_PREFIX_LEN + WS_AUTH_SIG_HEX_LEN;
+    if (len <= sig_end + SEQ_PREFIX_LEN || memcmp(payload, SIG_PREFIX, SIG_PREFIX_LEN) != 0 ||
+        memcmp(payload + sig_end, SEQ_PREFIX, SEQ_PREFIX_LEN) != 0)
+    {
+        return reject();
+    }
+
+    uint8_t tag[NET_HMAC_TAG_LEN];
+    if (!decode_sig(payload + SIG_PREFIX_LEN, tag))
+    {
+        return reject();
+    }
+
+    // Sequência decimal sem sinal nem zeros à esquerda, seguida de ','.
+    const char *p = payload + sig_end + SEQ_PREFIX_LEN;
+    const char *end = payload + len;
+    uint64_t seq = 0;
+    const char *digits = p;
+    while (p < end && *p >= '0' && *p <= '9' && p - digits < 10)
+    {
+        seq = seq * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+    if (p == digits || p >= end || *p != ',' || seq > UINT32_MAX || (*digits == '0' && p - digits > 1))
+    {
+        return reject();
+    }
+
+    if (!verify_tag(payload + sig_end, len - sig_end, tag))
+    {
+        auth_stats.rejected++;
+        return WS_AUTH_BAD_MAC;
+    }
+    return accept_seq((uint32_t)seq);
+}
+
+ws_auth_result_t ws_command_auth_check_binary(const uint8_t *payload, size_t len, size_t *frame_len)
+{
+    if (len <= WS_AUTH_BINARY_TRAILER_LEN)
+    {
+        return reject();
+    }
+
+    size_t signed_len = len - NET_HMAC_TAG_LEN;
+    if (!verify_tag(payload, signed_len, payload + signed_len))
+    {
+        auth_stats.rejected++;
+        return WS_AUTH_BAD_MAC;
+    }
+
+    const uint8_t *seq = payload + signed_len - 4;
+    ws_auth_result_t result =
+        accept_seq((uint32_t)seq[0] << 24 | (uint32_t)seq[1] << 16 | (uint32_t)seq[2] << 8 | seq[3]);
+    if (result == WS_AUTH_OK)
+    {
+        *frame_len = len - WS_AUTH_BINARY_TRAILER_LEN;
+    }
+    return result;
+}
+
+void ws_command_auth_get_stats(ws_command_auth_stats_t *stats)
+{
+    *stats = auth_stats;
+    stats->enabled = auth_enabled;
+    stats->last_seq = auth_last_seq;
+}
@@ -0,0 +1,56 @@
+#ifndef WS_COMMAND_AUTH_H
+#define WS_COMMAND_AUTH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "net_hmac.h"
+
+// Comandos assinados: com o modo ligado, toda mensagem recebida carrega um
+// HMAC-SHA256-128 (chave SECRET) e uma sequência que só cresce na conexão.
+// O MAC cobre o token do handshake e o nonce da conexão (campo "nonce" do
+// handshake) seguidos da mensagem, então uma mensagem capturada não vale em
+// outra conexão nem pode ser repetida nesta.
+//
+// JSON: a mensagem começa exatamente com {"sig":"<32 hexa>","seq":<u32>, e o
+// MAC cobre o token seguido do texto a partir do '"' que fecha o sig.
+// Binário: [frame][seq u32 BE][tag 16]; o MAC cobre o token, o frame e a seq.
+//
+// O modo começa no padrão de compilação a cada conexão e o servidor pode
+// ligá-lo com "signedCommands":true na config. Desligar exige uma config
+// assinada, e não é possível quando ele é obrigatório na compilação.
+// Usado só pela task do WS.
+
+#define WS_AUTH_TOKEN_MAX 64
+#define WS_AUTH_NONCE_HEX_LEN 16
+#define WS_AUTH_SIG_HEX_LEN (NET_HMAC_TAG_LEN * 2)
+#define WS_AUTH_BINARY_TRAILER_LEN (4 + NET_HMAC_TAG_LEN)
+
+typedef enum
+{
+    WS_AUTH_OK = 0,
+    WS_AUTH_MISSING,   // sem o prefixo/trailer de assinatura
+    WS_AUTH_BAD_MAC,
+    WS_AUTH_REPLAY,    // MAC válido, seq não maior que a última aceita
+} ws_auth_result_t;
+
+typedef struct
+{
+    bool enabled;
+    uint32_t verified;
+    uint32_t rejected; // sem assinatura ou MAC inválido
+    uint32_t replays;
+    uint32_t last_seq;
+} ws_command_auth_stats_t;
+
+// Nova conexão: guarda o token e o nonce do handshake e zera a sequência.
+void ws_command_auth_reset(const char *token, const char *nonce, bool required);
+void ws_command_auth_set_enabled(bool enabled);
+bool ws_command_auth_enabled(void);
+ws_auth_result_t ws_command_auth_check_text(const char *payload, size_t len);
+// Em WS_AUTH_OK, *frame_len recebe o tamanho do frame sem o trailer.
+ws_auth_result_t ws_command_auth_check_binary(const uint8_t *payload, size_t len, size_t *frame_len);
+void ws_command_auth_get_stats(ws_command_auth_stats_t *stats);
+
+#endif
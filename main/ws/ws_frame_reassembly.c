@@ -1,16 +1,16 @@
-#include <stdlib.h>
 #include <string.h>
 
 #include "ws_frame_reassembly.h"
 
-void ws_frame_reassembly_init(ws_frame_reassembly_t *state)
+void ws_frame_reassembly_init(ws_frame_reassembly_t *state, char *arena, int capacity)
 {
     if (!state)
     {
         return;
     }
 
-    state->buffer = NULL;
+    state->buffer = arena;
+    state->capacity = (arena && capacity > 0) ? capacity : 0;
     state->expected_len = 0;
     state->received_len = 0;
 }
@@ -22,12 +22,6 @@ void ws_frame_reassembly_reset(ws_frame_reassembly_t *state)
         return;
     }
 
-    if (state->buffer)
-    {
-        free(state->buffer);
-        state->buffer = NULL;
-    }
-
     state->expected_len = 0;
     state->received_len = 0;
 }
@@ -41,8 +35,7 @@ bool ws_frame_reassembly_begin(ws_frame_reassembly_t *state, int payload_len)
 
     ws_frame_reassembly_reset(state);
 
-    state->buffer = (char *)malloc(payload_len + 1);
-    if (!state->buffer)
+    if (!state->buffer || payload_len > state->capacity)
     {
         return false;
     }
@@ -54,7 +47,7 @@ bool ws_frame_reassembly_begin(ws_frame_reassembly_t *state, int payload_len)
 
 bool ws_frame_reassembly_append(ws_frame_reassembly_t *state, int payload_offset, const char *data_ptr, int data_len, int payload_len)
 {
-    if (!state || !state->buffer || !data_ptr)
+    if (!state || !state->buffer || !data_ptr || state->expected_len <= 0)
     {
         return false;
     }
@@ -64,7 +57,13 @@ bool ws_frame_reassembly_append(ws_frame_reassembly_t *state, int payload_offset
         return false;
     }
 
-    if (payload_offset < 0 || data_len <= 0 || payload_offset + data_len > state->expected_len)
+    if (payload_offset < 0 || data_len <= 0 || payload_offset > state->expected_len - data_len)
+    {
+        return false;
+    }
+
+    // Fragmento começando depois do prefixo contíguo => bytes perdidos no meio.
+    if (payload_offset > state->received_len)
     {
         return false;
     }
@@ -77,11 +76,6 @@ bool ws_frame_reassembly_append(ws_frame_reassembly_t *state, int payload_offset
         state->received_len = fragment_end;
     }
 
-    if (state->received_len >= state->expected_len)
-    {
-        state->buffer[state->expected_len] = 0;
-    }
-
     return true;
 }
 
@@ -92,7 +86,7 @@ bool ws_frame_reassembly_is_complete(const ws_frame_reassembly_t *state)
         return false;
     }
 
-    return state->buffer && state->received_len >= state->expected_len;
+    return state->expected_len > 0 && state->received_len == state->expected_len;
 }
 
 const char *ws_frame_reassembly_data(const ws_frame_reassembly_t *state)
@@ -104,3 +98,13 @@ const char *ws_frame_reassembly_data(const ws_frame_reassembly_t *state)
 
     return state->buffer;
 }
+
+int ws_frame_reassembly_length(const ws_frame_reassembly_t *state)
+{
+    if (!state)
+    {
+        return 0;
+    }
+
+    return state->expected_len;
+}
@@ -3,18 +3,23 @@
 
 #include <stdbool.h>
 
+// Reassembly de mensagens fragmentadas numa arena fixa, alocada no boot pelo
+// chamador. Nada é alocado por mensagem. Só o prefixo contíguo conta como
+// recebido: um fragmento que deixaria um buraco é rejeitado.
 typedef struct
 {
     char *buffer;
+    int capacity;
     int expected_len;
     int received_len;
 } ws_frame_reassembly_t;
 
-void ws_frame_reassembly_init(ws_frame_reassembly_t *state);
+void ws_frame_reassembly_init(ws_frame_reassembly_t *state, char *arena, int capacity);
 void ws_frame_reassembly_reset(ws_frame_reassembly_t *state);
 bool ws_frame_reassembly_begin(ws_frame_reassembly_t *state, int payload_len);
 bool ws_frame_reassembly_append(ws_frame_reassembly_t *state, int payload_offset, const char *data_ptr, int data_len, int payload_len);
 bool ws_frame_reassembly_is_complete(const ws_frame_reassembly_t *state);
 const char *ws_frame_reassembly_data(const ws_frame_reassembly_t *state);
+int ws_frame_reassembly_length(const ws_frame_reassembly_t *state);
 
 #endif
@@ -0,0 +1,80 @@
+#include <string.h>
+
+#include "ws_name_index.h"
+
+#define WS_NAME_INDEX_MASK (WS_NAME_INDEX_SLOTS - 1)
+
+uint32_t ws_name_hash(const char *name, int len)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < len; i++)
+    {
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void ws_name_index_init(ws_name_index_t *index)
+{
+    if (!index)
+    {
+        return;
+    }
+
+    memset(index, 0, sizeof(*index));
+}
+
+bool ws_name_index_add(ws_name_index_t *index, const char *name, int value)
+{
+    if (!index || !name || index->count >= WS_NAME_INDEX_SLOTS / 2)
+    {
+        return false;
+    }
+
+    int len = (int)strlen(name);
+    uint32_t hash = ws_name_hash(name, len);
+    for (uint32_t probe = 0; probe < WS_NAME_INDEX_SLOTS; probe++)
+    {
+        ws_name_slot_t *slot = &index->slots[(hash + probe) & WS_NAME_INDEX_MASK];
+        if (!slot->name)
+        {
+            slot->name = name;
+            slot->hash = hash;
+            slot->len = (uint16_t)len;
+            slot->value = (int16_t)value;
+            index->count++;
+            return true;
+        }
+
+        if (slot->hash == hash && slot->len == len && memcmp(slot->name, name, len) == 0)
+        {
+            return false; // nome duplicado
+        }
+    }
+    return false;
+}
+
+int ws_name_index_find(const ws_name_index_t *index, const char *name, int len)
+{
+    if (!index || !name || len < 0)
+    {
+        return -1;
+    }
+
+    uint32_t hash = ws_name_hash(name, len);
+    for (uint32_t probe = 0; probe < WS_NAME_INDEX_SLOTS; probe++)
+    {
+        const ws_name_slot_t *slot = &index->slots[(hash + probe) & WS_NAME_INDEX_MASK];
+        if (!slot->name)
+        {
+            return -1;
+        }
+
+        if (slot->hash == hash && slot->len == len && memcmp(slot->name, name, len) == 0)
+        {
+            return slot->value;
+        }
+    }
+    return -1;
+}
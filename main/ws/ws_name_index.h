@@ -0,0 +1,32 @@
+#ifndef WS_NAME_INDEX_H
+#define WS_NAME_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Índice hash (FNV-1a, endereçamento aberto) para resolver nomes curtos do
+// protocolo (ações, efeitos, tipos de fita) em O(1), sem strcmp em cadeia.
+
+#define WS_NAME_INDEX_SLOTS 32 // potência de 2; manter ocupação abaixo de 50%
+
+typedef struct
+{
+    const char *name; // NULL = slot vazio
+    uint32_t hash;
+    uint16_t len;
+    int16_t value;
+} ws_name_slot_t;
+
+typedef struct
+{
+    ws_name_slot_t slots[WS_NAME_INDEX_SLOTS];
+    int count;
+} ws_name_index_t;
+
+uint32_t ws_name_hash(const char *name, int len);
+void ws_name_index_init(ws_name_index_t *index);
+bool ws_name_index_add(ws_name_index_t *index, const char *name, int value);
+// Retorna o value registrado para o nome, ou -1 se não existir.
+int ws_name_index_find(const ws_name_index_t *index, const char *name, int len);
+
+#endif
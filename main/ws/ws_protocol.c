@@ -6,38 +6,108 @@
 
 #include "ws_protocol.h"
 #include "ws_protocol_internal.h"
+#include "ws_tx_queue.h"
 
 static volatile bool ws_force_reconnect = false;
 
-bool ws_protocol_cjson_to_u8(const cJSON *item, uint8_t *value)
+// Captura de respostas JSON (batch): em vez de enfileirar, cada resposta é
+// anexada ao buffer, separada por vírgula, para virar o array "results".
+static char *ws_capture_buffer = NULL;
+static int ws_capture_capacity = 0;
+static int ws_capture_len = 0;
+static bool ws_capture_truncated = false;
+
+void ws_protocol_capture_begin(char *buffer, int capacity)
 {
-    if (!cJSON_IsNumber(item))
+    ws_capture_buffer = buffer;
+    ws_capture_capacity = capacity;
+    ws_capture_len = 0;
+    ws_capture_truncated = false;
+    if (buffer && capacity > 0)
     {
-        return false;
+        buffer[0] = 0;
     }
+}
 
-    if (item->valuedouble < 0 || item->valuedouble > 255)
+int ws_protocol_capture_end(bool *truncated)
+{
+    int len = ws_capture_len;
+    if (truncated)
     {
-        return false;
+        *truncated = ws_capture_truncated;
     }
+    ws_capture_buffer = NULL;
+    ws_capture_capacity = 0;
+    ws_capture_len = 0;
+    return len;
+}
 
-    int value_int = item->valueint;
-    if (value_int < 0 || value_int > 255)
+static void capture_append(const char *payload)
+{
+    int len = (int)strlen(payload);
+    int separator = (ws_capture_len > 0) ? 1 : 0;
+    if (ws_capture_truncated || ws_capture_len + separator + len >= ws_capture_capacity)
     {
-        return false;
+        ws_capture_truncated = true;
+        return;
     }
 
-    *value = (uint8_t)value_int;
-    return true;
+    if (separator)
+    {
+        ws_capture_buffer[ws_capture_len++] = ',';
+    }
+    memcpy(ws_capture_buffer + ws_capture_len, payload, len);
+    ws_capture_len += len;
+    ws_capture_buffer[ws_capture_len] = 0;
 }
 
-void ws_protocol_send_json(esp_websocket_client_handle_t client, const char *payload)
+// Os envios só enfileiram; quem escreve no socket é a task de ws_tx_queue.c.
+void ws_protocol_send_json_priority(esp_websocket_client_handle_t client, const char *payload, ws_tx_priority_t priority)
 {
     if (!client || !payload)
     {
         return;
     }
-    esp_websocket_client_send_text(client, payload, strlen(payload), portMAX_DELAY);
+
+    if (ws_capture_buffer)
+    {
+        capture_append(payload);
+        return;
+    }
+    ws_tx_queue_enqueue(WS_TX_OPCODE_TEXT, payload, strlen(payload), priority);
+}
+
+void ws_protocol_send_json(esp_websocket_client_handle_t client, const char *payload)
+{
+    ws_protocol_send_json_priority(client, payload, WS_TX_PRIORITY_NORMAL);
+}
+
+void ws_protocol_send_binary(esp_websocket_client_handle_t client, const uint8_t *data, int len, ws_tx_priority_t priority)
+{
+    if (!client || !data || len <= 0)
+    {
+        return;
+    }
+    ws_tx_queue_enqueue(WS_TX_OPCODE_BINARY, data, len, priority);
+}
+
+void ws_protocol_send_binary_ack(esp_websocket_client_handle_t client, uint8_t action, ws_status_t status,
+                                 const uint8_t *payload, int payload_len, ws_tx_priority_t priority)
+{
+    uint8_t ack[WS_BINARY_HEADER_LEN + 1 + 8];
+    if (payload_len < 0 || payload_len > (int)sizeof(ack) - (WS_BINARY_HEADER_LEN + 1))
+    {
+        payload_len = 0;
+    }
+
+    ack[0] = WS_BINARY_VERSION;
+    ack[1] = action | WS_BINARY_ACK_FLAG;
+    ack[2] = (uint8_t)status;
+    if (payload && payload_len > 0)
+    {
+        memcpy(&ack[3], payload, payload_len);
+    }
+    ws_protocol_send_binary(client, ack, WS_BINARY_HEADER_LEN + 1 + payload_len, priority);
 }
 
 void ws_protocol_send_error(esp_websocket_client_handle_t client, const char *action, const char *message)
@@ -2,12 +2,25 @@
 #define WS_PROTOCOL_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "esp_websocket_client.h"
 
+typedef struct
+{
+    const char *name;
+    uint32_t count;
+    uint32_t failures;
+} ws_action_stats_t;
+
 void ws_protocol_on_connected(esp_websocket_client_handle_t client, const char *device_mac);
-void ws_protocol_handle_complete_text(esp_websocket_client_handle_t client, const char *json_buffer);
+// payload não precisa terminar em NUL (pode ser o próprio buffer do evento).
+void ws_protocol_handle_complete_text(esp_websocket_client_handle_t client, const char *payload, int payload_len);
+// Frame binário compacto (opcode 0x02); ver ws_command.h para o layout.
+void ws_protocol_handle_complete_binary(esp_websocket_client_handle_t client, const uint8_t *payload, int payload_len);
 bool ws_protocol_should_force_reconnect(void);
 void ws_protocol_clear_force_reconnect(void);
+// Contadores por ação registrada; retorna quantas entradas foram preenchidas.
+int ws_protocol_get_action_stats(ws_action_stats_t *stats, int max_stats);
 
 #endif
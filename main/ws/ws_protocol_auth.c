@@ -2,29 +2,47 @@
 #include <time.h>
 
 #include "esp_log.h"
+#include "esp_random.h"
 
+#include "config.h"
 #include "net_utils.h"
+#include "ws_command_auth.h"
 #include "ws_protocol.h"
 #include "ws_protocol_internal.h"
 
 static const char *TAG = "ESP_WOL_WSP";
 
+// 1 exige comandos assinados desde o handshake, sem depender da config do
+// servidor (ver ws_command_auth.h).
+#ifndef WS_REQUIRE_SIGNED_COMMANDS
+#define WS_REQUIRE_SIGNED_COMMANDS 0
+#endif
+
 void ws_protocol_on_connected(esp_websocket_client_handle_t client, const char *device_mac)
 {
-    char token[64];
+    char token[WS_AUTH_TOKEN_MAX];
     snprintf(token, sizeof(token), "esp32-%lld", (long long)time(NULL));
 
+    // O timestamp sozinho repete (resolução de 1 s, e antes do SNTP recomeça no
+    // mesmo valor a cada boot); o nonce aleatório vai num campo à parte (o
+    // token mantém o formato que os servidores validam) e entra só no MAC dos
+    // comandos assinados, que assim não valem em outra conexão.
+    char nonce[WS_AUTH_NONCE_HEX_LEN + 1];
+    snprintf(nonce, sizeof(nonce), "%08lx%08lx", (unsigned long)esp_random(), (unsigned long)esp_random());
+
     char hmac[65];
     make_hmac(token, hmac);
+    ws_command_auth_reset(token, nonce, WS_REQUIRE_SIGNED_COMMANDS);
 
     const char *mac = device_mac ? device_mac : "00:00:00:00:00:00";
 
     char auth[320];
-    snprintf(auth, sizeof(auth), "{\"token\":\"%s\",\"hmac\":\"%s\",\"mac\":\"%s\"}", token, hmac, mac);
+    snprintf(auth, sizeof(auth), "{\"token\":\"%s\",\"hmac\":\"%s\",\"mac\":\"%s\",\"nonce\":\"%s\"}", token, hmac,
+             mac, nonce);
 
-    ws_protocol_send_json(client, auth);
+    ws_protocol_send_json_priority(client, auth, WS_TX_PRIORITY_CONTROL);
     ESP_LOGI(TAG, "Auth sent (mac=%s token=%s)", mac, token);
 
-    ws_protocol_send_json(client, "{\"action\":\"get_config\"}");
+    ws_protocol_send_json_priority(client, "{\"action\":\"get_config\"}", WS_TX_PRIORITY_CONTROL);
     ESP_LOGI(TAG, "Requested server config with get_config");
 }
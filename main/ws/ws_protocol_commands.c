@@ -2,283 +2,1306 @@
 #include <string.h>
 
 #include "esp_log.h"
+#include "lwip/inet.h"
+#include "lwip/sockets.h"
 
+#include "net_time.h"
 #include "net_utils.h"
+#include "wol_groups.h"
+#include "wol_sender.h"
+#include "wol_verify.h"
 #include "led_controller.h"
+#include "led_effects.h"
+#include "ws_command.h"
+#include "ws_command_auth.h"
+#include "ws_name_index.h"
 #include "ws_protocol.h"
 #include "ws_protocol_internal.h"
 
 static const char *TAG = "ESP_WOL_WSP";
 
-static bool parse_led_type(const cJSON *led_type_json, led_strip_type_t *led_type)
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+// Limites da ação batch: sub-comandos por mensagem e espaço para os acks.
+#define WS_BATCH_MAX_COMMANDS 16
+#define WS_BATCH_RESULTS_SIZE 1536
+
+typedef bool (*ws_action_handler_t)(const ws_command_t *cmd, esp_websocket_client_handle_t client);
+
+// REALTIME: tráfego de alta frequência (cores arrastadas na UI, keepalive);
+// não é logado em INFO para a UART não virar o gargalo do caminho quente, e o
+// ack de sucesso é descartado (em vez de esperar) se a fila de saída estiver cheia.
+typedef struct
+{
+    const char *name;
+    ws_action_handler_t handler;
+    ws_tx_priority_t priority;
+} ws_action_t;
+
+typedef struct
+{
+    const char *name;
+    int value;
+} ws_named_value_t;
+
+static const ws_named_value_t led_type_names[] = {
+    {"ws2812b", LED_STRIP_TYPE_WS2812B},
+    {"sk6812", LED_STRIP_TYPE_SK6812},
+};
+
+static ws_name_index_t led_type_index;
+// Nomes do registro de efeitos (led_effects.h) -> id.
+static ws_name_index_t effect_index;
+// Prioridade dos acks de sucesso da ação em execução (definida no dispatch).
+static ws_tx_priority_t ws_reply_priority = WS_TX_PRIORITY_NORMAL;
+
+static bool parse_led_type(const ws_field_t *led_type_field, led_strip_type_t *led_type)
 {
     if (!led_type)
     {
         return false;
     }
 
-    if (!cJSON_IsString(led_type_json) || !led_type_json->valuestring)
+    if (!ws_field_is_string(led_type_field))
     {
         *led_type = LED_STRIP_TYPE_WS2812B;
         return true;
     }
 
-    if (strcmp(led_type_json->valuestring, "ws2812b") == 0)
+    int value = ws_name_index_find(&led_type_index, led_type_field->str, led_type_field->len);
+    if (value < 0)
     {
-        *led_type = LED_STRIP_TYPE_WS2812B;
+        return false;
+    }
+
+    *led_type = (led_strip_type_t)value;
+    return true;
+}
+
+// Campos numéricos presentes sobrescrevem o canal; os demais ficam como estão.
+static void color_from_fields(const ws_rgbw_fields_t *fields, led_color_t *color)
+{
+    if (ws_field_is_number(&fields->r))
+        color->red = (uint8_t)ws_field_to_int(&fields->r);
+    if (ws_field_is_number(&fields->g))
+        color->green = (uint8_t)ws_field_to_int(&fields->g);
+    if (ws_field_is_number(&fields->b))
+        color->blue = (uint8_t)ws_field_to_int(&fields->b);
+    if (ws_field_is_number(&fields->w))
+        color->white = (uint8_t)ws_field_to_int(&fields->w);
+}
+
+// Erros saem no formato do comando: JSON com mensagem ou ack binário com status.
+static void reply_error(const ws_command_t *cmd, esp_websocket_client_handle_t client,
+                        const char *action, ws_status_t status, const char *message)
+{
+    if (cmd->encoding == WS_ENCODING_BINARY)
+    {
+        ws_protocol_send_binary_ack(client, cmd->binary_action, status, NULL, 0, WS_TX_PRIORITY_NORMAL);
+        return;
+    }
+
+    ws_protocol_send_error(client, action, message);
+}
+
+static void reply_json(esp_websocket_client_handle_t client, const char *payload)
+{
+    ws_protocol_send_json_priority(client, payload, ws_reply_priority);
+}
+
+static void reply_ack(const ws_command_t *cmd, esp_websocket_client_handle_t client, const uint8_t *echo, int echo_len)
+{
+    ws_protocol_send_binary_ack(client, cmd->binary_action, WS_STATUS_OK, echo, echo_len, ws_reply_priority);
+}
+
+static bool field_to_mac(const ws_field_t *field, uint8_t *mac)
+{
+    return ws_field_is_string(field) && parse_mac(field->str, (size_t)field->len, mac);
+}
+
+// Acrescenta o MAC entre aspas em out[len] (com '\0'); sem espaço, não mexe.
+static int append_mac(char *out, size_t size, int len, const uint8_t *mac)
+{
+    if ((size_t)len + MAC_STRING_LEN + 3 > size)
+    {
+        return len;
+    }
+    out[len++] = '"';
+    format_mac_string(mac, out + len);
+    len += MAC_STRING_LEN;
+    out[len++] = '"';
+    out[len] = 0;
+    return len;
+}
+
+static bool command_target_mac(const ws_command_t *cmd, uint8_t *target_mac)
+{
+    if (cmd->wol.mac.kind == WS_FIELD_BYTES)
+    {
+        if (cmd->wol.mac.len != 6)
+        {
+            return false;
+        }
+        memcpy(target_mac, cmd->wol.mac.str, 6);
+        return true;
+    }
+    return field_to_mac(&cmd->wol.mac, target_mac);
+}
+
+// Lê um array "macs" em macs[*count...]. Retorna false com item inválido ou
+// mais de WOL_MAX_TARGETS alvos (*count passa do limite nesse caso).
+static bool command_mac_list(const ws_command_t *cmd, uint8_t (*macs)[WOL_MAC_LEN], int *count)
+{
+    ws_command_iter_t iter;
+    if (!ws_command_iter_init_array(&iter, &cmd->wol.macs, cmd->wol.macs_json))
+    {
+        return false;
+    }
+
+    ws_field_t value;
+    ws_command_iter_result_t result;
+    while ((result = ws_command_iter_next_value(&iter, &value)) != WS_COMMAND_ITER_END)
+    {
+        if (*count >= WOL_MAX_TARGETS)
+        {
+            (*count)++;
+            return false;
+        }
+        if (result != WS_COMMAND_ITER_ITEM || !field_to_mac(&value, macs[*count]))
+        {
+            return false;
+        }
+        (*count)++;
+    }
+    return true;
+}
+
+// Opções do envio (só no JSON): burst, spacingMs, port (7, 9 ou "both"),
+// directed, password (SecureOn, no formato de MAC) e rate (vários alvos).
+// Ausentes = padrões.
+static bool command_wol_options(const ws_command_t *cmd, wol_options_t *options)
+{
+    wol_options_init(options);
+
+    if (cmd->wol.burst.kind != WS_FIELD_ABSENT)
+    {
+        if (!ws_field_is_number(&cmd->wol.burst) || cmd->wol.burst.number < 1 || cmd->wol.burst.number > WOL_MAX_BURST)
+        {
+            return false;
+        }
+        options->burst = (uint8_t)cmd->wol.burst.number;
+    }
+    if (cmd->wol.spacing_ms.kind != WS_FIELD_ABSENT)
+    {
+        if (!ws_field_is_number(&cmd->wol.spacing_ms) || cmd->wol.spacing_ms.number < 0 ||
+            cmd->wol.spacing_ms.number > WOL_MAX_SPACING_MS)
+        {
+            return false;
+        }
+        options->spacing_ms = (uint16_t)cmd->wol.spacing_ms.number;
+    }
+    if (cmd->wol.port.kind != WS_FIELD_ABSENT)
+    {
+        if (ws_field_equals(&cmd->wol.port, "both"))
+        {
+            options->ports = WOL_SEND_PORT_9 | WOL_SEND_PORT_7;
+        }
+        else if (ws_field_is_number(&cmd->wol.port) && (cmd->wol.port.number == 9 || cmd->wol.port.number == 7))
+        {
+            options->ports = (cmd->wol.port.number == 9) ? WOL_SEND_PORT_9 : WOL_SEND_PORT_7;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if (cmd->wol.rate.kind != WS_FIELD_ABSENT)
+    {
+        if (!ws_field_is_number(&cmd->wol.rate) || cmd->wol.rate.number < 1 || cmd->wol.rate.number > WOL_MAX_RATE_PPS)
+        {
+            return false;
+        }
+        options->rate_pps = (uint16_t)cmd->wol.rate.number;
+    }
+    options->directed = ws_field_is_true(&cmd->wol.directed);
+    if (cmd->wol.password.kind != WS_FIELD_ABSENT)
+    {
+        if (!field_to_mac(&cmd->wol.password, options->password))
+        {
+            return false;
+        }
+        options->secureon = true;
+    }
+    return true;
+}
+
+// Resultado da verificação, na task de verificação: vai direto para a fila de
+// saída (segura entre tasks), sem passar pela captura do batch, que é da task do WS.
+static void wol_verify_done(const wol_verify_result_t *result)
+{
+    char mac[MAC_STRING_LEN + 1];
+    format_mac_string(result->request.mac, mac);
+    char ip[16];
+    struct in_addr addr = {.s_addr = result->request.address};
+    inet_ntop(AF_INET, &addr, ip, sizeof(ip));
+
+    char response[224];
+    int len = snprintf(response, sizeof(response),
+                       "{\"status\":\"%s\",\"action\":\"wol_verify\",\"targetMac\":\"%s\","
+                       "\"ip\":\"%s\",\"alive\":%s,",
+                       result->status == WOL_PROBE_ALIVE      ? "ok"
+                       : result->status == WOL_PROBE_NO_REPLY ? "timeout"
+                                                              : "error",
+                       mac, ip,
+                       result->status == WOL_PROBE_ALIVE ? "true" : "false");
+    if (result->status == WOL_PROBE_ALIVE)
+    {
+        len += snprintf(response + len, sizeof(response) - len, "\"aliveAfterMs\":%u,", (unsigned)result->elapsed_ms);
+    }
+    else if (result->status == WOL_PROBE_NO_REPLY)
+    {
+        len += snprintf(response + len, sizeof(response) - len, "\"timeoutMs\":%u,",
+                        (unsigned)result->request.timeout_ms);
+    }
+    else
+    {
+        len += snprintf(response + len, sizeof(response) - len, "\"message\":\"Probe failed\",");
+    }
+    len += snprintf(response + len, sizeof(response) - len, "\"probes\":%u}", (unsigned)result->probes);
+    ws_tx_queue_enqueue(WS_TX_OPCODE_TEXT, response, len, WS_TX_PRIORITY_NORMAL);
+}
+
+// verify ("icmp" ou "tcp") + ip [+ probePort, obrigatória no tcp] [+ timeoutMs].
+// Sem verify, *enabled = false.
+static bool command_wol_verify(const ws_command_t *cmd, const uint8_t *mac, wol_verify_request_t *request,
+                               bool *enabled)
+{
+    *enabled = false;
+    if (cmd->wol.verify.kind == WS_FIELD_ABSENT)
+    {
+        return true;
+    }
+
+    memset(request, 0, sizeof(*request));
+    if (ws_field_equals(&cmd->wol.verify, "icmp"))
+    {
+        request->kind = WOL_PROBE_ICMP;
+    }
+    else if (ws_field_equals(&cmd->wol.verify, "tcp"))
+    {
+        request->kind = WOL_PROBE_TCP;
+        if (!ws_field_is_number(&cmd->wol.probe_port) || cmd->wol.probe_port.number < 1 || cmd->wol.probe_port.number > 65535)
+        {
+            return false;
+        }
+        request->port = (uint16_t)cmd->wol.probe_port.number;
+    }
+    else
+    {
+        return false;
+    }
+
+    char ip[16];
+    struct in_addr addr;
+    if (!ws_field_is_string(&cmd->wol.ip) || cmd->wol.ip.len >= (int)sizeof(ip))
+    {
+        return false;
+    }
+    memcpy(ip, cmd->wol.ip.str, cmd->wol.ip.len);
+    ip[cmd->wol.ip.len] = 0;
+    if (inet_pton(AF_INET, ip, &addr) != 1)
+    {
+        return false;
+    }
+    request->address = addr.s_addr;
+
+    request->timeout_ms = WOL_VERIFY_DEFAULT_TIMEOUT_MS;
+    if (cmd->wol.timeout_ms.kind != WS_FIELD_ABSENT)
+    {
+        if (!ws_field_is_number(&cmd->wol.timeout_ms) || cmd->wol.timeout_ms.number < 1 ||
+            cmd->wol.timeout_ms.number > WOL_VERIFY_MAX_TIMEOUT_MS)
+        {
+            return false;
+        }
+        request->timeout_ms = (uint32_t)cmd->wol.timeout_ms.number;
+    }
+
+    memcpy(request->mac, mac, WOL_MAC_LEN);
+    request->callback = wol_verify_done;
+    *enabled = true;
+    return true;
+}
+
+// Alvos de um wol com vários MACs: usados só pela task do WS.
+static uint8_t wol_targets[WOL_MAX_TARGETS][WOL_MAC_LEN];
+
+// wol com "macs" e/ou "group" (e "mac", se vier junto): um único envio
+// ritmado pelo wol_sender e um único ack com o total de alvos. O ack confirma
+// que a rajada foi aceita na fila, não que os pacotes já saíram.
+static bool handle_wol_many(const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
+    int count = 0;
+    if (cmd->wol.mac.kind != WS_FIELD_ABSENT)
+    {
+        if (!field_to_mac(&cmd->wol.mac, wol_targets[count]))
+        {
+            reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD, "Invalid mac format");
+            return false;
+        }
+        count++;
+    }
+    if (cmd->wol.macs.kind != WS_FIELD_ABSENT && !command_mac_list(cmd, wol_targets, &count))
+    {
+        reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD,
+                    count > WOL_MAX_TARGETS ? "Too many targets" : "Invalid mac format");
+        return false;
+    }
+    if (cmd->wol.group.kind != WS_FIELD_ABSENT)
+    {
+        const wol_group_t *group = ws_field_is_string(&cmd->wol.group) ? wol_groups_find(cmd->wol.group.str, cmd->wol.group.len)
+                                                                   : NULL;
+        if (!group)
+        {
+            reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD, "Unknown group");
+            return false;
+        }
+        if (count + group->count > WOL_MAX_TARGETS)
+        {
+            reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD, "Too many targets");
+            return false;
+        }
+        memcpy(wol_targets[count], group->macs, (size_t)group->count * WOL_MAC_LEN);
+        count += group->count;
+    }
+    if (count == 0)
+    {
+        reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD, "Invalid or missing mac");
+        return false;
+    }
+
+    // A verificação precisa do IP de cada alvo: só com um mac.
+    wol_options_t options;
+    if (cmd->wol.verify.kind != WS_FIELD_ABSENT || !command_wol_options(cmd, &options))
+    {
+        reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD, "Invalid wol options");
+        return false;
+    }
+
+    if (!wol_send_many((const uint8_t (*)[WOL_MAC_LEN])wol_targets, count, &options))
+    {
+        reply_error(cmd, client, "wol", WS_STATUS_BUSY, "WoL sender busy");
+        return false;
+    }
+
+    char response[96];
+    snprintf(response, sizeof(response), "{\"status\":\"ok\",\"action\":\"wol\",\"targets\":%d,\"rate\":%u}",
+             count, (unsigned)options.rate_pps);
+    reply_json(client, response);
+    return true;
+}
+
+static bool handle_wol_command(const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
+    if (cmd->encoding == WS_ENCODING_JSON &&
+        (cmd->wol.macs.kind != WS_FIELD_ABSENT || cmd->wol.group.kind != WS_FIELD_ABSENT))
+    {
+        return handle_wol_many(cmd, client);
+    }
+
+    if (!ws_field_is_string(&cmd->wol.mac) && cmd->wol.mac.kind != WS_FIELD_BYTES)
+    {
+        reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD, "Invalid or missing mac");
+        return false;
+    }
+
+    uint8_t target_mac[6] = {0};
+    if (!command_target_mac(cmd, target_mac))
+    {
+        reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD, "Invalid mac format");
+        return false;
+    }
+
+    wol_options_t options;
+    if (!command_wol_options(cmd, &options))
+    {
+        reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD, "Invalid wol options");
+        return false;
+    }
+
+    wol_verify_request_t verify;
+    bool verify_enabled = false;
+    if (!command_wol_verify(cmd, target_mac, &verify, &verify_enabled))
+    {
+        reply_error(cmd, client, "wol", WS_STATUS_INVALID_PAYLOAD, "Invalid verify options");
+        return false;
+    }
+
+    if (!wol_send(target_mac, &options))
+    {
+        reply_error(cmd, client, "wol", WS_STATUS_FAILED, "Failed to send WoL packet");
+        return false;
+    }
+
+    if (cmd->encoding == WS_ENCODING_BINARY)
+    {
+        reply_ack(cmd, client, target_mac, sizeof(target_mac));
+        return true;
+    }
+
+    static const char prefix[] = "{\"status\":\"ok\",\"action\":\"wol\",\"targetMac\":";
+    char response[160];
+    memcpy(response, prefix, sizeof(prefix) - 1);
+    int len = append_mac(response, sizeof(response), sizeof(prefix) - 1, target_mac);
+    if (verify_enabled)
+    {
+        // Sem vaga, o WoL já saiu: o ack avisa que não haverá wol_verify.
+        bool verifying = wol_verify_request(&verify);
+        len += snprintf(response + len, sizeof(response) - len, ",\"verifying\":%s", verifying ? "true" : "false");
+    }
+    snprintf(response + len, sizeof(response) - len, "}");
+    reply_json(client, response);
+    return true;
+}
+
+// wol_group: com name + macs cria/substitui o grupo (macs vazio remove); só
+// com name devolve os MACs do grupo; sem name lista os grupos salvos.
+static bool handle_wol_group_command(const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
+    static char response[WOL_MAX_TARGETS * 20 + 96];
+    int len = 0;
+
+    if (cmd->wol.name.kind == WS_FIELD_ABSENT)
+    {
+        len = snprintf(response, sizeof(response), "{\"status\":\"ok\",\"action\":\"wol_group\",\"groups\":[");
+        for (int i = 0; i < wol_groups_count(); i++)
+        {
+            const wol_group_t *group = wol_groups_get(i);
+            len += snprintf(response + len, sizeof(response) - (size_t)len, "%s{\"name\":\"%s\",\"count\":%u}",
+                            i ? "," : "", group->name, (unsigned)group->count);
+        }
+        snprintf(response + len, sizeof(response) - (size_t)len, "]}");
+        reply_json(client, response);
+        return true;
+    }
+
+    if (!ws_field_is_string(&cmd->wol.name) || cmd->wol.name.len == 0 || cmd->wol.name.len >= WOL_GROUP_NAME_MAX ||
+        memchr(cmd->wol.name.str, '"', cmd->wol.name.len) || memchr(cmd->wol.name.str, '\\', cmd->wol.name.len))
+    {
+        reply_error(cmd, client, "wol_group", WS_STATUS_INVALID_PAYLOAD, "Invalid group name");
+        return false;
+    }
+
+    if (cmd->wol.macs.kind == WS_FIELD_ABSENT)
+    {
+        const wol_group_t *group = wol_groups_find(cmd->wol.name.str, cmd->wol.name.len);
+        if (!group)
+        {
+            reply_error(cmd, client, "wol_group", WS_STATUS_INVALID_PAYLOAD, "Unknown group");
+            return false;
+        }
+        len = snprintf(response, sizeof(response), "{\"status\":\"ok\",\"action\":\"wol_group\",\"name\":\"%s\",\"macs\":[",
+                       group->name);
+        for (int i = 0; i < group->count; i++)
+        {
+            if (i)
+            {
+                response[len++] = ',';
+            }
+            len = append_mac(response, sizeof(response), len, group->macs[i]);
+        }
+        snprintf(response + len, sizeof(response) - (size_t)len, "]}");
+        reply_json(client, response);
+        return true;
+    }
+
+    int count = 0;
+    if (!command_mac_list(cmd, wol_targets, &count))
+    {
+        reply_error(cmd, client, "wol_group", WS_STATUS_INVALID_PAYLOAD,
+                    count > WOL_MAX_TARGETS ? "Too many targets" : "Invalid mac format");
+        return false;
+    }
+    if (count > 0 && !wol_groups_find(cmd->wol.name.str, cmd->wol.name.len) && wol_groups_count() >= WOL_GROUP_MAX)
+    {
+        reply_error(cmd, client, "wol_group", WS_STATUS_BUSY, "Too many groups");
+        return false;
+    }
+    if (!wol_groups_set(cmd->wol.name.str, cmd->wol.name.len, (const uint8_t (*)[WOL_MAC_LEN])wol_targets, count))
+    {
+        reply_error(cmd, client, "wol_group", WS_STATUS_FAILED, "Failed to save group");
+        return false;
+    }
+
+    snprintf(response, sizeof(response), "{\"status\":\"ok\",\"action\":\"wol_group\",\"name\":\"%.*s\",\"count\":%d}",
+             cmd->wol.name.len, cmd->wol.name.str, count);
+    reply_json(client, response);
+    return true;
+}
+
+// transitionMs opcional: ausente = troca imediata.
+static bool command_transition_ms(const ws_led_fields_t *led, uint32_t *transition_ms)
+{
+    *transition_ms = 0;
+    if (led->transition_ms.kind == WS_FIELD_ABSENT)
+    {
+        return true;
+    }
+
+    if (!ws_field_is_number(&led->transition_ms) || led->transition_ms.number < 0 ||
+        led->transition_ms.number > LED_TRANSITION_MAX_MS)
+    {
+        return false;
+    }
+    *transition_ms = (uint32_t)led->transition_ms.number;
+    return true;
+}
+
+// segment opcional: nome declarado na config (ou índice, como no formato
+// binário); ausente = todos os segmentos.
+static bool command_segment(const ws_led_fields_t *led, int *segment)
+{
+    *segment = LED_SEGMENT_ALL;
+    if (led->segment.kind == WS_FIELD_ABSENT)
+    {
+        return true;
+    }
+
+    if (ws_field_is_string(&led->segment))
+    {
+        *segment = led_controller_find_segment(led->segment.str, led->segment.len);
+        return *segment >= 0;
+    }
+
+    if (ws_field_is_number(&led->segment) && led->segment.number >= 0 &&
+        led->segment.number < led_controller_get_segment_count())
+    {
+        *segment = ws_field_to_int(&led->segment);
+        return true;
+    }
+    return false;
+}
+
+// Trecho ,"segment":... das respostas JSON (vazio sem segmento).
+static void format_segment(const ws_led_fields_t *led, char *out, size_t out_size)
+{
+    if (ws_field_is_string(&led->segment))
+    {
+        snprintf(out, out_size, ",\"segment\":\"%.*s\"", led->segment.len, led->segment.str);
+    }
+    else if (ws_field_is_number(&led->segment))
+    {
+        snprintf(out, out_size, ",\"segment\":%d", ws_field_to_int(&led->segment));
+    }
+    else
+    {
+        out[0] = '\0';
+    }
+}
+
+static bool handle_led_command(const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
+    const ws_rgbw_fields_t *fields = &cmd->led.color;
+    bool has_white = ws_field_is_number(&fields->w);
+
+    if (!led_controller_is_configured())
+    {
+        reply_error(cmd, client, "led", WS_STATUS_NOT_CONFIGURED, "LED not configured");
+        return false;
+    }
+
+    led_color_t color = {0};
+    if (!ws_field_to_u8(&fields->r, &color.red) ||
+        !ws_field_to_u8(&fields->g, &color.green) ||
+        !ws_field_to_u8(&fields->b, &color.blue))
+    {
+        ws_protocol_send_led_invalid_rgb(client);
+        return false;
+    }
+
+    color.white = has_white ? (uint8_t)ws_field_to_int(&fields->w) : 0;
+
+    uint32_t transition_ms = 0;
+    if (!command_transition_ms(&cmd->led, &transition_ms))
+    {
+        reply_error(cmd, client, "led", WS_STATUS_INVALID_PAYLOAD, "Invalid transitionMs");
+        return false;
+    }
+
+    int segment = LED_SEGMENT_ALL;
+    if (!command_segment(&cmd->led, &segment))
+    {
+        reply_error(cmd, client, "led", WS_STATUS_INVALID_PAYLOAD, "Unknown segment");
+        return false;
+    }
+
+    if (!led_controller_enqueue(segment, &color, transition_ms))
+    {
+        reply_error(cmd, client, "led", WS_STATUS_BUSY, "LED controller not running");
+        return false;
+    }
+
+    if (cmd->encoding == WS_ENCODING_BINARY)
+    {
+        const uint8_t echo[4] = {color.red, color.green, color.blue, color.white};
+        reply_ack(cmd, client, echo, sizeof(echo));
         return true;
     }
 
-    if (strcmp(led_type_json->valuestring, "sk6812") == 0)
+    char segment_json[48];
+    format_segment(&cmd->led, segment_json, sizeof(segment_json));
+
+    char response[192];
+    if (has_white)
+    {
+        snprintf(response, sizeof(response),
+                 "{\"status\":\"ok\",\"action\":\"led\",\"r\":%u,\"g\":%u,\"b\":%u,\"w\":%u%s}",
+                 color.red, color.green, color.blue, color.white, segment_json);
+    }
+    else
+    {
+        snprintf(response, sizeof(response),
+                 "{\"status\":\"ok\",\"action\":\"led\",\"r\":%u,\"g\":%u,\"b\":%u%s}",
+                 color.red, color.green, color.blue, segment_json);
+    }
+    reply_json(client, response);
+    return true;
+}
+
+// JSON identifica o efeito pelo nome; o formato binário, pelo id (posição no
+// registro).
+static bool resolve_effect(ws_encoding_t encoding, const ws_led_fields_t *led, const led_effect_t **effect,
+                           const ws_field_t **effect_name)
+{
+    static const ws_field_t none_name = {.kind = WS_FIELD_STRING, .str = "none", .len = 4};
+
+    if (encoding == WS_ENCODING_BINARY)
+    {
+        *effect = led_effect_from_id(ws_field_to_int(&led->effect));
+        *effect_name = NULL;
+        return *effect != NULL;
+    }
+
+    *effect_name = ws_field_is_string(&led->effect) ? &led->effect : &none_name;
+
+    // "none" (ou desconhecido) vira id 0 -> interrompe o efeito
+    int effect_value = ws_name_index_find(&effect_index, (*effect_name)->str, (*effect_name)->len);
+    *effect = led_effect_from_id(effect_value < 0 ? 0 : effect_value);
+    return true;
+}
+
+// Parâmetro numérico 0..255 opcional, aceito só se o efeito o declara.
+static bool effect_param_u8(const ws_field_t *field, const led_effect_t *effect, uint8_t param, uint8_t *value)
+{
+    if (field->kind == WS_FIELD_ABSENT)
     {
-        *led_type = LED_STRIP_TYPE_SK6812;
         return true;
     }
-
-    return false;
+    return (effect->schema.params & param) && ws_field_to_u8(field, value);
+}
+
+// colors: lista de {r, g, b} (até schema.max_colors), substitui a cor base.
+static bool effect_param_colors(const ws_led_fields_t *led, const led_effect_t *effect, led_effect_params_t *params)
+{
+    ws_command_iter_t iter;
+    if (!ws_command_iter_init_array(&iter, &led->colors, led->colors_json))
+    {
+        return led->colors.kind == WS_FIELD_ABSENT;
+    }
+    if (!(effect->schema.params & LED_EFFECT_PARAM_COLORS))
+    {
+        return false;
+    }
+
+    bool ok = true;
+    int count = 0;
+    ws_rgbw_fields_t item;
+    cJSON *item_root = NULL;
+    ws_command_iter_result_t result;
+    while (ok && (result = ws_command_iter_next_color(&iter, &item, &item_root)) != WS_COMMAND_ITER_END)
+    {
+        led_color_t color = {0};
+        if (result != WS_COMMAND_ITER_ITEM || count >= effect->schema.max_colors ||
+            !ws_field_to_u8(&item.r, &color.red) || !ws_field_to_u8(&item.g, &color.green) ||
+            !ws_field_to_u8(&item.b, &color.blue))
+        {
+            ok = false;
+        }
+        else
+        {
+            params->colors[count++] = color;
+        }
+        cJSON_Delete(item_root);
+    }
+    if (ok && count > 0)
+    {
+        params->color_count = (uint8_t)count;
+    }
+    return ok && count > 0;
+}
+
+// startAt aceito até 24 h antes ou depois do relógio local.
+#define EFFECT_START_AT_WINDOW_MS (24LL * 60 * 60 * 1000)
+
+// startAt opcional: início do efeito no relógio de parede (epoch, ms), para
+// dispositivos diferentes animarem em fase. Exige o relógio sincronizado.
+static bool effect_param_start_at(const ws_led_fields_t *led, led_effect_params_t *params, const char **error)
+{
+    if (led->start_at.kind == WS_FIELD_ABSENT)
+    {
+        return true;
+    }
+    if (!net_time_is_synced())
+    {
+        *error = "Clock not synchronized";
+        return false;
+    }
+
+    int64_t now_ms = net_time_now_ms();
+    if (!ws_field_is_number(&led->start_at) || led->start_at.number < (double)(now_ms - EFFECT_START_AT_WINDOW_MS) ||
+        led->start_at.number > (double)(now_ms + EFFECT_START_AT_WINDOW_MS))
+    {
+        *error = "Invalid startAt";
+        return false;
+    }
+    params->start_at_ms = (int64_t)led->start_at.number;
+    return true;
+}
+
+// Padrões do schema do efeito, sobrescritos pelos campos presentes. Campos
+// que o efeito não declara são recusados; o efeito "none" ignora todos.
+static bool parse_effect_params(const ws_led_fields_t *led, const led_effect_t *effect, led_effect_params_t *params,
+                                const char **error)
+{
+    led_effect_params_init(effect, params);
+
+    // Cor base opcional (usada por efeitos como breathing)
+    led_color_t base = {0};
+    if (ws_field_to_u8(&led->color.r, &base.red) &&
+        ws_field_to_u8(&led->color.g, &base.green) &&
+        ws_field_to_u8(&led->color.b, &base.blue))
+    {
+        params->colors[0] = base;
+    }
+
+    if (!effect->render)
+    {
+        return true;
+    }
+
+    if (!effect_param_u8(&led->speed, effect, LED_EFFECT_PARAM_SPEED, &params->speed))
+    {
+        *error = "Invalid speed";
+        return false;
+    }
+    if (!effect_param_u8(&led->density, effect, LED_EFFECT_PARAM_DENSITY, &params->density))
+    {
+        *error = "Invalid density";
+        return false;
+    }
+    if (led->palette.kind != WS_FIELD_ABSENT)
+    {
+        int palette = ws_field_is_string(&led->palette)
+                          ? led_effect_find_palette(led->palette.str, led->palette.len)
+                          : -1;
+        if (!(effect->schema.params & LED_EFFECT_PARAM_PALETTE) || palette < 0)
+        {
+            *error = "Invalid palette";
+            return false;
+        }
+        params->palette = (uint8_t)palette;
+    }
+    if (!effect_param_colors(led, effect, params))
+    {
+        *error = "Invalid colors";
+        return false;
+    }
+    return effect_param_start_at(led, params, error);
+}
+
+static bool handle_effect_command(const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
+    if (!led_controller_is_configured())
+    {
+        reply_error(cmd, client, "effect", WS_STATUS_NOT_CONFIGURED, "LED not configured");
+        return false;
+    }
+
+    const led_effect_t *effect = NULL;
+    const ws_field_t *effect_name = NULL;
+    if (!resolve_effect(cmd->encoding, &cmd->led, &effect, &effect_name))
+    {
+        reply_error(cmd, client, "effect", WS_STATUS_INVALID_PAYLOAD, "Unknown effect");
+        return false;
+    }
+
+    led_effect_params_t params;
+    const char *params_error = NULL;
+    if (!parse_effect_params(&cmd->led, effect, &params, &params_error))
+    {
+        reply_error(cmd, client, "effect", WS_STATUS_INVALID_PAYLOAD, params_error);
+        return false;
+    }
+
+    uint32_t transition_ms = 0;
+    if (!command_transition_ms(&cmd->led, &transition_ms))
+    {
+        reply_error(cmd, client, "effect", WS_STATUS_INVALID_PAYLOAD, "Invalid transitionMs");
+        return false;
+    }
+
+    int segment = LED_SEGMENT_ALL;
+    if (!command_segment(&cmd->led, &segment))
+    {
+        reply_error(cmd, client, "effect", WS_STATUS_INVALID_PAYLOAD, "Unknown segment");
+        return false;
+    }
+
+    if (!led_controller_set_effect(segment, effect, &params, transition_ms))
+    {
+        reply_error(cmd, client, "effect", WS_STATUS_BUSY, "LED controller not running");
+        return false;
+    }
+
+    if (cmd->encoding == WS_ENCODING_BINARY)
+    {
+        const uint8_t echo[1] = {(uint8_t)led_effect_id(effect)};
+        reply_ack(cmd, client, echo, sizeof(echo));
+        return true;
+    }
+
+    char segment_json[48];
+    format_segment(&cmd->led, segment_json, sizeof(segment_json));
+
+    char response[144];
+    snprintf(response, sizeof(response), "{\"status\":\"ok\",\"action\":\"effect\",\"effect\":\"%.*s\"%s}",
+             effect_name->len, effect_name->str, segment_json);
+    reply_json(client, response);
+    return true;
+}
+
+// Um keyframe: atMs, segment e transitionMs opcionais e, como nos comandos
+// avulsos, effect (com os mesmos parâmetros) ou r/g/b[/w].
+static bool parse_keyframe(const ws_led_fields_t *item, led_keyframe_t *keyframe)
+{
+    memset(keyframe, 0, sizeof(*keyframe));
+    if (!ws_field_is_number(&item->at_ms) || item->at_ms.number < 0 || item->at_ms.number > LED_TIMELINE_MAX_MS ||
+        !command_transition_ms(item, &keyframe->transition_ms) || !command_segment(item, &keyframe->segment))
+    {
+        return false;
+    }
+    keyframe->at_ms = (uint32_t)item->at_ms.number;
+
+    if (item->effect.kind != WS_FIELD_ABSENT)
+    {
+        const ws_field_t *effect_name = NULL;
+        const char *params_error = NULL;
+        keyframe->has_effect = true;
+        return ws_field_is_string(&item->effect) && resolve_effect(WS_ENCODING_JSON, item, &keyframe->effect, &effect_name) &&
+               parse_effect_params(item, keyframe->effect, &keyframe->params, &params_error);
+    }
+
+    led_color_t *color = &keyframe->color;
+    return ws_field_to_u8(&item->color.r, &color->red) && ws_field_to_u8(&item->color.g, &color->green) &&
+           ws_field_to_u8(&item->color.b, &color->blue) &&
+           (item->color.w.kind == WS_FIELD_ABSENT || ws_field_to_u8(&item->color.w, &color->white));
+}
+
+// Lê keyframes direto no buffer de edição da timeline. Os keyframes vêm em
+// ordem de atMs; *last_ms recebe o maior.
+static bool parse_keyframes(const ws_command_t *cmd, led_keyframe_t *keyframes, int *count, uint32_t *last_ms)
+{
+    *count = 0;
+    *last_ms = 0;
+    ws_command_iter_t iter;
+    if (!ws_command_iter_init_array(&iter, &cmd->timeline.keyframes, cmd->timeline.keyframes_json))
+    {
+        return false;
+    }
+
+    bool ok = true;
+    ws_led_fields_t item;
+    cJSON *item_root = NULL;
+    ws_command_iter_result_t result;
+    while (ok && (result = ws_command_iter_next_keyframe(&iter, &item, &item_root)) != WS_COMMAND_ITER_END)
+    {
+        led_keyframe_t *keyframe = &keyframes[*count];
+        if (result != WS_COMMAND_ITER_ITEM || *count >= LED_TIMELINE_MAX_KEYFRAMES ||
+            !parse_keyframe(&item, keyframe) || keyframe->at_ms < *last_ms)
+        {
+            ok = false;
+        }
+        else
+        {
+            *last_ms = keyframe->at_ms;
+            (*count)++;
+        }
+        cJSON_Delete(item_root);
+    }
+    return ok && *count > 0;
 }
 
-static bool handle_wol_command(cJSON *root, esp_websocket_client_handle_t client)
+static bool handle_timeline_upload(const ws_command_t *cmd, esp_websocket_client_handle_t client)
 {
-    cJSON *mac_json = cJSON_GetObjectItemCaseSensitive(root, "mac");
-    if (!cJSON_IsString(mac_json) || mac_json->valuestring == NULL)
+    int count = 0;
+    uint32_t last_ms = 0;
+    if (!parse_keyframes(cmd, led_controller_timeline_edit(), &count, &last_ms))
     {
-        ws_protocol_send_error(client, "wol", "Invalid or missing mac");
+        reply_error(cmd, client, "timeline", WS_STATUS_INVALID_PAYLOAD, "Invalid keyframes");
         return false;
     }
 
-    uint8_t target_mac[6] = {0};
-    if (!parse_mac_string(mac_json->valuestring, target_mac))
+    // durationMs opcional: padrão = último keyframe (com loop, a volta
+    // seguinte começa nele).
+    uint32_t duration_ms = last_ms;
+    if (cmd->timeline.duration_ms.kind != WS_FIELD_ABSENT)
     {
-        ws_protocol_send_error(client, "wol", "Invalid mac format");
-        return false;
+        if (!ws_field_is_number(&cmd->timeline.duration_ms) || cmd->timeline.duration_ms.number < last_ms ||
+            cmd->timeline.duration_ms.number > LED_TIMELINE_MAX_MS)
+        {
+            reply_error(cmd, client, "timeline", WS_STATUS_INVALID_PAYLOAD, "Invalid durationMs");
+            return false;
+        }
+        duration_ms = (uint32_t)cmd->timeline.duration_ms.number;
     }
 
-    if (!send_wake_on_lan(target_mac))
+    bool loop = ws_field_is_true(&cmd->timeline.loop);
+    if (!led_controller_timeline_valid(count, duration_ms))
+    {
+        reply_error(cmd, client, "timeline", WS_STATUS_INVALID_PAYLOAD, "Invalid keyframes");
+        return false;
+    }
+    if (!led_controller_timeline_commit(count, duration_ms, loop))
     {
-        ws_protocol_send_error(client, "wol", "Failed to send WoL packet");
+        reply_error(cmd, client, "timeline", WS_STATUS_BUSY, "LED controller not running");
         return false;
     }
 
-    char response[160];
+    char response[128];
     snprintf(response, sizeof(response),
-             "{\"status\":\"ok\",\"action\":\"wol\",\"targetMac\":\"%02X:%02X:%02X:%02X:%02X:%02X\"}",
-             target_mac[0], target_mac[1], target_mac[2], target_mac[3], target_mac[4], target_mac[5]);
-    ws_protocol_send_json(client, response);
+             "{\"status\":\"ok\",\"action\":\"timeline\",\"keyframes\":%d,\"durationMs\":%u,\"loop\":%s}",
+             count, (unsigned)duration_ms, loop ? "true" : "false");
+    reply_json(client, response);
     return true;
 }
 
-static bool handle_led_command(cJSON *root, esp_websocket_client_handle_t client)
+static const char *timeline_state_name(led_timeline_state_t state)
+{
+    switch (state)
+    {
+        case LED_TIMELINE_PLAYING:
+            return "playing";
+        case LED_TIMELINE_PAUSED:
+            return "paused";
+        default:
+            return "stopped";
+    }
+}
+
+static bool handle_timeline_status(esp_websocket_client_handle_t client)
 {
-    cJSON *r = cJSON_GetObjectItemCaseSensitive(root, "r");
-    cJSON *g = cJSON_GetObjectItemCaseSensitive(root, "g");
-    cJSON *b = cJSON_GetObjectItemCaseSensitive(root, "b");
-    cJSON *w = cJSON_GetObjectItemCaseSensitive(root, "w");
+    led_timeline_status_t status;
+    led_controller_get_timeline_status(&status);
+
+    char response[192];
+    snprintf(response, sizeof(response),
+             "{\"status\":\"ok\",\"action\":\"timeline\",\"state\":\"%s\",\"positionMs\":%u,"
+             "\"keyframes\":%d,\"durationMs\":%u,\"loops\":%u}",
+             timeline_state_name(status.state), (unsigned)status.position_ms, status.keyframes,
+             (unsigned)status.duration_ms, (unsigned)status.loops);
+    reply_json(client, response);
+    return true;
+}
 
+// keyframes => envia (e toca do início) uma timeline nova; senão control
+// age sobre a timeline carregada.
+static bool handle_timeline_command(const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
     if (!led_controller_is_configured())
     {
-        ws_protocol_send_error(client, "led", "LED not configured");
+        reply_error(cmd, client, "timeline", WS_STATUS_NOT_CONFIGURED, "LED not configured");
         return false;
     }
 
-    led_color_t color = {0};
-    if (!ws_protocol_cjson_to_u8(r, &color.red) ||
-        !ws_protocol_cjson_to_u8(g, &color.green) ||
-        !ws_protocol_cjson_to_u8(b, &color.blue))
+    if (cmd->timeline.keyframes.kind != WS_FIELD_ABSENT)
     {
-        ws_protocol_send_led_invalid_rgb(client);
-        return false;
+        return handle_timeline_upload(cmd, client);
     }
 
-    if (w && cJSON_IsNumber(w))
+    if (ws_field_equals(&cmd->timeline.control, "status"))
     {
-        color.white = (uint8_t)w->valueint;
+        return handle_timeline_status(client);
     }
-    else
+
+    led_timeline_control_t control;
+    uint32_t position_ms = 0;
+    if (ws_field_equals(&cmd->timeline.control, "play"))
     {
-        color.white = 0;
+        control = LED_TIMELINE_PLAY;
     }
-
-    if (!led_controller_enqueue(&color, 100))
+    else if (ws_field_equals(&cmd->timeline.control, "pause"))
     {
-        ws_protocol_send_error(client, "led", "LED queue busy");
-        return false;
+        control = LED_TIMELINE_PAUSE;
     }
-
-    char response[160];
-    if (w && cJSON_IsNumber(w))
+    else if (ws_field_equals(&cmd->timeline.control, "stop"))
     {
-        snprintf(response, sizeof(response),
-                 "{\"status\":\"ok\",\"action\":\"led\",\"r\":%u,\"g\":%u,\"b\":%u,\"w\":%u}",
-                 color.red, color.green, color.blue, color.white);
+        control = LED_TIMELINE_STOP;
+    }
+    else if (ws_field_equals(&cmd->timeline.control, "seek") && ws_field_is_number(&cmd->timeline.position_ms) &&
+             cmd->timeline.position_ms.number >= 0 && cmd->timeline.position_ms.number <= LED_TIMELINE_MAX_MS)
+    {
+        control = LED_TIMELINE_SEEK;
+        position_ms = (uint32_t)cmd->timeline.position_ms.number;
     }
     else
     {
-        snprintf(response, sizeof(response),
-                 "{\"status\":\"ok\",\"action\":\"led\",\"r\":%u,\"g\":%u,\"b\":%u}",
-                 color.red, color.green, color.blue);
+        reply_error(cmd, client, "timeline", WS_STATUS_INVALID_PAYLOAD, "Invalid control");
+        return false;
+    }
+
+    if (!led_controller_timeline_control(control, position_ms))
+    {
+        reply_error(cmd, client, "timeline", WS_STATUS_BUSY, "LED controller not running");
+        return false;
     }
-    ws_protocol_send_json(client, response);
+
+    char response[128];
+    snprintf(response, sizeof(response), "{\"status\":\"ok\",\"action\":\"timeline\",\"control\":\"%.*s\"}",
+             cmd->timeline.control.len, cmd->timeline.control.str);
+    reply_json(client, response);
     return true;
 }
 
-static bool handle_effect_command(cJSON *root, esp_websocket_client_handle_t client)
+// Uma saída: ledPin, ledCount, ledType (opcional, padrão ws2812b) e backend
+// (opcional, padrão rmt), no topo da config ou em cada item de outputs.
+static bool parse_output(const ws_output_fields_t *fields, led_output_config_t *output)
 {
-    if (!led_controller_is_configured())
+    if (!ws_field_is_number(&fields->led_count) || !ws_field_is_number(&fields->led_pin))
     {
-        ws_protocol_send_error(client, "effect", "LED not configured");
+        ESP_LOGW(TAG, "Config response incomplete: missing ledCount or ledPin");
         return false;
     }
 
-    cJSON *effect_json = cJSON_GetObjectItemCaseSensitive(root, "effect");
-    const char *effect_name = (cJSON_IsString(effect_json) && effect_json->valuestring != NULL)
-                                  ? effect_json->valuestring
-                                  : "none";
-
-    led_effect_t effect = LED_EFFECT_NONE;
-    if (strcmp(effect_name, "breathing") == 0)
+    output->count = ws_field_to_int(&fields->led_count);
+    output->pin = ws_field_to_int(&fields->led_pin);
+    if (output->count <= 0 || output->pin < 0)
     {
-        effect = LED_EFFECT_BREATHING;
+        ESP_LOGW(TAG, "Config response invalid values (ledCount=%d ledPin=%d)", output->count, output->pin);
+        return false;
     }
-    else if (strcmp(effect_name, "rainbow") == 0)
+
+    if (!parse_led_type(&fields->led_type, &output->type))
     {
-        effect = LED_EFFECT_RAINBOW;
+        ESP_LOGW(TAG, "Config response invalid ledType: %.*s", fields->led_type.len, fields->led_type.str);
+        return false;
     }
-    else if (strcmp(effect_name, "fade") == 0)
+
+    output->backend = NULL;
+    if (fields->backend.kind != WS_FIELD_ABSENT)
     {
-        effect = LED_EFFECT_FADE;
+        output->backend = ws_field_is_string(&fields->backend)
+                              ? led_controller_find_backend(fields->backend.str, fields->backend.len)
+                              : NULL;
+        if (!output->backend)
+        {
+            ESP_LOGW(TAG, "Config response invalid backend: %.*s", fields->backend.len, fields->backend.str);
+            return false;
+        }
     }
-    // "none" (ou desconhecido) mantém LED_EFFECT_NONE -> interrompe o efeito
+    return true;
+}
 
-    // Cor base opcional (usada por efeitos como breathing)
-    led_color_t base = {0};
-    led_color_t *base_ptr = NULL;
-    cJSON *r = cJSON_GetObjectItemCaseSensitive(root, "r");
-    cJSON *g = cJSON_GetObjectItemCaseSensitive(root, "g");
-    cJSON *b = cJSON_GetObjectItemCaseSensitive(root, "b");
-    if (ws_protocol_cjson_to_u8(r, &base.red) &&
-        ws_protocol_cjson_to_u8(g, &base.green) &&
-        ws_protocol_cjson_to_u8(b, &base.blue))
+// Saídas da fita: o array outputs, se houver; senão uma saída descrita no
+// próprio topo da config.
+static bool parse_outputs(const ws_command_t *cmd, led_output_config_t *outputs, int *count)
+{
+    *count = 0;
+    if (cmd->config.outputs.kind == WS_FIELD_ABSENT)
     {
-        base_ptr = &base;
+        *count = 1;
+        return parse_output(&cmd->config.output, &outputs[0]);
     }
 
-    if (!led_controller_set_effect(effect, base_ptr, 100))
+    ws_command_iter_t iter;
+    if (!ws_command_iter_init_array(&iter, &cmd->config.outputs, cmd->config.outputs_json))
     {
-        ws_protocol_send_error(client, "effect", "LED queue busy");
+        ESP_LOGW(TAG, "Config response invalid outputs");
         return false;
     }
 
-    char response[96];
-    snprintf(response, sizeof(response),
-             "{\"status\":\"ok\",\"action\":\"effect\",\"effect\":\"%s\"}", effect_name);
-    ws_protocol_send_json(client, response);
-    return true;
+    bool ok = true;
+    ws_output_fields_t item;
+    cJSON *item_root = NULL;
+    ws_command_iter_result_t result;
+    while (ok && (result = ws_command_iter_next_output(&iter, &item, &item_root)) != WS_COMMAND_ITER_END)
+    {
+        if (result != WS_COMMAND_ITER_ITEM || *count >= LED_MAX_OUTPUTS)
+        {
+            ESP_LOGW(TAG, "Config response invalid outputs (max %d objects)", LED_MAX_OUTPUTS);
+            ok = false;
+        }
+        else
+        {
+            ok = parse_output(&item, &outputs[(*count)++]);
+        }
+        cJSON_Delete(item_root);
+    }
+    if (ok && *count == 0)
+    {
+        ESP_LOGW(TAG, "Config response has no outputs");
+        ok = false;
+    }
+    return ok;
+}
+
+// Lê os segmentos da config (array de {name, start, length, reversed}).
+// Retorna false se algum item é inválido; *count = 0 sem o campo.
+static bool parse_segments(const ws_command_t *cmd, led_segment_t *segments, int *count)
+{
+    *count = 0;
+    ws_command_iter_t iter;
+    if (!ws_command_iter_init_array(&iter, &cmd->config.segments, cmd->config.segments_json))
+    {
+        return cmd->config.segments.kind == WS_FIELD_ABSENT;
+    }
+
+    bool ok = true;
+    ws_segment_fields_t item;
+    cJSON *item_root = NULL;
+    ws_command_iter_result_t result;
+    while (ok && (result = ws_command_iter_next_segment(&iter, &item, &item_root)) != WS_COMMAND_ITER_END)
+    {
+        if (result != WS_COMMAND_ITER_ITEM || *count >= LED_MAX_SEGMENTS || !ws_field_is_string(&item.name) ||
+            item.name.len <= 0 || item.name.len >= LED_SEGMENT_NAME_MAX || !ws_field_is_number(&item.start) ||
+            !ws_field_is_number(&item.length))
+        {
+            ok = false;
+        }
+        else
+        {
+            led_segment_t *seg = &segments[(*count)++];
+            memset(seg, 0, sizeof(*seg));
+            memcpy(seg->name, item.name.str, (size_t)item.name.len);
+            seg->start = ws_field_to_int(&item.start);
+            seg->length = ws_field_to_int(&item.length);
+            seg->reversed = ws_field_is_true(&item.reversed);
+        }
+        cJSON_Delete(item_root);
+    }
+    return ok;
 }
 
-static bool handle_config_message(cJSON *root, esp_websocket_client_handle_t client)
+static bool handle_config_message(const ws_command_t *cmd, esp_websocket_client_handle_t client)
 {
-    cJSON *status_json = cJSON_GetObjectItemCaseSensitive(root, "status");
-    if (!cJSON_IsString(status_json) || status_json->valuestring == NULL)
+    if (!ws_field_is_string(&cmd->status))
     {
         ESP_LOGW(TAG, "Invalid config response: missing status");
         return false;
     }
 
-    if (strcmp(status_json->valuestring, "ok") == 0)
+    if (ws_field_equals(&cmd->status, "ok"))
     {
-        cJSON *led_count_json = cJSON_GetObjectItemCaseSensitive(root, "ledCount");
-        cJSON *led_pin_json = cJSON_GetObjectItemCaseSensitive(root, "ledPin");
-        cJSON *led_type_json = cJSON_GetObjectItemCaseSensitive(root, "ledType");
-
-        if (!cJSON_IsNumber(led_count_json) || !cJSON_IsNumber(led_pin_json))
+        led_output_config_t outputs[LED_MAX_OUTPUTS];
+        int output_count = 0;
+        if (!parse_outputs(cmd, outputs, &output_count))
         {
-            ESP_LOGW(TAG, "Config response incomplete: missing ledCount or ledPin");
             ws_protocol_request_force_reconnect();
             return false;
         }
+        int led_count = 0;
+        for (int i = 0; i < output_count; i++)
+        {
+            led_count += outputs[i].count;
+        }
 
-        int led_count = led_count_json->valueint;
-        int led_pin = led_pin_json->valueint;
-        led_strip_type_t led_type = LED_STRIP_TYPE_WS2812B;
-        if (led_count <= 0 || led_pin < 0)
+        // Estágio de saída: campos opcionais; ausentes (ou inválidos) voltam ao
+        // padrão, brilho máximo e sem limite de corrente.
+        uint8_t brightness = 255;
+        if (cmd->config.brightness.kind != WS_FIELD_ABSENT && !ws_field_to_u8(&cmd->config.brightness, &brightness))
         {
-            ESP_LOGW(TAG, "Config response invalid values (ledCount=%d ledPin=%d)", led_count, led_pin);
-            ws_protocol_request_force_reconnect();
-            return false;
+            ESP_LOGW(TAG, "Config response invalid brightness, using 255");
+            brightness = 255;
+        }
+        uint32_t max_milliamps = 0;
+        if (cmd->config.max_milliamps.kind != WS_FIELD_ABSENT)
+        {
+            if (ws_field_is_number(&cmd->config.max_milliamps) && cmd->config.max_milliamps.number >= 0 &&
+                cmd->config.max_milliamps.number <= UINT32_MAX)
+            {
+                max_milliamps = (uint32_t)cmd->config.max_milliamps.number;
+            }
+            else
+            {
+                ESP_LOGW(TAG, "Config response invalid maxMilliamps, power limit disabled");
+            }
         }
+        led_controller_set_output(brightness, max_milliamps);
 
-        if (!parse_led_type(led_type_json, &led_type))
+        // Ausente mantém o modo atual da conexão.
+        if (cmd->config.signed_commands.kind != WS_FIELD_ABSENT)
         {
-            const char *led_type_value = (cJSON_IsString(led_type_json) && led_type_json->valuestring) ? led_type_json->valuestring : "<missing>";
-            ESP_LOGW(TAG, "Config response invalid ledType: %s", led_type_value);
-            ws_protocol_request_force_reconnect();
-            return false;
+            ws_command_auth_set_enabled(ws_field_is_true(&cmd->config.signed_commands));
         }
 
-        if (!led_controller_configure(led_pin, led_count, led_type))
+        if (!led_controller_configure_outputs(outputs, output_count))
         {
             ESP_LOGE(TAG, "Failed to apply server LED config");
             ws_protocol_request_force_reconnect();
             return false;
         }
 
+        // Segmentos opcionais: layout inválido não derruba a config, a fita
+        // fica com um segmento único.
+        led_segment_t segments[LED_MAX_SEGMENTS];
+        int segment_count = 0;
+        if (!parse_segments(cmd, segments, &segment_count) ||
+            !led_controller_set_segments(segments, segment_count))
+        {
+            ESP_LOGW(TAG, "Config response invalid segments, using the whole strip");
+            led_controller_set_segments(NULL, 0);
+        }
+
         // Se houver lastLedColor, já define a cor inicial
-        cJSON *last_color_json = cJSON_GetObjectItemCaseSensitive(root, "lastLedColor");
-        if (cJSON_IsObject(last_color_json))
+        bool has_last_color = (cmd->config.last_led_color.kind == WS_FIELD_OBJECT);
+        if (has_last_color)
         {
-            cJSON *r = cJSON_GetObjectItemCaseSensitive(last_color_json, "r");
-            cJSON *g = cJSON_GetObjectItemCaseSensitive(last_color_json, "g");
-            cJSON *b = cJSON_GetObjectItemCaseSensitive(last_color_json, "b");
-            cJSON *w = cJSON_GetObjectItemCaseSensitive(last_color_json, "w");
             led_color_t color = {0};
-            if (cJSON_IsNumber(r))
-                color.red = (uint8_t)r->valueint;
-            if (cJSON_IsNumber(g))
-                color.green = (uint8_t)g->valueint;
-            if (cJSON_IsNumber(b))
-                color.blue = (uint8_t)b->valueint;
-            if (cJSON_IsNumber(w))
-                color.white = (uint8_t)w->valueint;
-            led_controller_enqueue(&color, 100);
+            color_from_fields(&cmd->config.last_color, &color);
+            led_controller_enqueue(LED_SEGMENT_ALL, &color, 0);
         }
 
-        ESP_LOGI(TAG, "Server config applied successfully (ledCount=%d ledPin=%d ledType=%s)", led_count, led_pin, (led_type == LED_STRIP_TYPE_SK6812) ? "sk6812" : "ws2812b");
+        ESP_LOGI(TAG, "Server config applied successfully (outputs=%d ledCount=%d ledPin=%d ledType=%s brightness=%u maxMilliamps=%u)",
+                 output_count, led_count, outputs[0].pin,
+                 (outputs[0].type == LED_STRIP_TYPE_SK6812) ? "sk6812" : "ws2812b", brightness,
+                 (unsigned)max_milliamps);
 
         // Reporta o estado atual da cor para o servidor
         led_color_t current_color = {0};
-        cJSON *last_color_after = cJSON_GetObjectItemCaseSensitive(root, "lastLedColor");
-        if (cJSON_IsObject(last_color_after))
+        if (has_last_color)
         {
-            cJSON *r2 = cJSON_GetObjectItemCaseSensitive(last_color_after, "r");
-            cJSON *g2 = cJSON_GetObjectItemCaseSensitive(last_color_after, "g");
-            cJSON *b2 = cJSON_GetObjectItemCaseSensitive(last_color_after, "b");
-            if (cJSON_IsNumber(r2)) current_color.red   = (uint8_t)r2->valueint;
-            if (cJSON_IsNumber(g2)) current_color.green = (uint8_t)g2->valueint;
-            if (cJSON_IsNumber(b2)) current_color.blue  = (uint8_t)b2->valueint;
+            color_from_fields(&cmd->config.last_color, &current_color);
+            current_color.white = 0;
         }
         char state_report[128];
         snprintf(state_report, sizeof(state_report),
                  "{\"action\":\"state_report\",\"r\":%u,\"g\":%u,\"b\":%u,\"w\":%u}",
                  current_color.red, current_color.green, current_color.blue, current_color.white);
-        ws_protocol_send_json(client, state_report);
+        reply_json(client, state_report);
 
         return true;
     }
 
-    if (strcmp(status_json->valuestring, "error") == 0)
+    if (ws_field_equals(&cmd->status, "error"))
     {
-        cJSON *error_json = cJSON_GetObjectItemCaseSensitive(root, "error");
-        if (cJSON_IsString(error_json) && error_json->valuestring && strcmp(error_json->valuestring, "config_incomplete") == 0)
+        if (ws_field_equals(&cmd->error, "config_incomplete"))
         {
             ESP_LOGW(TAG, "Server reported config_incomplete; reconnecting with backoff");
             ws_protocol_request_force_reconnect();
             return false;
         }
 
-        if (cJSON_IsString(error_json) && error_json->valuestring)
+        if (ws_field_is_string(&cmd->error))
         {
-            ESP_LOGW(TAG, "Server returned config error: %s", error_json->valuestring);
+            ESP_LOGW(TAG, "Server returned config error: %.*s", cmd->error.len, cmd->error.str);
         }
         else
         {
@@ -287,33 +1310,401 @@ static bool handle_config_message(cJSON *root, esp_websocket_client_handle_t cli
         return false;
     }
 
-    ESP_LOGW(TAG, "Unhandled config status: %s", status_json->valuestring);
+    ESP_LOGW(TAG, "Unhandled config status: %.*s", cmd->status.len, cmd->status.str);
     return false;
 }
 
-void ws_protocol_handle_complete_text(esp_websocket_client_handle_t client, const char *json_buffer)
+static bool handle_ping_command(const ws_command_t *cmd, esp_websocket_client_handle_t client)
 {
-    if (!json_buffer)
+    if (cmd->encoding == WS_ENCODING_BINARY)
+    {
+        reply_ack(cmd, client, NULL, 0);
+        return true;
+    }
+
+    reply_json(client, "{\"status\":\"ok\",\"action\":\"pong\"}");
+    return true;
+}
+
+// Frames do stream não têm ack de sucesso (a 50 fps seria só ruído na volta);
+// erros voltam como ack binário e as métricas ficam no stats.
+static bool handle_stream_command(const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
+    if (cmd->encoding != WS_ENCODING_BINARY)
+    {
+        reply_error(cmd, client, "stream", WS_STATUS_UNSUPPORTED, "stream requires binary frames");
+        return false;
+    }
+
+    if (!led_controller_is_configured())
+    {
+        reply_error(cmd, client, "stream", WS_STATUS_NOT_CONFIGURED, "LED not configured");
+        return false;
+    }
+
+    int flags = ws_field_to_int(&cmd->stream.flags);
+    bool rgbw = (flags & WS_STREAM_FLAG_RGBW) != 0;
+    int pixel_count = cmd->stream.pixels.len / (rgbw ? 4 : 3);
+    if (!led_controller_stream_write((uint16_t)ws_field_to_int(&cmd->stream.seq), (uint16_t)ws_field_to_int(&cmd->stream.offset),
+                                     (const uint8_t *)cmd->stream.pixels.str, pixel_count, rgbw,
+                                     (flags & WS_STREAM_FLAG_PUSH) != 0))
+    {
+        reply_error(cmd, client, "stream", WS_STATUS_INVALID_PAYLOAD, "Pixels out of range");
+        return false;
+    }
+    return true;
+}
+
+static bool handle_stats_command(const ws_command_t *cmd, esp_websocket_client_handle_t client);
+static bool handle_batch_command(const ws_command_t *cmd, esp_websocket_client_handle_t client);
+
+static const ws_action_t ws_actions[] = {
+    {"led", handle_led_command, WS_TX_PRIORITY_REALTIME},
+    {"effect", handle_effect_command, WS_TX_PRIORITY_REALTIME},
+    {"ping", handle_ping_command, WS_TX_PRIORITY_REALTIME},
+    {"stream", handle_stream_command, WS_TX_PRIORITY_REALTIME},
+    {"wol", handle_wol_command, WS_TX_PRIORITY_NORMAL},
+    {"wol_group", handle_wol_group_command, WS_TX_PRIORITY_NORMAL},
+    {"config", handle_config_message, WS_TX_PRIORITY_NORMAL},
+    {"timeline", handle_timeline_command, WS_TX_PRIORITY_NORMAL},
+    {"stats", handle_stats_command, WS_TX_PRIORITY_NORMAL},
+    {"batch", handle_batch_command, WS_TX_PRIORITY_NORMAL},
+};
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t failures;
+} ws_action_counter_t;
+
+static ws_action_counter_t ws_action_counters[ARRAY_SIZE(ws_actions)];
+static ws_name_index_t ws_action_index;
+static bool ws_tables_ready = false;
+
+static void build_name_index(ws_name_index_t *index, const ws_named_value_t *names, size_t count)
+{
+    ws_name_index_init(index);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!ws_name_index_add(index, names[i].name, names[i].value))
+        {
+            ESP_LOGE(TAG, "Failed to index name '%s'", names[i].name);
+        }
+    }
+}
+
+// Os índices são montados uma única vez, na primeira mensagem (task do WS).
+static void ensure_tables(void)
+{
+    if (ws_tables_ready)
     {
-        ws_protocol_send_error(client, NULL, "Invalid JSON payload");
         return;
     }
 
-    ESP_LOGI(TAG, "Command received: %s", json_buffer);
+    ws_name_index_init(&ws_action_index);
+    for (size_t i = 0; i < ARRAY_SIZE(ws_actions); i++)
+    {
+        if (!ws_name_index_add(&ws_action_index, ws_actions[i].name, (int)i))
+        {
+            ESP_LOGE(TAG, "Failed to register action '%s'", ws_actions[i].name);
+        }
+    }
+    build_name_index(&led_type_index, led_type_names, ARRAY_SIZE(led_type_names));
+    ws_name_index_init(&effect_index);
+    for (int i = 0; i < led_effect_count(); i++)
+    {
+        if (!ws_name_index_add(&effect_index, led_effect_from_id(i)->name, i))
+        {
+            ESP_LOGE(TAG, "Failed to index effect '%s'", led_effect_from_id(i)->name);
+        }
+    }
+    ws_tables_ready = true;
+}
+
+static bool handle_stats_command(const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
+    // Estático pelo mesmo motivo dos buffers do batch: só a task do WS
+    // despacha, e 1.5 KB pesam na pilha dela.
+    static char response[1536];
+    int len = snprintf(response, sizeof(response), "{\"status\":\"ok\",\"action\":\"stats\",\"actions\":{");
+    for (size_t i = 0; i < ARRAY_SIZE(ws_actions) && len < (int)sizeof(response); i++)
+    {
+        len += snprintf(response + len, sizeof(response) - len, "%s\"%s\":{\"count\":%u,\"failed\":%u}",
+                        (i == 0) ? "" : ",", ws_actions[i].name,
+                        (unsigned)ws_action_counters[i].count, (unsigned)ws_action_counters[i].failures);
+    }
+    ws_tx_stats_t tx;
+    ws_tx_queue_get_stats(&tx);
+    if (len < (int)sizeof(response))
+    {
+        len += snprintf(response + len, sizeof(response) - len,
+                        "},\"tx\":{\"queued\":%u,\"frames\":%u,\"coalesced\":%u,\"dropped\":%u,"
+                        "\"backpressure\":%u,\"sendFailures\":%u}",
+                        (unsigned)tx.queued, (unsigned)tx.frames, (unsigned)tx.coalesced, (unsigned)tx.dropped,
+                        (unsigned)tx.backpressure, (unsigned)tx.send_failures);
+    }
+
+    led_frame_stats_t strip;
+    led_controller_get_frame_stats(&strip);
+    led_stream_stats_t stream;
+    led_controller_get_stream_stats(&stream);
+    if (len < (int)sizeof(response))
+    {
+        len += snprintf(response + len, sizeof(response) - len,
+                        ",\"strip\":{\"transmitted\":%u,\"skipped\":%u,\"refreshUs\":%u,\"maxRefreshUs\":%u}",
+                        (unsigned)strip.transmitted, (unsigned)strip.skipped, (unsigned)strip.last_refresh_us,
+                        (unsigned)strip.max_refresh_us);
+    }
+    if (len < (int)sizeof(response))
+    {
+        len += snprintf(response + len, sizeof(response) - len,
+                        ",\"stream\":{\"frames\":%u,\"stale\":%u,\"overrun\":%u,"
+                        "\"latencyUs\":%u,\"avgLatencyUs\":%u,\"maxLatencyUs\":%u}",
+                        (unsigned)stream.frames_rendered, (unsigned)stream.frames_stale, (unsigned)stream.frames_overrun,
+                        (unsigned)stream.last_latency_us, (unsigned)stream.avg_latency_us, (unsigned)stream.max_latency_us);
+    }
+
+    led_scheduler_stats_t sched;
+    led_controller_get_scheduler_stats(&sched);
+    if (len < (int)sizeof(response))
+    {
+        len += snprintf(response + len, sizeof(response) - len,
+                        ",\"scheduler\":{\"frames\":%u,\"missed\":%u,"
+                        "\"jitterUs\":%u,\"avgJitterUs\":%u,\"maxJitterUs\":%u}",
+                        (unsigned)sched.frames, (unsigned)sched.missed_deadlines,
+                        (unsigned)sched.last_jitter_us, (unsigned)sched.avg_jitter_us, (unsigned)sched.max_jitter_us);
+    }
+
+    led_mailbox_stats_t mailbox;
+    led_controller_get_mailbox_stats(&mailbox);
+    if (len < (int)sizeof(response))
+    {
+        len += snprintf(response + len, sizeof(response) - len,
+                        ",\"mailbox\":{\"posted\":%u,\"superseded\":%u}",
+                        (unsigned)mailbox.posted, (unsigned)mailbox.superseded);
+    }
+
+    led_power_stats_t power;
+    led_controller_get_power_stats(&power);
+    if (len < (int)sizeof(response))
+    {
+        len += snprintf(response + len, sizeof(response) - len,
+                        ",\"power\":{\"mA\":%u,\"requestedMa\":%u,\"peakMa\":%u,\"limitedFrames\":%u}",
+                        (unsigned)power.estimated_ma, (unsigned)power.requested_ma, (unsigned)power.peak_ma,
+                        (unsigned)power.limited_frames);
+    }
+
+    wol_sender_stats_t wol;
+    wol_sender_get_stats(&wol);
+    if (len < (int)sizeof(response))
+    {
+        len += snprintf(response + len, sizeof(response) - len,
+                        ",\"wol\":{\"targets\":%u,\"packets\":%u,\"failed\":%u,\"dropped\":%u}",
+                        (unsigned)wol.targets, (unsigned)wol.packets, (unsigned)wol.failures,
+                        (unsigned)wol.dropped);
+    }
+
+    wol_verify_stats_t verify;
+    wol_verify_get_stats(&verify);
+    if (len < (int)sizeof(response))
+    {
+        len += snprintf(response + len, sizeof(response) - len,
+                        ",\"verify\":{\"started\":%u,\"alive\":%u,\"timeouts\":%u,\"errors\":%u,\"rejected\":%u,"
+                        "\"lastAliveMs\":%u,\"maxAliveMs\":%u}",
+                        (unsigned)verify.started, (unsigned)verify.alive, (unsigned)verify.timeouts,
+                        (unsigned)verify.errors, (unsigned)verify.rejected, (unsigned)verify.last_alive_ms,
+                        (unsigned)verify.max_alive_ms);
+    }
+
+    ws_command_auth_stats_t auth;
+    ws_command_auth_get_stats(&auth);
+    if (len < (int)sizeof(response))
+    {
+        len += snprintf(response + len, sizeof(response) - len,
+                        ",\"auth\":{\"signed\":%s,\"verified\":%u,\"rejected\":%u,\"replays\":%u,\"lastSeq\":%u}",
+                        auth.enabled ? "true" : "false", (unsigned)auth.verified, (unsigned)auth.rejected,
+                        (unsigned)auth.replays, (unsigned)auth.last_seq);
+    }
+
+    net_time_stats_t clock;
+    net_time_get_stats(&clock);
+    if (len < (int)sizeof(response))
+    {
+        snprintf(response + len, sizeof(response) - len,
+                 ",\"time\":{\"synced\":%s,\"syncs\":%u,\"correctionUs\":%ld,\"maxCorrectionUs\":%u,"
+                 "\"driftPpb\":%ld,\"sinceSyncS\":%u,\"errorUs\":%u}}",
+                 clock.synced ? "true" : "false", (unsigned)clock.syncs, (long)clock.last_correction_us,
+                 (unsigned)clock.max_correction_us, (long)clock.drift_ppb, (unsigned)clock.since_sync_s,
+                 (unsigned)clock.estimated_error_us);
+    }
+    reply_json(client, response);
+    return true;
+}
+
+int ws_protocol_get_action_stats(ws_action_stats_t *stats, int max_stats)
+{
+    int count = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(ws_actions) && count < max_stats; i++, count++)
+    {
+        stats[count].name = ws_actions[i].name;
+        stats[count].count = ws_action_counters[i].count;
+        stats[count].failures = ws_action_counters[i].failures;
+    }
+    return count;
+}
+
+static bool dispatch_action(int index, const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
+    ws_action_counters[index].count++;
+    ws_reply_priority = ws_actions[index].priority;
+    if (!ws_actions[index].handler(cmd, client))
+    {
+        ws_action_counters[index].failures++;
+        return false;
+    }
+    return true;
+}
+
+// Roda um sub-comando do batch. As respostas estão sendo capturadas, então
+// cada item contribui com o seu próprio ack (ou erro) para "results".
+static bool run_batch_item(ws_command_iter_result_t result, const ws_command_t *item,
+                           esp_websocket_client_handle_t client)
+{
+    if (result == WS_COMMAND_ITER_INVALID)
+    {
+        ws_protocol_send_error(client, NULL, "Invalid command");
+        return false;
+    }
+
+    if (!ws_field_is_string(&item->action))
+    {
+        ws_protocol_send_error(client, NULL, "Missing action");
+        return false;
+    }
+
+    int index = ws_name_index_find(&ws_action_index, item->action.str, item->action.len);
+    if (index < 0 || ws_actions[index].handler == handle_batch_command)
+    {
+        char action_name[64];
+        snprintf(action_name, sizeof(action_name), "%.*s", item->action.len, item->action.str);
+        ws_protocol_send_error(client, action_name, "Unsupported action");
+        return false;
+    }
+
+    return dispatch_action(index, item, client);
+}
+
+static bool handle_batch_command(const ws_command_t *cmd, esp_websocket_client_handle_t client)
+{
+    ws_command_iter_t iter;
+    if (cmd->encoding != WS_ENCODING_JSON || !ws_command_iter_init(&iter, cmd))
+    {
+        reply_error(cmd, client, "batch", WS_STATUS_INVALID_PAYLOAD, "Invalid or missing commands");
+        return false;
+    }
+
+    // Estáticos: o dispatch roda sempre na task do WS e os buffers não cabem
+    // com folga na pilha dela.
+    static char results[WS_BATCH_RESULTS_SIZE];
+    static char response[WS_BATCH_RESULTS_SIZE + 128];
+
+    int count = 0;
+    int failed = 0;
+    ws_protocol_capture_begin(results, sizeof(results));
+    led_controller_batch_begin();
+
+    // Também estático: o batch não aninha (run_batch_item recusa), então há
+    // no máximo um item vivo, e config/timeline empilham sobre ele.
+    static ws_command_t item;
+    cJSON *item_root = NULL;
+    ws_command_iter_result_t result;
+    while (count < WS_BATCH_MAX_COMMANDS &&
+           (result = ws_command_iter_next(&iter, &item, &item_root)) != WS_COMMAND_ITER_END)
+    {
+        if (!run_batch_item(result, &item, client))
+        {
+            failed++;
+        }
+        cJSON_Delete(item_root);
+        count++;
+    }
+
+    bool leds_applied = led_controller_batch_commit();
+    bool truncated = false;
+    int results_len = ws_protocol_capture_end(&truncated);
+    ws_reply_priority = WS_TX_PRIORITY_NORMAL; // os itens trocaram a prioridade
+
+    // Itens além do limite não rodam; o servidor vê isso por count.
+    bool more = (ws_command_iter_next(&iter, &item, &item_root) != WS_COMMAND_ITER_END);
+    cJSON_Delete(item_root);
+
+    bool ok = failed == 0 && leds_applied && !more;
+    int len = snprintf(response, sizeof(response),
+                       "{\"status\":\"%s\",\"action\":\"batch\",\"count\":%d,\"failed\":%d,",
+                       ok ? "ok" : "error", count, failed);
+    if (!leds_applied)
+    {
+        len += snprintf(response + len, sizeof(response) - len, "\"error\":\"led_unavailable\",");
+    }
+    else if (more)
+    {
+        len += snprintf(response + len, sizeof(response) - len, "\"error\":\"too_many_commands\",");
+    }
+    if (truncated)
+    {
+        len += snprintf(response + len, sizeof(response) - len, "\"truncated\":true,");
+    }
+    snprintf(response + len, sizeof(response) - len, "\"results\":[%.*s]}", results_len, results);
+
+    reply_json(client, response);
+    return ok;
+}
 
-    cJSON *root = cJSON_Parse(json_buffer);
-    if (!root)
+void ws_protocol_handle_complete_text(esp_websocket_client_handle_t client, const char *payload, int payload_len)
+{
+    if (!payload || payload_len <= 0)
     {
-        ESP_LOGE(TAG, "Invalid JSON payload");
         ws_protocol_send_error(client, NULL, "Invalid JSON payload");
         return;
     }
 
-    cJSON *action_json = cJSON_GetObjectItemCaseSensitive(root, "action");
-    if (!cJSON_IsString(action_json) || action_json->valuestring == NULL)
+    ensure_tables();
+
+    const char *json_buffer = payload;
+    size_t json_len = (size_t)payload_len;
+
+    // Com comandos assinados, nada é interpretado antes do MAC conferir.
+    if (ws_command_auth_enabled())
+    {
+        ws_auth_result_t auth = ws_command_auth_check_text(json_buffer, json_len);
+        if (auth != WS_AUTH_OK)
+        {
+            ESP_LOGW(TAG, "Rejected unsigned or invalid command (result=%d len=%d)", auth, payload_len);
+            ws_protocol_send_error(client, NULL, auth == WS_AUTH_REPLAY ? "Replayed command" : "Invalid signature");
+            return;
+        }
+    }
+
+    // Caminho rápido sem alocação; o cJSON só entra para formatos que o
+    // tokenizer não cobre (escapes, raiz não-objeto) ou para rejeitar JSON inválido.
+    ws_command_t cmd;
+    cJSON *root = NULL;
+    if (!ws_command_parse(json_buffer, json_len, &cmd))
+    {
+        root = cJSON_ParseWithLength(json_buffer, json_len);
+        if (!root)
+        {
+            ESP_LOGE(TAG, "Invalid JSON payload: %.*s", (int)json_len, json_buffer);
+            ws_protocol_send_error(client, NULL, "Invalid JSON payload");
+            return;
+        }
+        ws_command_from_cjson(root, &cmd);
+    }
+
+    if (!ws_field_is_string(&cmd.action))
     {
-        cJSON *error_json = cJSON_GetObjectItemCaseSensitive(root, "error");
-        if (cJSON_IsString(error_json) && error_json->valuestring && strcmp(error_json->valuestring, "config_incomplete") == 0)
+        ESP_LOGI(TAG, "Command received: %.*s", (int)json_len, json_buffer);
+        if (ws_field_equals(&cmd.error, "config_incomplete"))
         {
             ESP_LOGW(TAG, "Received config_incomplete without action; forcing reconnect");
             ws_protocol_request_force_reconnect();
@@ -326,31 +1717,59 @@ void ws_protocol_handle_complete_text(esp_websocket_client_handle_t client, cons
         return;
     }
 
-    const char *action = action_json->valuestring;
-    if (strcmp(action, "wol") == 0)
+    int index = ws_name_index_find(&ws_action_index, cmd.action.str, cmd.action.len);
+    if (index < 0)
     {
-        handle_wol_command(root, client);
+        ESP_LOGI(TAG, "Command received: %.*s", (int)json_len, json_buffer);
+        char action_name[64];
+        snprintf(action_name, sizeof(action_name), "%.*s", cmd.action.len, cmd.action.str);
+        ws_protocol_send_error(client, action_name, "Unsupported action");
+        cJSON_Delete(root);
+        return;
     }
-    else if (strcmp(action, "led") == 0)
+
+    if (ws_actions[index].priority == WS_TX_PRIORITY_REALTIME)
     {
-        handle_led_command(root, client);
+        ESP_LOGD(TAG, "Command received: %.*s", (int)json_len, json_buffer);
     }
-    else if (strcmp(action, "effect") == 0)
+    else
     {
-        handle_effect_command(root, client);
+        ESP_LOGI(TAG, "Command received: %.*s", (int)json_len, json_buffer);
     }
-    else if (strcmp(action, "ping") == 0)
+
+    dispatch_action(index, &cmd, client);
+    cJSON_Delete(root);
+}
+
+void ws_protocol_handle_complete_binary(esp_websocket_client_handle_t client, const uint8_t *payload, int payload_len)
+{
+    ensure_tables();
+
+    size_t frame_len = payload_len > 0 ? (size_t)payload_len : 0;
+    if (ws_command_auth_enabled() && ws_command_auth_check_binary(payload, frame_len, &frame_len) != WS_AUTH_OK)
     {
-        ws_protocol_send_json(client, "{\"status\":\"ok\",\"action\":\"pong\"}");
+        ESP_LOGW(TAG, "Rejected unsigned or invalid binary command (len=%d)", payload_len);
+        uint8_t action = payload_len >= WS_BINARY_HEADER_LEN ? payload[1] : 0;
+        ws_protocol_send_binary_ack(client, action, WS_STATUS_UNAUTHORIZED, NULL, 0, WS_TX_PRIORITY_NORMAL);
+        return;
     }
-    else if (strcmp(action, "config") == 0)
+
+    ws_command_t cmd;
+    ws_status_t status = ws_command_parse_binary(payload, frame_len, &cmd);
+    if (status != WS_STATUS_OK)
     {
-        handle_config_message(root, client);
+        ESP_LOGW(TAG, "Invalid binary command (len=%d action=0x%02x status=%d)", payload_len, cmd.binary_action, status);
+        ws_protocol_send_binary_ack(client, cmd.binary_action, status, NULL, 0, WS_TX_PRIORITY_NORMAL);
+        return;
     }
-    else
+
+    int index = ws_name_index_find(&ws_action_index, cmd.action.str, cmd.action.len);
+    if (index < 0)
     {
-        ws_protocol_send_error(client, action, "Unsupported action");
+        ws_protocol_send_binary_ack(client, cmd.binary_action, WS_STATUS_UNSUPPORTED, NULL, 0, WS_TX_PRIORITY_NORMAL);
+        return;
     }
 
-    cJSON_Delete(root);
+    ESP_LOGD(TAG, "Binary command received: action=0x%02x len=%d", cmd.binary_action, payload_len);
+    dispatch_action(index, &cmd, client);
 }
@@ -5,12 +5,23 @@
 #include <stdint.h>
 
 #include "esp_websocket_client.h"
-#include "cJSON.h"
+#include "ws_command.h"
+#include "ws_tx_queue.h"
 
+// Enfileira com prioridade NORMAL.
 void ws_protocol_send_json(esp_websocket_client_handle_t client, const char *payload);
+void ws_protocol_send_json_priority(esp_websocket_client_handle_t client, const char *payload, ws_tx_priority_t priority);
+void ws_protocol_send_binary(esp_websocket_client_handle_t client, const uint8_t *data, int len, ws_tx_priority_t priority);
+// Ack binário: [versão][ação | WS_BINARY_ACK_FLAG][status][payload (até 8 bytes)]
+void ws_protocol_send_binary_ack(esp_websocket_client_handle_t client, uint8_t action, ws_status_t status,
+                                 const uint8_t *payload, int payload_len, ws_tx_priority_t priority);
 void ws_protocol_send_error(esp_websocket_client_handle_t client, const char *action, const char *message);
+// Entre begin e end, as respostas JSON são anexadas a buffer (separadas por
+// vírgula) em vez de enviadas. end devolve o tamanho capturado; truncated indica
+// respostas descartadas por falta de espaço.
+void ws_protocol_capture_begin(char *buffer, int capacity);
+int ws_protocol_capture_end(bool *truncated);
 void ws_protocol_send_led_invalid_rgb(esp_websocket_client_handle_t client);
-bool ws_protocol_cjson_to_u8(const cJSON *item, uint8_t *value);
 
 void ws_protocol_request_force_reconnect(void);
 bool ws_protocol_is_force_reconnect(void);
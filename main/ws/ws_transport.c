@@ -12,12 +12,35 @@
 #include "ws_protocol.h"
 #include "ws_frame_reassembly.h"
 #include "ws_transport.h"
+#include "ws_tx_queue.h"
 
 static const char *TAG = "ESP_WOL_WS";
 
+// Tamanho máximo de uma mensagem fragmentada. Pode ser sobrescrito no config.h.
+#ifndef WS_RX_ARENA_SIZE
+#define WS_RX_ARENA_SIZE 4096
+#endif
+
+#define WS_OPCODE_TEXT 0x01
+#define WS_OPCODE_BINARY 0x02
+
+static char ws_rx_arena[WS_RX_ARENA_SIZE];
 static ws_frame_reassembly_t ws_rx;
+static int ws_rx_opcode = WS_OPCODE_TEXT;
 static char ws_device_mac[18] = "00:00:00:00:00:00";
 
+static void dispatch_complete_message(esp_websocket_client_handle_t client, int op_code, const char *data, int len)
+{
+    if (op_code == WS_OPCODE_BINARY)
+    {
+        ws_protocol_handle_complete_binary(client, (const uint8_t *)data, len);
+    }
+    else
+    {
+        ws_protocol_handle_complete_text(client, data, len);
+    }
+}
+
 static void websocket_event_handler(void *handler_args, esp_event_base_t base,
                                     int32_t event_id, void *event_data)
 {
@@ -29,16 +52,20 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base,
     case WEBSOCKET_EVENT_CONNECTED:
         ESP_LOGI(TAG, "WebSocket Connected!");
         ws_frame_reassembly_reset(&ws_rx);
+        // Acks da conexão anterior não fazem sentido para o novo servidor e
+        // não podem passar na frente da autenticação.
+        ws_tx_queue_flush();
         ws_protocol_on_connected(client, ws_device_mac);
         break;
 
     case WEBSOCKET_EVENT_DISCONNECTED:
         ESP_LOGW(TAG, "WebSocket Disconnected");
         ws_frame_reassembly_reset(&ws_rx);
+        ws_tx_queue_flush();
         break;
 
     case WEBSOCKET_EVENT_DATA:
-        if (data->op_code != 0x01)
+        if (data->op_code != WS_OPCODE_TEXT && data->op_code != WS_OPCODE_BINARY)
         {
             break;
         }
@@ -49,13 +76,23 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base,
             break;
         }
 
+        // Mensagem inteira num único evento (o caso comum): parse direto do
+        // buffer do cliente, sem cópia.
+        if (data->payload_offset == 0 && data->data_len == data->payload_len)
+        {
+            ws_frame_reassembly_reset(&ws_rx);
+            dispatch_complete_message(client, data->op_code, data->data_ptr, data->data_len);
+            break;
+        }
+
         if (data->payload_offset == 0)
         {
             if (!ws_frame_reassembly_begin(&ws_rx, data->payload_len))
             {
-                ESP_LOGE(TAG, "Out of memory while reassembling payload");
+                ESP_LOGE(TAG, "Payload too large to reassemble (%d > %d bytes)", data->payload_len, WS_RX_ARENA_SIZE);
                 break;
             }
+            ws_rx_opcode = data->op_code;
         }
 
         if (!ws_frame_reassembly_append(&ws_rx, data->payload_offset, data->data_ptr, data->data_len, data->payload_len))
@@ -68,7 +105,7 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base,
 
         if (ws_frame_reassembly_is_complete(&ws_rx))
         {
-            ws_protocol_handle_complete_text(client, ws_frame_reassembly_data(&ws_rx));
+            dispatch_complete_message(client, ws_rx_opcode, ws_frame_reassembly_data(&ws_rx), ws_frame_reassembly_length(&ws_rx));
             ws_frame_reassembly_reset(&ws_rx);
         }
         break;
@@ -85,12 +122,17 @@ static void websocket_task(void *arg)
     esp_websocket_client_config_t ws_cfg = {
         .uri = WS_URI,
         .disable_auto_reconnect = true,
+        // Os handlers rodam na task do cliente (WEBSOCKET_EVENT_DATA); o
+        // padrão de 4 KB não cobre eles mais o cliente. A profundidade de
+        // cada ação é conferida pelo wol_bench (seção de pilha).
+        .task_stack = 8192,
         // ponytail: bundle de CAs do IDF; ignorado quando a URI e ws://
         .crt_bundle_attach = esp_crt_bundle_attach,
     };
 
     esp_websocket_client_handle_t client = esp_websocket_client_init(&ws_cfg);
     esp_websocket_register_events(client, WEBSOCKET_EVENT_ANY, websocket_event_handler, client);
+    ws_tx_queue_start(client);
 
     const int min_backoff_ms = 2000;
     const int max_backoff_ms = 30000;
@@ -143,7 +185,7 @@ static void websocket_task(void *arg)
 
 void ws_transport_start(const char *device_mac)
 {
-    ws_frame_reassembly_init(&ws_rx);
+    ws_frame_reassembly_init(&ws_rx, ws_rx_arena, sizeof(ws_rx_arena));
 
     if (device_mac)
     {
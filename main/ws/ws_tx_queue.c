@@ -0,0 +1,276 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/ringbuf.h"
+
+#include "esp_log.h"
+
+#include "ws_tx_queue.h"
+
+static const char *TAG = "ESP_WOL_WSTX";
+
+#define WS_TX_RING_SIZE 4096
+#define WS_TX_FRAME_MAX 2048
+#define WS_TX_SEND_TIMEOUT_MS 2000
+#define WS_TX_ENQUEUE_WAIT_MS 50
+
+#define WS_TX_ITEM_HEADER 3
+
+// Item na ring buffer: [opcode][prioridade][geração][dados]. A geração (byte
+// baixo de ws_tx_generation ao enfileirar) marca a conexão do item: o flush a
+// incrementa e a task de envio descarta o que for de outra geração, inclusive
+// o item guardado em ws_tx_carry. O frame reserva 1 byte antes do corpo para o
+// '[' do array JSON quando mensagens de texto são agregadas.
+static RingbufHandle_t ws_tx_ring = NULL;
+static esp_websocket_client_handle_t ws_tx_client = NULL;
+static char ws_tx_frame[WS_TX_FRAME_MAX + 2];
+// Conteúdo do carry só é lido e escrito pela task de envio; o tamanho, a
+// geração e as estatísticas ficam sob ws_tx_lock, porque o flush (task do WS)
+// e o enqueue (qualquer task) também mexem neles.
+static uint8_t ws_tx_carry[WS_TX_FRAME_MAX + WS_TX_ITEM_HEADER];
+static int ws_tx_carry_len = 0;
+static uint32_t ws_tx_generation = 0;
+static ws_tx_stats_t ws_tx_stats;
+static portMUX_TYPE ws_tx_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void stats_add(uint32_t *counter, uint32_t count)
+{
+    taskENTER_CRITICAL(&ws_tx_lock);
+    *counter += count;
+    taskEXIT_CRITICAL(&ws_tx_lock);
+}
+
+static uint8_t current_generation(void)
+{
+    taskENTER_CRITICAL(&ws_tx_lock);
+    uint8_t generation = (uint8_t)ws_tx_generation;
+    taskEXIT_CRITICAL(&ws_tx_lock);
+    return generation;
+}
+
+static void ws_tx_task(void *arg)
+{
+    while (1)
+    {
+        ws_tx_queue_drain(portMAX_DELAY);
+    }
+}
+
+bool ws_tx_queue_start(esp_websocket_client_handle_t client)
+{
+    ws_tx_client = client;
+    if (ws_tx_ring != NULL)
+    {
+        return true;
+    }
+
+    ws_tx_ring = xRingbufferCreate(WS_TX_RING_SIZE, RINGBUF_TYPE_NOSPLIT);
+    if (ws_tx_ring == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to create TX ring buffer");
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(ws_tx_task, "ws_tx", 4096, NULL, 5, NULL, 1) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create TX task");
+        return false;
+    }
+    return true;
+}
+
+bool ws_tx_queue_enqueue(uint8_t opcode, const void *data, int len, ws_tx_priority_t priority)
+{
+    if (!ws_tx_ring || !data || len <= 0)
+    {
+        return false;
+    }
+
+    if (len > WS_TX_FRAME_MAX)
+    {
+        ESP_LOGW(TAG, "Dropping oversized message (%d bytes)", len);
+        stats_add(&ws_tx_stats.dropped, 1);
+        return false;
+    }
+
+    void *slot = NULL;
+    size_t item_size = (size_t)len + WS_TX_ITEM_HEADER;
+    if (xRingbufferSendAcquire(ws_tx_ring, &slot, item_size, 0) != pdTRUE)
+    {
+        stats_add(&ws_tx_stats.backpressure, 1);
+        TickType_t wait = (priority == WS_TX_PRIORITY_REALTIME) ? 0 : pdMS_TO_TICKS(WS_TX_ENQUEUE_WAIT_MS);
+        if (wait == 0 || xRingbufferSendAcquire(ws_tx_ring, &slot, item_size, wait) != pdTRUE)
+        {
+            stats_add(&ws_tx_stats.dropped, 1);
+            return false;
+        }
+    }
+
+    uint8_t *item = (uint8_t *)slot;
+    item[0] = opcode;
+    item[1] = (uint8_t)priority;
+    item[2] = current_generation();
+    memcpy(item + WS_TX_ITEM_HEADER, data, len);
+    xRingbufferSendComplete(ws_tx_ring, slot);
+    stats_add(&ws_tx_stats.queued, 1);
+    return true;
+}
+
+void ws_tx_queue_flush(void)
+{
+    if (!ws_tx_ring)
+    {
+        return;
+    }
+
+    // Itens que a task de envio já tirou da fila (ou guardou no carry) ficam
+    // com a geração antiga e são descartados por ela.
+    taskENTER_CRITICAL(&ws_tx_lock);
+    ws_tx_generation++;
+    ws_tx_carry_len = 0;
+    taskEXIT_CRITICAL(&ws_tx_lock);
+
+    size_t size = 0;
+    void *item;
+    while ((item = xRingbufferReceive(ws_tx_ring, &size, 0)) != NULL)
+    {
+        vRingbufferReturnItem(ws_tx_ring, item);
+    }
+}
+
+// Guarda o item que não coube no frame atual para o próximo. Um flush desde
+// que o item foi enfileirado o torna obsoleto: descartado em vez de guardado.
+static void carry_store(const uint8_t *item, size_t size)
+{
+    memcpy(ws_tx_carry, item, size);
+    taskENTER_CRITICAL(&ws_tx_lock);
+    if (item[2] == (uint8_t)ws_tx_generation)
+    {
+        ws_tx_carry_len = (int)size;
+    }
+    else
+    {
+        ws_tx_stats.dropped++;
+    }
+    taskEXIT_CRITICAL(&ws_tx_lock);
+}
+
+// Próximo item: primeiro o que sobrou do frame anterior, depois a ring buffer.
+static int next_item(uint8_t *out, TickType_t wait)
+{
+    taskENTER_CRITICAL(&ws_tx_lock);
+    int len = ws_tx_carry_len;
+    ws_tx_carry_len = 0;
+    taskEXIT_CRITICAL(&ws_tx_lock);
+    if (len > 0)
+    {
+        memcpy(out, ws_tx_carry, len);
+        return len;
+    }
+
+    size_t size = 0;
+    uint8_t *item = (uint8_t *)xRingbufferReceive(ws_tx_ring, &size, wait);
+    if (!item)
+    {
+        return 0;
+    }
+
+    memcpy(out, item, size);
+    vRingbufferReturnItem(ws_tx_ring, item);
+    return (int)size;
+}
+
+bool ws_tx_queue_drain(TickType_t wait)
+{
+    if (!ws_tx_ring)
+    {
+        return false;
+    }
+
+    static uint8_t item[WS_TX_FRAME_MAX + WS_TX_ITEM_HEADER];
+    int item_len = next_item(item, wait);
+    if (item_len <= WS_TX_ITEM_HEADER)
+    {
+        return false;
+    }
+
+    uint8_t generation = item[2];
+    uint8_t opcode = item[0];
+    bool coalesce = item[1] != WS_TX_PRIORITY_CONTROL;
+    char *body = ws_tx_frame + 1;
+    int body_len = item_len - WS_TX_ITEM_HEADER;
+    int count = 1;
+    memcpy(body, item + WS_TX_ITEM_HEADER, body_len);
+
+    // Agrega os acks que já estiverem esperando (só acontece quando o envio
+    // anterior demorou o bastante para acumular mensagens).
+    size_t size = 0;
+    uint8_t *next;
+    while (coalesce && (next = (uint8_t *)xRingbufferReceive(ws_tx_ring, &size, 0)) != NULL)
+    {
+        int data_len = (int)size - WS_TX_ITEM_HEADER;
+        int extra = (opcode == WS_TX_OPCODE_TEXT) ? data_len + 1 : data_len; // + ','
+        if (next[0] != opcode || next[1] == WS_TX_PRIORITY_CONTROL || next[2] != generation ||
+            body_len + extra > WS_TX_FRAME_MAX - 1)
+        {
+            carry_store(next, size);
+            vRingbufferReturnItem(ws_tx_ring, next);
+            break;
+        }
+
+        if (opcode == WS_TX_OPCODE_TEXT)
+        {
+            body[body_len++] = ',';
+        }
+        memcpy(body + body_len, next + WS_TX_ITEM_HEADER, data_len);
+        body_len += data_len;
+        count++;
+        vRingbufferReturnItem(ws_tx_ring, next);
+    }
+
+    const char *frame = body;
+    int frame_len = body_len;
+    if (opcode == WS_TX_OPCODE_TEXT && count > 1)
+    {
+        ws_tx_frame[0] = '[';
+        body[body_len] = ']';
+        frame = ws_tx_frame;
+        frame_len = body_len + 2;
+    }
+
+    if (count > 1)
+    {
+        stats_add(&ws_tx_stats.coalesced, (uint32_t)count);
+    }
+
+    // Frame de uma conexão anterior (flush depois de enfileirado): não envia.
+    if (generation != current_generation() || !ws_tx_client || !esp_websocket_client_is_connected(ws_tx_client))
+    {
+        stats_add(&ws_tx_stats.dropped, (uint32_t)count);
+        return true;
+    }
+
+    int sent = (opcode == WS_TX_OPCODE_TEXT)
+                   ? esp_websocket_client_send_text(ws_tx_client, frame, frame_len, pdMS_TO_TICKS(WS_TX_SEND_TIMEOUT_MS))
+                   : esp_websocket_client_send_bin(ws_tx_client, frame, frame_len, pdMS_TO_TICKS(WS_TX_SEND_TIMEOUT_MS));
+    if (sent < 0)
+    {
+        ESP_LOGW(TAG, "Send failed or timed out (%d bytes, %d messages)", frame_len, count);
+        stats_add(&ws_tx_stats.send_failures, 1);
+        return true;
+    }
+
+    stats_add(&ws_tx_stats.frames, 1);
+    return true;
+}
+
+void ws_tx_queue_get_stats(ws_tx_stats_t *stats)
+{
+    if (stats)
+    {
+        taskENTER_CRITICAL(&ws_tx_lock);
+        *stats = ws_tx_stats;
+        taskEXIT_CRITICAL(&ws_tx_lock);
+    }
+}
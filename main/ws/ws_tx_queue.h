@@ -0,0 +1,50 @@
+#ifndef WS_TX_QUEUE_H
+#define WS_TX_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_websocket_client.h"
+
+// Fila de saída do WebSocket. Quem responde só enfileira; uma task própria
+// drena a fila com timeout de envio limitado, então um write TLS lento (ou um
+// link morto) não trava mais o recebimento. Quando vários frames do mesmo tipo
+// se acumulam, os acks saem agregados num único frame: textos viram um array
+// JSON e acks binários são concatenados. Mensagens de controle (auth,
+// get_config) sempre saem sozinhas.
+
+#define WS_TX_OPCODE_TEXT 0x01
+#define WS_TX_OPCODE_BINARY 0x02
+
+typedef enum
+{
+    // Acks de controle e erros: esperam um pouco por espaço na fila.
+    WS_TX_PRIORITY_NORMAL = 0,
+    // Acks de tráfego de alta frequência: descartados se a fila estiver cheia.
+    WS_TX_PRIORITY_REALTIME,
+    // Handshake com o servidor: espera por espaço e nunca é agregado.
+    WS_TX_PRIORITY_CONTROL,
+} ws_tx_priority_t;
+
+typedef struct
+{
+    uint32_t queued;        // mensagens aceitas na fila
+    uint32_t frames;        // frames efetivamente enviados
+    uint32_t coalesced;     // mensagens que saíram agregadas a outras
+    uint32_t dropped;       // mensagens descartadas (fila cheia, grandes demais ou de antes de um flush)
+    uint32_t backpressure;  // tentativas de enfileirar com a fila cheia
+    uint32_t send_failures; // frames que falharam/expiraram no envio
+} ws_tx_stats_t;
+
+bool ws_tx_queue_start(esp_websocket_client_handle_t client);
+bool ws_tx_queue_enqueue(uint8_t opcode, const void *data, int len, ws_tx_priority_t priority);
+// Descarta tudo que está pendente (ex.: ao reconectar, antes da autenticação),
+// inclusive o que a task de envio já tirou da fila mas ainda não enviou.
+void ws_tx_queue_flush(void);
+// Envia um frame (agregando o que já estiver na fila). Usado pela task de envio;
+// exposto para o build de host drenar a fila de forma síncrona.
+bool ws_tx_queue_drain(TickType_t wait);
+void ws_tx_queue_get_stats(ws_tx_stats_t *stats);
+
+#endif
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Gera main/led/led_tables.c: tabelas de consulta dos efeitos de LED.
+
+    python3 tools/gen_led_tables.py
+
+As tabelas ficam versionadas; rode de novo só se mudar algum parâmetro aqui.
+"""
+
+import math
+import os
+
+GAMMA = 2.2
+DELINEAR_SHIFT = 6
+
+
+def sine_u8():
+    # Seno em 0..255 (meio = 127.5), 256 amostras por ciclo.
+    return [int(round((math.sin(2 * math.pi * i / 256) + 1) / 2 * 255)) for i in range(256)]
+
+
+def hsv_to_rgb(h, s, v):
+    # Mesma aritmética inteira de 6 setores usada antes no firmware.
+    region = h // 43
+    rem = ((h - region * 43) * 6) & 0xFF
+    p = (v * (255 - s)) // 255
+    q = (v * (255 - (s * rem) // 255)) // 255
+    t = (v * (255 - (s * (255 - rem)) // 255)) // 255
+    return [
+        (v, t, p),
+        (q, v, p),
+        (p, v, t),
+        (p, q, v),
+        (t, p, v),
+        (v, p, q),
+    ][min(region, 5)]
+
+
+def gamma_u8():
+    return [int(round(((i / 255) ** GAMMA) * 255)) for i in range(256)]
+
+
+def linear_u16():
+    # Valor do canal -> luz linear em 0..65535 (mesma curva de gama), forçada a
+    # ser estritamente crescente para que a volta seja única no começo da curva.
+    table = []
+    for i in range(256):
+        v = int(round(((i / 255) ** GAMMA) * 65535))
+        table.append(max(v, table[-1] + 1) if table else v)
+    return table
+
+
+def delinear_u8(linear):
+    # Luz linear >> DELINEAR_SHIFT -> maior valor de canal cuja luz não passa
+    # disso. É só o ponto de partida: o firmware ajusta para o mais próximo.
+    table = []
+    v = 0
+    for i in range(65536 >> DELINEAR_SHIFT):
+        x = i << DELINEAR_SHIFT
+        while v < 255 and linear[v + 1] <= x:
+            v += 1
+        table.append(v)
+    return table
+
+
+def spi_pattern():
+    # Cada bit da fita vira 3 bits SPI (MSB primeiro): 1 -> 110, 0 -> 100.
+    table = []
+    for byte in range(256):
+        bits = 0
+        for i in range(7, -1, -1):
+            bits = (bits << 3) | (0b110 if (byte >> i) & 1 else 0b100)
+        table.append((bits >> 16, (bits >> 8) & 0xFF, bits & 0xFF))
+    return table
+
+
+def format_rows(values, per_row=16):
+    rows = []
+    for i in range(0, len(values), per_row):
+        rows.append("    " + ", ".join(str(v) for v in values[i:i + per_row]) + ",")
+    return "\n".join(rows)
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    path = os.path.join(root, "main", "led", "led_tables.c")
+
+    rainbow = [hsv_to_rgb(h, 255, 255) for h in range(256)]
+    rainbow_rows = "\n".join(
+        "    " + " ".join("{%d, %d, %d}," % rgb for rgb in rainbow[i:i + 8])
+        for i in range(0, len(rainbow), 8)
+    )
+
+    with open(path, "w", encoding="utf-8") as out:
+        out.write("// Gerado por tools/gen_led_tables.py; não editar à mão.\n\n")
+        out.write('#include "led_tables.h"\n\n')
+        out.write("const uint8_t led_sine_table[256] = {\n%s\n};\n\n" % format_rows(sine_u8()))
+        out.write("const led_rgb_t led_rainbow_table[256] = {\n%s\n};\n\n" % rainbow_rows)
+        out.write("// gamma %.1f\n" % GAMMA)
+        out.write("const uint8_t led_gamma_table[256] = {\n%s\n};\n\n" % format_rows(gamma_u8()))
+        linear = linear_u16()
+        out.write("const uint16_t led_linear_table[256] = {\n%s\n};\n\n" % format_rows(linear))
+        out.write("const uint8_t led_delinear_table[%d] = {\n%s\n};\n\n"
+                  % (65536 >> DELINEAR_SHIFT, format_rows(delinear_u8(linear), 32)))
+        spi = spi_pattern()
+        spi_rows = "\n".join(
+            "    " + " ".join("{0x%02X, 0x%02X, 0x%02X}," % p for p in spi[i:i + 6])
+            for i in range(0, len(spi), 6)
+        )
+        out.write("const uint8_t led_spi_pattern_table[256][3] = {\n%s\n};\n" % spi_rows)
+
+
+if __name__ == "__main__":
+    main()